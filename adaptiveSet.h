@@ -0,0 +1,348 @@
+/***********************************************************************
+ * Header:
+ *    ADAPTIVE SET
+ * Summary:
+ *    A set that picks its own layout. While it is small the elements
+ *    sit in one sorted array: no nodes, and a lookup is a binary search
+ *    through a cache line or two. Past a threshold it moves them into
+ *    an unordered_set, and when erases bring it down to half the
+ *    threshold it moves them back. The gap between the two keeps a set
+ *    that hovers around the threshold from moving on every call
+ *
+ *    This will contain the class definition of:
+ *        adaptive_set           : A sorted array or a hash, as suits
+ *        adaptive_set::iterator : An iterator through either
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"        // for the unordered_set a large set becomes
+#include "pair.h"        // because insert() returns a pair
+#include <algorithm>     // for std::lower_bound and std::sort
+#include <functional>    // for std::less
+#include <iterator>      // for std::iterator_traits
+#include <utility>       // for std::swap
+#include <vector>        // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * ADAPTIVE SET
+ * C orders the array, as it does in pair. Once the set hashes
+ * it needs what unordered_set needs, and == must agree with C
+ ************************************************/
+template <typename T, typename C = std::less<T>>
+class adaptive_set
+{
+public:
+   //
+   // Construct
+   //
+   explicit adaptive_set(size_t threshold = DEFAULT_THRESHOLD, const C& c = C())
+      : threshold(threshold), compare(c), small(true) {}
+   adaptive_set(const adaptive_set& rhs) = default;
+   adaptive_set(adaptive_set&& rhs) : adaptive_set(rhs.threshold, rhs.compare)
+   {
+      swap(rhs);
+   }
+   // only for iterators, so that two integers pick the threshold above
+   template <class Iterator, class = typename std::iterator_traits<Iterator>::iterator_category>
+   adaptive_set(Iterator first, Iterator last, size_t threshold = DEFAULT_THRESHOLD, const C& c = C())
+      : adaptive_set(threshold, c)
+   {
+      build(first, last);
+   }
+   adaptive_set(const std::initializer_list<T>& il) : adaptive_set(il.begin(), il.end()) {}
+
+   //
+   // Assign
+   //
+   adaptive_set& operator = (const adaptive_set& rhs) = default;
+   adaptive_set& operator = (adaptive_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   adaptive_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      build(il.begin(), il.end());
+      return *this;
+   }
+   void swap(adaptive_set& rhs)
+   {
+      std::swap(threshold, rhs.threshold);
+      std::swap(compare, rhs.compare);
+      std::swap(small, rhs.small);
+      sorted.swap(rhs.sorted);
+      hashed.swap(rhs.hashed);
+   }
+
+   //
+   // Iterator - in order while the set is small. Moving between
+   // layouts invalidates them
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const { return find(t) != end(); }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (const T& t : il)
+         insert(t);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      sorted.clear();
+      hashed.clear();
+      small = true;
+   }
+   iterator erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size() const { return small ? sorted.size() : hashed.size(); }
+   bool empty() const  { return size() == 0; }
+   bool is_small() const { return small; }
+   size_t max_small() const { return threshold; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const size_t DEFAULT_THRESHOLD = 64;
+
+   // where t is or would go in the array
+   typename std::vector<T>::const_iterator lowerBound(const T& t) const
+   {
+      return std::lower_bound(sorted.begin(), sorted.end(), t, compare);
+   }
+   bool equivalent(const T& lhs, const T& rhs) const
+   {
+      return !compare(lhs, rhs) && !compare(rhs, lhs);
+   }
+
+   template <class Iterator>
+   void build(Iterator first, Iterator last);
+   void toHash();
+   void toArray();
+
+   size_t threshold;                  // more than this and the set hashes
+   C compare;                         // orders the array
+   bool small;                        // true while the elements are in sorted
+   std::vector<T> sorted;             // ascending by compare, while small
+   custom::unordered_set<T> hashed;   // once the set is large
+};
+
+/************************************************
+ * ADAPTIVE SET ITERATOR
+ * A pointer into the array, or an iterator into the hash
+ ************************************************/
+template <typename T, typename C>
+class adaptive_set <T, C> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : pValue(nullptr) {}
+   explicit iterator(const T* pValue) : pValue(pValue) {}
+   explicit iterator(const typename custom::unordered_set<T>::const_iterator& itHash)
+      : pValue(nullptr), itHash(itHash) {}
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return pValue == rhs.pValue && itHash == rhs.itHash; }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access - elements cannot change in place, they decide their order
+   //
+   const T& operator * () const { return pValue ? *pValue : *itHash; }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (pValue)
+         ++pValue;
+      else
+         ++itHash;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const T* pValue;   // null when the set is a hash
+   typename custom::unordered_set<T>::const_iterator itHash;
+};
+
+/*****************************************
+ * ADAPTIVE SET :: BEGIN / END
+ ****************************************/
+template <typename T, typename C>
+typename adaptive_set <T, C> ::iterator adaptive_set <T, C> ::begin() const
+{
+   return small ? iterator(sorted.data()) : iterator(hashed.begin());
+}
+
+template <typename T, typename C>
+typename adaptive_set <T, C> ::iterator adaptive_set <T, C> ::end() const
+{
+   return small ? iterator(sorted.data() + sorted.size()) : iterator(hashed.end());
+}
+
+/*****************************************
+ * ADAPTIVE SET :: FIND
+ * Binary search the array, or look in the hash
+ *     COST   : O(log threshold) or O(1)
+ ****************************************/
+template <typename T, typename C>
+typename adaptive_set <T, C> ::iterator adaptive_set <T, C> ::find(const T& t) const
+{
+   if (!small)
+      return iterator(hashed.find(t));
+
+   auto it = lowerBound(t);
+   if (it == sorted.end() || !equivalent(*it, t))
+      return end();
+   return iterator(sorted.data() + (it - sorted.begin()));
+}
+
+/*****************************************
+ * ADAPTIVE SET :: INSERT
+ * Slide the larger elements up to make room, or move everything to
+ * the hash if this one takes the array past the threshold
+ *     COST   : O(threshold), O(1) once hashed
+ ****************************************/
+template <typename T, typename C>
+custom::pair<typename adaptive_set <T, C> ::iterator, bool> adaptive_set <T, C> ::insert(const T& t)
+{
+   if (small)
+   {
+      auto it = lowerBound(t);
+      if (it != sorted.end() && equivalent(*it, t))
+         return custom::pair<iterator, bool>(iterator(sorted.data() + (it - sorted.begin())), false);
+      if (sorted.size() < threshold)
+      {
+         size_t i = it - sorted.begin();
+         sorted.insert(sorted.begin() + i, t);
+         return custom::pair<iterator, bool>(iterator(sorted.data() + i), true);
+      }
+      toHash();
+   }
+
+   auto result = hashed.insert(t);
+   typename custom::unordered_set<T>::const_iterator itHash(result.first);
+   return custom::pair<iterator, bool>(iterator(itHash), result.second);
+}
+
+/*****************************************
+ * ADAPTIVE SET :: ERASE
+ * Take t out. A hash down to half the threshold becomes an array
+ * again, and then there is no next element to return
+ *     COST   : O(threshold)
+ ****************************************/
+template <typename T, typename C>
+typename adaptive_set <T, C> ::iterator adaptive_set <T, C> ::erase(const T& t)
+{
+   if (small)
+   {
+      auto it = lowerBound(t);
+      if (it == sorted.end() || !equivalent(*it, t))
+         return end();
+      size_t i = it - sorted.begin();
+      sorted.erase(sorted.begin() + i);
+      return iterator(sorted.data() + i);
+   }
+
+   auto itNext = hashed.erase(t);
+   if (hashed.size() > threshold / 2)
+      return iterator(typename custom::unordered_set<T>::const_iterator(itNext));
+   toArray();
+   return end();
+}
+
+/*****************************************
+ * ADAPTIVE SET :: TO HASH
+ * Move every element from the array into the hash
+ *     COST   : O(threshold)
+ ****************************************/
+template <typename T, typename C>
+void adaptive_set <T, C> ::toHash()
+{
+   for (const T& t : sorted)
+      hashed.insert(t);
+   std::vector<T>().swap(sorted);
+   small = false;
+}
+
+/*****************************************
+ * ADAPTIVE SET :: TO ARRAY
+ * Move every element from the hash into the array and sort it
+ *     COST   : O(threshold log threshold)
+ ****************************************/
+template <typename T, typename C>
+void adaptive_set <T, C> ::toArray()
+{
+   sorted.reserve(threshold);
+   const custom::unordered_set<T>& from = hashed;
+   for (auto it = from.begin(); it != from.end(); ++it)
+      sorted.push_back(*it);
+   std::sort(sorted.begin(), sorted.end(), compare);
+   hashed.clear();
+   small = true;
+}
+
+/*****************************************
+ * ADAPTIVE SET :: BUILD
+ * Fill an empty set from a range: sort it once and drop the
+ * duplicates, then hash it if there is too much of it
+ *     COST   : O(n log n)
+ ****************************************/
+template <typename T, typename C>
+template <class Iterator>
+void adaptive_set <T, C> ::build(Iterator first, Iterator last)
+{
+   sorted.assign(first, last);
+   std::sort(sorted.begin(), sorted.end(), compare);
+   sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                            [this](const T& lhs, const T& rhs) { return equivalent(lhs, rhs); }),
+                sorted.end());
+   if (sorted.size() > threshold)
+      toHash();
+}
+
+} // namespace custom
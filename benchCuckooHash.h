@@ -0,0 +1,77 @@
+/***********************************************************************
+ * Header:
+ *    BENCH CUCKOO HASH
+ * Summary:
+ *    Tail latency of find(): the cuckoo hash, which looks in two
+ *    buckets at most, against the chained hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "cuckooHash.h"
+#include "hash.h"
+#include "benchmark.h"
+
+#include <chrono>
+#include <vector>
+
+class BenchCuckooHash : public Benchmark
+{
+public:
+   void run()
+   {
+      reset("nanoseconds per find");
+
+      custom::unordered_set<size_t> chained;
+      custom::cuckoo_unordered_set<size_t> cuckoo;
+      for (size_t i = 0; i < NUM_KEYS; i++)
+      {
+         chained.insert(i * 3);
+         cuckoo.insert(i * 3);
+      }
+
+      recordTail("chained", latencies([&](size_t key) { return chained.find(key) != chained.end(); }));
+      recordTail("cuckoo",  latencies([&](size_t key) { return cuckoo.find(key) != cuckoo.end(); }));
+
+      report("CuckooHash", "percentile");
+   }
+
+private:
+   static const size_t NUM_KEYS = 1000;
+   static const size_t NUM_FINDS = 200000;   // half hits, half misses
+
+   // time every find on its own
+   template <class Find>
+   std::vector<double> latencies(Find find)
+   {
+      std::vector<double> samples;
+      samples.reserve(NUM_FINDS);
+      size_t hits = 0;
+      for (size_t i = 0; i < NUM_FINDS; i++)
+      {
+         size_t key = (i * 7919) % (NUM_KEYS * 3);
+         auto begin = std::chrono::steady_clock::now();
+         hits += find(key) ? 1 : 0;
+         std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+         samples.push_back(elapsed.count());
+      }
+      this->hits += hits;
+      return samples;
+   }
+
+   void recordTail(const char* series, const std::vector<double>& samples)
+   {
+      record(series, "p50",   percentile(samples, 50.0));
+      record(series, "p99",   percentile(samples, 99.0));
+      record(series, "p99.9", percentile(samples, 99.9));
+      record(series, "max",   percentile(samples, 100.0));
+   }
+
+   size_t hits = 0;   // so the finds cannot be optimized away
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,120 @@
+/***********************************************************************
+ * Header:
+ *    BENCH EPOCH HASH
+ * Summary:
+ *    How lookups scale with reader threads while one writer keeps
+ *    inserting and erasing: the lock-free read path against a hash
+ *    behind one mutex
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "epochHash.h"
+#include "hash.h"
+#include "benchmark.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class BenchEpochHash : public Benchmark
+{
+public:
+   void run()
+   {
+      reset("million lookups per second");
+
+      for (size_t numReaders : threadCounts(MAX_READERS))
+      {
+         record("epoch", numReaders, benchEpoch(numReaders));
+         record("mutex", numReaders, benchMutex(numReaders));
+      }
+
+      report("EpochHash", "readers");
+   }
+
+private:
+   static const size_t MAX_READERS = 64;
+   static const size_t NUM_KEYS = 1000;          // preloaded, all hits
+   static const size_t NUM_LOOKUPS = 100000;     // per reader
+
+   /***************************************
+    * EPOCH
+    ***************************************/
+   double benchEpoch(size_t numReaders)
+   {
+      custom::concurrent_unordered_set<size_t> us;
+      for (size_t i = 0; i < NUM_KEYS; i++)
+         us.insert(i);
+
+      std::atomic<bool> done(false);
+      std::thread writer([&]()
+      {
+         for (size_t i = NUM_KEYS; !done; i++)
+         {
+            us.insert(i);
+            us.erase(i);
+         }
+      });
+
+      std::atomic<size_t> hits(0);
+      double elapsed = runThreads(numReaders, [&](size_t iThread)
+      {
+         size_t found = 0;
+         for (size_t i = 0; i < NUM_LOOKUPS; i++)
+            found += us.count((i * 7 + iThread) % NUM_KEYS);
+         hits += found;
+      });
+      done = true;
+      writer.join();
+
+      return (double)(numReaders * NUM_LOOKUPS) / elapsed / 1.0e6;
+   }
+
+   /***************************************
+    * MUTEX
+    ***************************************/
+   double benchMutex(size_t numReaders)
+   {
+      custom::unordered_set<size_t> us;
+      std::mutex lock;
+      for (size_t i = 0; i < NUM_KEYS; i++)
+         us.insert(i);
+
+      std::atomic<bool> done(false);
+      std::thread writer([&]()
+      {
+         for (size_t i = NUM_KEYS; !done; i++)
+         {
+            {
+               std::lock_guard<std::mutex> guard(lock);
+               us.insert(i);
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            us.erase(i);
+         }
+      });
+
+      std::atomic<size_t> hits(0);
+      double elapsed = runThreads(numReaders, [&](size_t iThread)
+      {
+         size_t found = 0;
+         for (size_t i = 0; i < NUM_LOOKUPS; i++)
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            found += us.count((i * 7 + iThread) % NUM_KEYS);
+         }
+         hits += found;
+      });
+      done = true;
+      writer.join();
+
+      return (double)(numReaders * NUM_LOOKUPS) / elapsed / 1.0e6;
+   }
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,118 @@
+/***********************************************************************
+ * Header:
+ *    BENCH FORWARD LIST
+ * Summary:
+ *    Hash buckets built from forward_list against the same buckets
+ *    built from list: the time to insert, find and erase through them,
+ *    and the bytes each spends on links, at a few load factors
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "forwardList.h"
+#include "list.h"
+#include "benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+class BenchForwardList : public Benchmark
+{
+public:
+   void run()
+   {
+      std::vector<size_t> keys(NUM_KEYS);
+      for (size_t i = 0; i < NUM_KEYS; i++)
+         keys[i] = i * 2654435761u;
+      std::mt19937 random(42);
+      std::shuffle(keys.begin(), keys.end(), random);
+
+      reset("nanoseconds per operation");
+      for (size_t loadFactor : { 1, 4, 16 })
+      {
+         Buckets<custom::list<size_t>> list(NUM_KEYS / loadFactor);
+         Buckets<custom::forward_list<size_t>> flist(NUM_KEYS / loadFactor);
+         std::string config = "load " + std::to_string(loadFactor);
+         record("list insert",  config, list.insert(keys));
+         record("flist insert", config, flist.insert(keys));
+         record("list find",    config, list.find(keys));
+         record("flist find",   config, flist.find(keys));
+         record("list erase",   config, list.erase(keys));
+         record("flist erase",  config, flist.erase(keys));
+         sum += list.sum + flist.sum;
+      }
+      report("ForwardList", "buckets");
+
+      // not measured: a list node is the element and two pointers, a
+      // forward_list node the element and one, plus each bucket's own
+      // size spread over its elements
+      reset("bytes of links per element, computed from sizeof");
+      for (size_t loadFactor : { 1, 4, 16 })
+      {
+         std::string config = "load " + std::to_string(loadFactor);
+         record("list",  config, 2.0 * sizeof(void*) + (double)sizeof(custom::list<size_t>) / loadFactor);
+         record("flist", config, 1.0 * sizeof(void*) + (double)sizeof(custom::forward_list<size_t>) / loadFactor);
+      }
+      report("ForwardList", "buckets");
+   }
+
+private:
+   static const size_t NUM_KEYS = 1 << 16;
+
+   // a chained hash with nothing but its buckets, so the chain type
+   // is all that differs
+   template <class Chain>
+   struct Buckets
+   {
+      Buckets(size_t numBuckets) : buckets(numBuckets), sum(0) {}
+
+      double insert(const std::vector<size_t>& keys)
+      {
+         return seconds([&]()
+         {
+            for (size_t key : keys)
+               buckets[key % buckets.size()].push_front(key);
+         }) * 1.0e9 / keys.size();
+      }
+
+      double find(const std::vector<size_t>& keys)
+      {
+         return seconds([&]()
+         {
+            for (size_t key : keys)
+               sum += *buckets[key % buckets.size()].find(key);
+         }) * 1.0e9 / keys.size();
+      }
+
+      double erase(const std::vector<size_t>& keys)
+      {
+         return seconds([&]()
+         {
+            for (size_t key : keys)
+               remove(buckets[key % buckets.size()], key);
+         }) * 1.0e9 / keys.size();
+      }
+
+      static void remove(custom::list<size_t>& chain, size_t key)
+      {
+         chain.erase(chain.find(key));
+      }
+      static void remove(custom::forward_list<size_t>& chain, size_t key)
+      {
+         chain.erase_after(chain.find_before(key));
+      }
+
+      std::vector<Chain> buckets;
+      size_t sum;   // so the finds cannot be optimized away
+   };
+
+   size_t sum = 0;
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,115 @@
+/***********************************************************************
+ * Header:
+ *    BENCH MOVE TO FRONT
+ * Summary:
+ *    How far find() walks down a chain when a few keys get most of
+ *    the lookups, with and without the self-organizing find policies
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "hash.h"
+#include "list.h"
+#include "benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+class BenchMoveToFront : public Benchmark
+{
+public:
+   void run()
+   {
+      std::vector<size_t> lookups = zipf();
+
+      // a list, and a hash whose 10 buckets hold ~100 keys each
+      reset("nodes walked per find");
+      for (auto policy : { custom::find_policy::stay,
+                           custom::find_policy::move_to_front,
+                           custom::find_policy::transpose })
+      {
+         custom::list<size_t> l;
+         custom::unordered_set<size_t> us;
+         for (size_t i = 0; i < NUM_KEYS; i++)
+         {
+            l.push_back(i);
+            us.insert(i);
+         }
+         us.set_find_policy(policy);
+         const custom::unordered_set<size_t>& cus = us;
+
+         double walkList = 0.0;
+         double walkHash = 0.0;
+         for (size_t key : lookups)
+         {
+            walkList += position(l.cbegin(), key);
+            l.find(key, policy);
+            walkHash += position(cus.begin(cus.bucket(key)), key);
+            us.find(key);
+         }
+         record("list", name(policy), walkList / lookups.size());
+         record("hash", name(policy), walkHash / lookups.size());
+      }
+      report("MoveToFront", "policy");
+   }
+
+private:
+   static const size_t NUM_KEYS = 1000;
+   static const size_t NUM_FINDS = 200000;
+
+   // a Zipf (s = 1) stream of keys: rank r comes up in proportion to
+   // 1/r, and the ranks are dealt out to the keys at random so that
+   // the popular ones do not start at the front
+   static std::vector<size_t> zipf()
+   {
+      std::mt19937 random(42);
+      std::vector<size_t> keyOfRank(NUM_KEYS);
+      for (size_t i = 0; i < NUM_KEYS; i++)
+         keyOfRank[i] = i;
+      std::shuffle(keyOfRank.begin(), keyOfRank.end(), random);
+
+      std::vector<double> cdf(NUM_KEYS);
+      double sum = 0.0;
+      for (size_t r = 0; r < NUM_KEYS; r++)
+         cdf[r] = sum += 1.0 / (r + 1);
+
+      std::uniform_real_distribution<double> uniform(0.0, sum);
+      std::vector<size_t> lookups(NUM_FINDS);
+      for (size_t& key : lookups)
+      {
+         size_t r = std::lower_bound(cdf.begin(), cdf.end(), uniform(random)) - cdf.begin();
+         key = keyOfRank[std::min(r, NUM_KEYS - 1)];
+      }
+      return lookups;
+   }
+
+   // how many nodes a find for key would look at, starting from it
+   template <class Iterator>
+   static size_t position(Iterator it, size_t key)
+   {
+      size_t walked = 1;
+      for (; *it != key; ++it)
+         walked++;
+      return walked;
+   }
+
+   static const char* name(custom::find_policy policy)
+   {
+      switch (policy)
+      {
+         case custom::find_policy::move_to_front:
+            return "front";
+         case custom::find_policy::transpose:
+            return "transpose";
+         default:
+            return "stay";
+      }
+   }
+};
+
+#endif // BENCHMARK
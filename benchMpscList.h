@@ -0,0 +1,107 @@
+/***********************************************************************
+ * Header:
+ *    BENCH MPSC LIST
+ * Summary:
+ *    How a work queue's throughput scales with producer threads while
+ *    one consumer drains it: the lock-free mpsc_list against a list
+ *    behind one mutex
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "mpscList.h"
+#include "list.h"
+#include "benchmark.h"
+
+#include <mutex>
+
+class BenchMpscList : public Benchmark
+{
+public:
+   void run()
+   {
+      reset("million items per second");
+
+      for (size_t numProducers : threadCounts(MAX_PRODUCERS))
+      {
+         record("mpsc",  numProducers, benchMpsc(numProducers));
+         record("mutex", numProducers, benchMutex(numProducers));
+      }
+
+      report("MpscList", "producers");
+   }
+
+private:
+   static const size_t MAX_PRODUCERS = 16;
+   static const size_t NUM_ITEMS = 200000;   // per producer
+
+   /***************************************
+    * MPSC
+    * The last thread is the consumer
+    ***************************************/
+   double benchMpsc(size_t numProducers)
+   {
+      custom::mpsc_list<size_t> l;
+      size_t sum = 0;
+      double elapsed = runThreads(numProducers + 1, [&](size_t iThread)
+      {
+         if (iThread < numProducers)
+         {
+            for (size_t i = 0; i < NUM_ITEMS; i++)
+               l.push_back(i);
+            return;
+         }
+         size_t value;
+         for (size_t numPopped = 0; numPopped < numProducers * NUM_ITEMS; )
+            if (l.try_pop_front(value))
+            {
+               sum += value;
+               numPopped++;
+            }
+      });
+      this->sum += sum;
+      return (double)(numProducers * NUM_ITEMS) / elapsed / 1.0e6;
+   }
+
+   /***************************************
+    * MUTEX
+    ***************************************/
+   double benchMutex(size_t numProducers)
+   {
+      custom::list<size_t> l;
+      std::mutex lock;
+      size_t sum = 0;
+      double elapsed = runThreads(numProducers + 1, [&](size_t iThread)
+      {
+         if (iThread < numProducers)
+         {
+            for (size_t i = 0; i < NUM_ITEMS; i++)
+            {
+               std::lock_guard<std::mutex> guard(lock);
+               l.push_back(i);
+            }
+            return;
+         }
+         for (size_t numPopped = 0; numPopped < numProducers * NUM_ITEMS; )
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!l.empty())
+            {
+               sum += l.front();
+               l.pop_front();
+               numPopped++;
+            }
+         }
+      });
+      this->sum += sum;
+      return (double)(numProducers * NUM_ITEMS) / elapsed / 1.0e6;
+   }
+
+   size_t sum = 0;   // so the pops cannot be optimized away
+};
+
+#endif // BENCHMARK
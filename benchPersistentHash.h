@@ -0,0 +1,82 @@
+/***********************************************************************
+ * Header:
+ *    BENCH PERSISTENT HASH
+ * Summary:
+ *    What it costs to keep every version of a set: a new version of
+ *    the persistent trie, which copies one path, against a copy of
+ *    the whole unordered_set, at a few sizes
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include "persistentHash.h"
+#include "hash.h"
+#include "benchmark.h"
+
+#include <vector>
+
+class BenchPersistentHash : public Benchmark
+{
+public:
+   void run()
+   {
+      reset("microseconds per version");
+      for (size_t numElements : { 1 << 10, 1 << 13, 1 << 16 })
+      {
+         record("persistent", numElements, benchPersistent(numElements));
+         record("copy",       numElements, benchCopy(numElements));
+      }
+      report("PersistentHash", "elements");
+   }
+
+private:
+   static const size_t NUM_VERSIONS = 32;   // all kept alive at once
+
+   /***************************************
+    * PERSISTENT
+    ***************************************/
+   double benchPersistent(size_t numElements)
+   {
+      custom::persistent_unordered_set<size_t> s;
+      for (size_t i = 0; i < numElements; i++)
+         s = s.insert(i);
+      std::vector<custom::persistent_unordered_set<size_t>> versions(1, s);
+      double elapsed = seconds([&]()
+      {
+         for (size_t i = 0; i < NUM_VERSIONS; i++)
+            versions.push_back(versions.back().insert(numElements + i));
+      });
+      sum += versions.back().size();
+      return elapsed * 1.0e6 / NUM_VERSIONS;
+   }
+
+   /***************************************
+    * COPY
+    ***************************************/
+   double benchCopy(size_t numElements)
+   {
+      custom::unordered_set<size_t> s;
+      for (size_t i = 0; i < numElements; i++)
+         s.insert(i);
+      std::vector<custom::unordered_set<size_t>> versions(1, s);
+      versions.reserve(NUM_VERSIONS + 1);
+      double elapsed = seconds([&]()
+      {
+         for (size_t i = 0; i < NUM_VERSIONS; i++)
+         {
+            versions.push_back(versions.back());
+            versions.back().insert(numElements + i);
+         }
+      });
+      sum += versions.back().size();
+      return elapsed * 1.0e6 / NUM_VERSIONS;
+   }
+
+   size_t sum = 0;   // so the versions cannot be optimized away
+};
+
+#endif // BENCHMARK
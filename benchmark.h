@@ -0,0 +1,162 @@
+/***********************************************************************
+ * Header:
+ *    BENCHMARK
+ * Summary:
+ *    The base class to all the benchmark classes. A benchmark records
+ *    one number per (series, configuration) and prints them as a table
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef BENCHMARK
+
+#include <algorithm> // for std::sort and std::find
+#include <atomic>    // for std::atomic
+#include <chrono>    // for std::chrono::steady_clock
+#include <iomanip>   // for std::setw
+#include <iostream>  // for std::cerr
+#include <map>       // for std::map
+#include <string>    // for std::string
+#include <thread>    // for std::thread
+#include <vector>    // for std::vector
+
+class Benchmark
+{
+public:
+   Benchmark() { reset(); }
+
+private:
+   // each series (the key) has one value per configuration
+   std::map<std::string, std::map<std::string, double>> results;
+   std::vector<std::string> configs;   // in the order they were first recorded
+   std::string unit;
+
+protected:
+   /*************************************************************
+    * RESET
+    * Forget the results
+    *************************************************************/
+   void reset(const char* unit = "")
+   {
+      results.clear();
+      configs.clear();
+      this->unit = unit;
+   }
+
+   /*************************************************************
+    * RECORD
+    * Remember one measurement
+    *************************************************************/
+   void record(const std::string& series, const std::string& config, double value)
+   {
+      if (std::find(configs.begin(), configs.end(), config) == configs.end())
+         configs.push_back(config);
+      results[series][config] = value;
+   }
+   void record(const std::string& series, size_t config, double value)
+   {
+      record(series, std::to_string(config), value);
+   }
+
+   /*************************************************************
+    * REPORT
+    * One row per configuration, one column per series
+    *************************************************************/
+   void report(const char* name, const char* configName)
+   {
+      std::cerr << name << ":\t(" << unit << ")\n";
+      std::cerr << "\t" << std::setw(10) << configName;
+      for (auto& series : results)
+         std::cerr << std::setw(16) << series.first;
+      std::cerr << "\n";
+
+      std::cerr.setf(std::ios::fixed | std::ios::showpoint);
+      std::cerr.precision(2);
+      for (auto& config : configs)
+      {
+         std::cerr << "\t" << std::setw(10) << config;
+         for (auto& series : results)
+         {
+            auto it = series.second.find(config);
+            if (it == series.second.end())
+               std::cerr << std::setw(16) << "-";
+            else
+               std::cerr << std::setw(16) << it->second;
+         }
+         std::cerr << "\n";
+      }
+   }
+
+   /*************************************************************
+    * SECONDS
+    * How long body() took
+    *************************************************************/
+   template <class Body>
+   static double seconds(Body body)
+   {
+      auto begin = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+      return elapsed.count();
+   }
+
+   /*************************************************************
+    * RUN THREADS
+    * Start body(iThread) on numThreads threads at the same moment
+    * and return how long it took them all to finish
+    *************************************************************/
+   template <class Body>
+   static double runThreads(size_t numThreads, Body body)
+   {
+      std::atomic<size_t> ready(0);
+      std::atomic<bool> go(false);
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < numThreads; i++)
+         threads.push_back(std::thread([&, i]()
+         {
+            ready++;
+            while (!go)
+               std::this_thread::yield();
+            body(i);
+         }));
+      while (ready != numThreads)
+         std::this_thread::yield();
+
+      double elapsed = seconds([&]()
+      {
+         go = true;
+         for (auto& thread : threads)
+            thread.join();
+      });
+      return elapsed;
+   }
+
+   /*************************************************************
+    * THREAD COUNTS
+    * 1, 2, 4, ... up to max
+    *************************************************************/
+   static std::vector<size_t> threadCounts(size_t max)
+   {
+      std::vector<size_t> counts;
+      for (size_t n = 1; n <= max; n *= 2)
+         counts.push_back(n);
+      return counts;
+   }
+
+   /*************************************************************
+    * PERCENTILE
+    * The p-th percentile (0 to 100) of some samples
+    *************************************************************/
+   static double percentile(std::vector<double> samples, double p)
+   {
+      if (samples.empty())
+         return 0.0;
+      std::sort(samples.begin(), samples.end());
+      size_t i = (size_t)(p / 100.0 * (samples.size() - 1) + 0.5);
+      return samples[i];
+   }
+};
+
+#endif // BENCHMARK
@@ -0,0 +1,65 @@
+/***********************************************************************
+ * Header:
+ *    BITS
+ * Summary:
+ *    Counting and finding the set bits of a 64-bit word, for the sets
+ *    that keep their keys as bitmaps. Each uses the compiler's single
+ *    instruction where there is one
+ *
+ *    This will contain the functions:
+ *        popcount   : How many bits are set
+ *        lowest_bit : The index of the lowest set bit
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t
+#if defined(_MSC_VER) && defined(_WIN64)
+#include <intrin.h>   // for __popcnt64 and _BitScanForward64
+#endif
+
+namespace custom
+{
+
+/*****************************************
+ * POPCOUNT
+ * How many bits of a word are set
+ ****************************************/
+inline size_t popcount(uint64_t bits)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+   return (size_t)__popcnt64(bits);
+#elif defined(__GNUC__)
+   return (size_t)__builtin_popcountll(bits);
+#else
+   size_t num = 0;
+   for (; bits; bits &= bits - 1)
+      num++;
+   return num;
+#endif
+}
+
+/*****************************************
+ * LOWEST BIT
+ * The index of the lowest set bit. bits cannot be zero
+ ****************************************/
+inline int lowest_bit(uint64_t bits)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+   unsigned long i;
+   _BitScanForward64(&i, bits);
+   return (int)i;
+#elif defined(__GNUC__)
+   return __builtin_ctzll(bits);
+#else
+   int i = 0;
+   for (; !(bits & 1); bits >>= 1)
+      i++;
+   return i;
+#endif
+}
+
+} // namespace custom
@@ -0,0 +1,430 @@
+/***********************************************************************
+ * Header:
+ *    CUCKOO HASH
+ * Summary:
+ *    A set with a worst-case bound on lookups. Every key lives in one
+ *    of exactly two buckets of four slots each, so find() looks at two
+ *    buckets and no more. When both of a new key's buckets are full,
+ *    insert() searches breadth-first for the shortest chain of keys
+ *    that can each step over to their other bucket, shifts them along
+ *    it, and only rehashes into twice the buckets if there is none
+ *
+ *    This will contain the class definition of:
+ *        cuckoo_unordered_set           : A bucketized cuckoo hash
+ *        cuckoo_unordered_set::iterator : An iterator through it
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // because insert() returns a pair
+#include <cstdint>    // for uint64_t
+#include <functional> // for std::hash
+#include <utility>    // for std::swap
+#include <vector>     // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * CUCKOO UNORDERED SET
+ * The same interface as unordered_set, less the local iterators
+ ************************************************/
+template <typename T>
+class cuckoo_unordered_set
+{
+public:
+   //
+   // Construct
+   //
+   cuckoo_unordered_set() : buckets(MIN_BUCKETS), numElements(0) {}
+   explicit cuckoo_unordered_set(size_t numBuckets) : buckets(round(numBuckets)), numElements(0) {}
+   cuckoo_unordered_set(const cuckoo_unordered_set& rhs) = default;
+   cuckoo_unordered_set(cuckoo_unordered_set&& rhs)
+      : buckets(std::move(rhs.buckets)), numElements(rhs.numElements)
+   {
+      rhs.buckets = std::vector<Bucket>(MIN_BUCKETS);
+      rhs.numElements = 0;
+   }
+   template <class Iterator>
+   cuckoo_unordered_set(Iterator first, Iterator last) : cuckoo_unordered_set()
+   {
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+   cuckoo_unordered_set(const std::initializer_list<T>& il) : cuckoo_unordered_set(il.begin(), il.end()) {}
+
+   //
+   // Assign
+   //
+   cuckoo_unordered_set& operator = (const cuckoo_unordered_set& rhs) = default;
+   cuckoo_unordered_set& operator = (cuckoo_unordered_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   cuckoo_unordered_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(cuckoo_unordered_set& rhs)
+   {
+      std::swap(buckets, rhs.buckets);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Hash - two buckets per key. The second is the first mixed
+   // with the key's scrambled bits, so keys that share one bucket
+   // scatter over many others
+   //
+   size_t bucket1(const T& t) const { return std::hash<T>()(t) & (bucket_count() - 1); }
+   size_t bucket2(const T& t) const { return mix(std::hash<T>()(t)) & (bucket_count() - 1); }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access - at most two buckets
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const { return find(t) != end(); }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (const T& t : il)
+         insert(t);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      for (auto& bucket : buckets)
+         bucket.used = 0;
+      numElements = 0;
+   }
+   iterator erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size() const { return numElements; }
+   bool empty() const  { return numElements == 0; }
+   size_t bucket_count() const { return buckets.size(); }
+   size_t bucket_size(size_t i) const
+   {
+      size_t num = 0;
+      for (int iSlot = 0; iSlot < SLOTS; iSlot++)
+         num += buckets[i].isUsed(iSlot) ? 1 : 0;
+      return num;
+   }
+   float load_factor() const { return (float)numElements / (float)(bucket_count() * SLOTS); }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const int    SLOTS = 4;          // keys per bucket
+   static const size_t MIN_BUCKETS = 8;
+   static const size_t MAX_SEARCH = 256;   // buckets the eviction search may visit
+
+   // four keys and which of them are in use. With C++17's aligned
+   // new and 8-byte keys a bucket is exactly one cache line
+   struct alignas(64) Bucket
+   {
+      Bucket() : used(0) {}
+      bool isUsed(int iSlot) const { return (used >> iSlot) & 1; }
+      int  freeSlot() const
+      {
+         for (int iSlot = 0; iSlot < SLOTS; iSlot++)
+            if (!isUsed(iSlot))
+               return iSlot;
+         return -1;
+      }
+      T slots[SLOTS];
+      unsigned char used;   // bit i set when slots[i] holds a key
+   };
+
+   // one bucket reached by the eviction search, and how we got there
+   struct Step
+   {
+      size_t iBucket;
+      int    iParent;       // the step before, -1 at one of the key's own buckets
+      int    iSlot;         // the slot in the parent whose key moves here
+   };
+
+   static size_t round(size_t numBuckets)
+   {
+      size_t pow2 = MIN_BUCKETS;
+      while (pow2 < numBuckets)
+         pow2 *= 2;
+      return pow2;
+   }
+   static size_t mix(size_t h)
+   {
+      uint64_t x = (uint64_t)h;
+      x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+      x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+      x ^= x >> 31;
+      return (size_t)x;
+   }
+   size_t alternate(const T& t, size_t iBucket) const
+   {
+      size_t i1 = bucket1(t);
+      return iBucket == i1 ? bucket2(t) : i1;
+   }
+
+   bool place(const T& t, size_t& iBucket, int& iSlot);
+   void rehash(size_t numBuckets);
+
+   std::vector<Bucket> buckets;   // a power of two of them
+   size_t numElements;
+};
+
+/************************************************
+ * CUCKOO UNORDERED SET ITERATOR
+ * Walks the used slots bucket by bucket
+ ************************************************/
+template <typename T>
+class cuckoo_unordered_set <T> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr), iSlot(0) {}
+   iterator(const Bucket* pBucket, const Bucket* pBucketEnd, int iSlot)
+      : pBucket(pBucket), pBucketEnd(pBucketEnd), iSlot(iSlot) {}
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return pBucket == rhs.pBucket && iSlot == rhs.iSlot; }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access - keys cannot change in place, they decide where they live
+   //
+   const T& operator * () const { return pBucket->slots[iSlot]; }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      iSlot++;
+      return settle();
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+   // the first used slot at or after this one
+   iterator& settle()
+   {
+      for (; pBucket != pBucketEnd; ++pBucket, iSlot = 0)
+         for (; iSlot < SLOTS; iSlot++)
+            if (pBucket->isUsed(iSlot))
+               return *this;
+      iSlot = 0;
+      return *this;
+   }
+
+   // erase() needs to know which slot to clear
+   friend class cuckoo_unordered_set <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const Bucket* pBucket;
+   const Bucket* pBucketEnd;
+   int iSlot;
+};
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: BEGIN / END
+ ****************************************/
+template <typename T>
+typename cuckoo_unordered_set <T> ::iterator cuckoo_unordered_set <T> ::begin() const
+{
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   return iterator(buckets.data(), pEnd, 0).settle();
+}
+
+template <typename T>
+typename cuckoo_unordered_set <T> ::iterator cuckoo_unordered_set <T> ::end() const
+{
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   return iterator(pEnd, pEnd, 0);
+}
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: FIND
+ * Look in the key's two buckets and nowhere else
+ *     COST   : O(1) worst case
+ ****************************************/
+template <typename T>
+typename cuckoo_unordered_set <T> ::iterator cuckoo_unordered_set <T> ::find(const T& t) const
+{
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   size_t candidates[2] = { bucket1(t), bucket2(t) };
+   for (size_t iBucket : candidates)
+   {
+      const Bucket& b = buckets[iBucket];
+      for (int iSlot = 0; iSlot < SLOTS; iSlot++)
+         if (b.isUsed(iSlot) && b.slots[iSlot] == t)
+            return iterator(&b, pEnd, iSlot);
+   }
+   return end();
+}
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: INSERT
+ * Put t in a free slot of one of its buckets, making room by
+ * evictions if need be, and rehash only when that fails
+ *     COST   : O(1) expected, O(n) when it rehashes
+ ****************************************/
+template <typename T>
+custom::pair<typename cuckoo_unordered_set <T> ::iterator, bool> cuckoo_unordered_set <T> ::insert(const T& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+
+   size_t iBucket;
+   int iSlot;
+   while (!place(t, iBucket, iSlot))
+      rehash(bucket_count() * 2);
+
+   numElements++;
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   return custom::pair<iterator, bool>(iterator(&buckets[iBucket], pEnd, iSlot), true);
+}
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: PLACE
+ * Search breadth-first from t's two buckets for one with a free
+ * slot, never visiting a bucket twice. Then walk the path back,
+ * moving each key on it into the slot the step before freed up,
+ * so the shortest possible chain of keys moves
+ *     OUTPUT : where t went, false if no path was found
+ *     COST   : O(MAX_SEARCH)
+ ****************************************/
+template <typename T>
+bool cuckoo_unordered_set <T> ::place(const T& t, size_t& iBucket, int& iSlot)
+{
+   std::vector<Step> search;
+   search.reserve(MAX_SEARCH + SLOTS);
+   search.push_back(Step{ bucket1(t), -1, -1 });
+   if (bucket2(t) != bucket1(t))
+      search.push_back(Step{ bucket2(t), -1, -1 });
+
+   int found = -1;
+   for (size_t i = 0; found < 0 && i < search.size() && search.size() < MAX_SEARCH; i++)
+   {
+      const Bucket& b = buckets[search[i].iBucket];
+      if (b.freeSlot() >= 0)
+      {
+         found = (int)i;
+         break;
+      }
+      for (int s = 0; s < SLOTS; s++)
+      {
+         size_t iNext = alternate(b.slots[s], search[i].iBucket);
+         bool seen = false;
+         for (auto& step : search)
+            seen = seen || step.iBucket == iNext;
+         if (!seen)
+            search.push_back(Step{ iNext, (int)i, s });
+      }
+   }
+   if (found < 0)
+      return false;
+
+   // shift the keys along the path, starting at the far end
+   for (int i = found; search[i].iParent >= 0; i = search[i].iParent)
+   {
+      Bucket& to = buckets[search[i].iBucket];
+      Bucket& from = buckets[search[search[i].iParent].iBucket];
+      int iTo = to.freeSlot();
+      to.slots[iTo] = std::move(from.slots[search[i].iSlot]);
+      to.used |= (unsigned char)(1 << iTo);
+      from.used &= (unsigned char)~(1 << search[i].iSlot);
+      found = search[i].iParent;
+   }
+
+   Bucket& home = buckets[search[found].iBucket];
+   iBucket = search[found].iBucket;
+   iSlot = home.freeSlot();
+   home.slots[iSlot] = t;
+   home.used |= (unsigned char)(1 << iSlot);
+   return true;
+}
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: REHASH
+ * Move every key into a table with numBuckets buckets, doubling
+ * again if even that cannot hold them
+ *     COST   : O(n)
+ ****************************************/
+template <typename T>
+void cuckoo_unordered_set <T> ::rehash(size_t numBuckets)
+{
+   std::vector<Bucket> old(round(numBuckets));
+   buckets.swap(old);
+   for (bool fits = false; !fits; )
+   {
+      fits = true;
+      for (auto& b : old)
+         for (int s = 0; fits && s < SLOTS; s++)
+         {
+            size_t iBucket;
+            int iSlot;
+            if (b.isUsed(s))
+               fits = place(b.slots[s], iBucket, iSlot);
+         }
+      if (!fits)
+         buckets = std::vector<Bucket>(bucket_count() * 2);
+   }
+}
+
+/*****************************************
+ * CUCKOO UNORDERED SET :: ERASE
+ * Clear t's slot. Returns the element after it
+ *     COST   : O(1)
+ ****************************************/
+template <typename T>
+typename cuckoo_unordered_set <T> ::iterator cuckoo_unordered_set <T> ::erase(const T& t)
+{
+   iterator it = find(t);
+   if (it == end())
+      return it;
+
+   Bucket& b = buckets[it.pBucket - buckets.data()];
+   b.used &= (unsigned char)~(1 << it.iSlot);
+   numElements--;
+   return it.settle();
+}
+
+} // namespace custom
@@ -0,0 +1,472 @@
+/***********************************************************************
+ * Header:
+ *    DENSE HASH
+ * Summary:
+ *    A set of integers that keeps its keys as bits in a bitmap while
+ *    they come from a narrow range, such as IDs 0..1M. A bit costs far
+ *    less than a list node and finding one is a shift and a mask. Once
+ *    the range grows so wide that the bitmap would take more memory
+ *    than the nodes of a chained hash, it moves every key into an
+ *    unordered_set and hashes from then on
+ *
+ *    This will contain the class definition of:
+ *        dense_unordered_set           : A bitmap set of integers
+ *        dense_unordered_set::iterator : An iterator through it
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "bits.h"        // for popcount and lowest_bit
+#include "hash.h"        // for the unordered_set we fall back to
+#include "pair.h"        // because insert() returns a pair
+#include <algorithm>     // for std::min and std::max
+#include <climits>       // for CHAR_BIT
+#include <cstdint>       // for uint64_t
+#include <iterator>      // for std::iterator_traits
+#include <type_traits>   // for std::is_integral and std::is_signed
+#include <utility>       // for std::swap
+#include <vector>        // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * DENSE UNORDERED SET
+ * The same interface as unordered_set, less the buckets.
+ * Keys iterate in ascending order while the set is dense
+ ************************************************/
+template <typename T>
+class dense_unordered_set
+{
+   static_assert(std::is_integral<T>::value, "dense_unordered_set holds integers");
+
+public:
+   //
+   // Construct
+   //
+   dense_unordered_set() : base(0), numElements(0), dense(true) {}
+   // the keys will mostly fall in [low, high]: size the bitmap for them
+   // now. Keys in this range never make the set go sparse
+   dense_unordered_set(T low, T high) : numElements(0), dense(true)
+   {
+      base = key(low) & ~WORD_MASK;
+      words.assign((size_t)(((key(high) | WORD_MASK) - base) / WORD_BITS + 1), 0);
+   }
+   dense_unordered_set(const dense_unordered_set& rhs) = default;
+   dense_unordered_set(dense_unordered_set&& rhs) : dense_unordered_set()
+   {
+      swap(rhs);
+   }
+   // only for iterators, so that two integers pick the hint above
+   template <class Iterator, class = typename std::iterator_traits<Iterator>::iterator_category>
+   dense_unordered_set(Iterator first, Iterator last) : dense_unordered_set()
+   {
+      build(first, last, typename std::iterator_traits<Iterator>::iterator_category());
+   }
+   dense_unordered_set(const std::initializer_list<T>& il) : dense_unordered_set(il.begin(), il.end()) {}
+
+   //
+   // Assign
+   //
+   dense_unordered_set& operator = (const dense_unordered_set& rhs) = default;
+   dense_unordered_set& operator = (dense_unordered_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   dense_unordered_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(dense_unordered_set& rhs)
+   {
+      std::swap(words, rhs.words);
+      std::swap(base, rhs.base);
+      std::swap(numElements, rhs.numElements);
+      std::swap(dense, rhs.dense);
+      sparse.swap(rhs.sparse);
+   }
+
+   //
+   // Iterator - growing the bitmap invalidates them, as with a vector
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const { return find(t) != end(); }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (const T& t : il)
+         insert(t);
+   }
+
+   //
+   // Remove
+   //
+   // an empty set starts over as a bitmap
+   void clear() noexcept
+   {
+      words.clear();
+      base = 0;
+      numElements = 0;
+      dense = true;
+      sparse.clear();
+   }
+   iterator erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size() const { return dense ? numElements : sparse.size(); }
+   bool empty() const  { return size() == 0; }
+   bool is_dense() const { return dense; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const uint64_t WORD_BITS = 64;
+   static const uint64_t WORD_MASK = WORD_BITS - 1;
+   static const size_t   MIN_WORDS = 64;   // any range of 4096 keys stays dense
+   // what one key costs in a chained hash: the key and two links
+   static const size_t   NODE_BITS = (sizeof(T) + 2 * sizeof(void*)) * CHAR_BIT;
+
+   // keys as unsigned offsets, with the sign bit flipped so that
+   // negative numbers sort below positive ones
+   static uint64_t key(T t)
+   {
+      return (uint64_t)(typename std::make_unsigned<T>::type)t ^ SIGN;
+   }
+   static T value(uint64_t k)
+   {
+      return (T)(typename std::make_unsigned<T>::type)(k ^ SIGN);
+   }
+   static const uint64_t SIGN = std::is_signed<T>::value ? (uint64_t)1 << (sizeof(T) * CHAR_BIT - 1) : 0;
+
+   // the most words numKeys keys may spread over before they are
+   // cheaper as list nodes
+   static size_t maxWords(size_t numKeys)
+   {
+      return std::max((size_t)MIN_WORDS, numKeys * NODE_BITS / WORD_BITS);
+   }
+
+   bool covers(uint64_t k) const
+   {
+      return k >= base && (k - base) / WORD_BITS < words.size();
+   }
+   iterator at(size_t iWord, uint64_t bits) const
+   {
+      const uint64_t* pEnd = words.data() + words.size();
+      return iterator(words.data() + iWord, pEnd, bits, base + iWord * WORD_BITS).settle();
+   }
+
+   template <class Iterator>
+   void build(Iterator first, Iterator last, std::input_iterator_tag);
+   template <class Iterator>
+   void build(Iterator first, Iterator last, std::forward_iterator_tag);
+   bool grow(uint64_t k);
+   void goSparse();
+
+   std::vector<uint64_t> words;       // bit i of words[w] is key base + 64w + i
+   uint64_t base;                     // always a multiple of 64
+   size_t numElements;                // set bits, while dense
+   bool dense;                        // false once the keys are in sparse
+   custom::unordered_set<T> sparse;   // the keys, once the bitmap is too thin
+};
+
+/************************************************
+ * DENSE UNORDERED SET ITERATOR
+ * A word at a time: copy the word and strip its lowest bit on every
+ * step, so empty stretches of a word cost nothing. When the set is
+ * sparse it walks the chained hash instead
+ ************************************************/
+template <typename T>
+class dense_unordered_set <T> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : pWord(nullptr), pWordEnd(nullptr), bits(0), wordBase(0) {}
+   iterator(const uint64_t* pWord, const uint64_t* pWordEnd, uint64_t bits, uint64_t wordBase)
+      : pWord(pWord), pWordEnd(pWordEnd), bits(bits), wordBase(wordBase) {}
+   explicit iterator(const typename custom::unordered_set<T>::const_iterator& itHash)
+      : pWord(nullptr), pWordEnd(nullptr), bits(0), wordBase(0), itHash(itHash) {}
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return pWord == rhs.pWord && bits == rhs.bits && itHash == rhs.itHash;
+   }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access - there is no key to point at, only a bit
+   //
+   T operator * () const { return pWord ? value(wordBase + lowest_bit(bits)) : *itHash; }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (!pWord)
+      {
+         ++itHash;
+         return *this;
+      }
+      bits &= bits - 1;
+      return settle();
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+   // the first set bit at or after this one
+   iterator& settle()
+   {
+      while (!bits && pWord != pWordEnd && ++pWord != pWordEnd)
+      {
+         bits = *pWord;
+         wordBase += WORD_BITS;
+      }
+      return *this;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const uint64_t* pWord;      // null when the set is sparse
+   const uint64_t* pWordEnd;
+   uint64_t bits;              // what is left of *pWord
+   uint64_t wordBase;          // the key of bit 0 of *pWord
+   typename custom::unordered_set<T>::const_iterator itHash;
+};
+
+/*****************************************
+ * DENSE UNORDERED SET :: BEGIN / END
+ ****************************************/
+template <typename T>
+typename dense_unordered_set <T> ::iterator dense_unordered_set <T> ::begin() const
+{
+   if (!dense)
+      return iterator(sparse.begin());
+   return at(0, words.empty() ? 0 : words[0]);
+}
+
+template <typename T>
+typename dense_unordered_set <T> ::iterator dense_unordered_set <T> ::end() const
+{
+   if (!dense)
+      return iterator(sparse.end());
+   const uint64_t* pEnd = words.data() + words.size();
+   return iterator(pEnd, pEnd, 0, 0);
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: FIND
+ * Test one bit
+ *     COST   : O(1)
+ ****************************************/
+template <typename T>
+typename dense_unordered_set <T> ::iterator dense_unordered_set <T> ::find(const T& t) const
+{
+   if (!dense)
+      return iterator(sparse.find(t));
+
+   uint64_t k = key(t);
+   if (!covers(k))
+      return end();
+   size_t iWord = (size_t)((k - base) / WORD_BITS);
+   uint64_t bit = (uint64_t)1 << ((k - base) & WORD_MASK);
+   if (!(words[iWord] & bit))
+      return end();
+   return at(iWord, words[iWord] & ~(bit - 1));
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: INSERT
+ * Set t's bit, widening the bitmap if t is outside it. If widening
+ * would leave the bitmap too thin, hash everything instead
+ *     COST   : O(1) amortized, O(n) when the set goes sparse
+ ****************************************/
+template <typename T>
+custom::pair<typename dense_unordered_set <T> ::iterator, bool> dense_unordered_set <T> ::insert(const T& t)
+{
+   if (!dense)
+   {
+      auto result = sparse.insert(t);
+      typename custom::unordered_set<T>::const_iterator itHash(result.first);
+      return custom::pair<iterator, bool>(iterator(itHash), result.second);
+   }
+
+   uint64_t k = key(t);
+   if (!covers(k) && !grow(k))
+   {
+      goSparse();
+      return insert(t);
+   }
+
+   size_t iWord = (size_t)((k - base) / WORD_BITS);
+   uint64_t bit = (uint64_t)1 << ((k - base) & WORD_MASK);
+   bool inserted = !(words[iWord] & bit);
+   words[iWord] |= bit;
+   if (inserted)
+      numElements++;
+   return custom::pair<iterator, bool>(at(iWord, words[iWord] & ~(bit - 1)), inserted);
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: GROW
+ * Widen the bitmap to reach k, unless the keys would then be
+ * spread too thinly over it. Growing downward at least doubles
+ * the bitmap so that descending keys do not shift it every time
+ *     OUTPUT : false if the set should go sparse instead
+ *     COST   : O(words)
+ ****************************************/
+template <typename T>
+bool dense_unordered_set <T> ::grow(uint64_t k)
+{
+   if (words.empty())
+   {
+      base = k & ~WORD_MASK;
+      words.assign(1, 0);
+      return true;
+   }
+
+   uint64_t lo = std::min(base, k & ~WORD_MASK);
+   uint64_t hi = std::max(base + words.size() * WORD_BITS - 1, k | WORD_MASK);
+   if ((hi - lo) / WORD_BITS + 1 > maxWords(numElements + 1))
+      return false;
+
+   if (lo < base)
+   {
+      size_t numFront = (size_t)((base - lo) / WORD_BITS);
+      numFront = std::max(numFront, std::min(words.size(), (size_t)(base / WORD_BITS)));
+      words.insert(words.begin(), numFront, 0);
+      base -= numFront * WORD_BITS;
+   }
+   else
+      words.resize((size_t)((hi - base) / WORD_BITS + 1), 0);
+   return true;
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: GO SPARSE
+ * Move every key from the bitmap into the chained hash
+ *     COST   : O(n + words)
+ ****************************************/
+template <typename T>
+void dense_unordered_set <T> ::goSparse()
+{
+   for (auto it = begin(); it != end(); ++it)
+      sparse.insert(*it);
+   std::vector<uint64_t>().swap(words);
+   numElements = 0;
+   dense = false;
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: ERASE
+ * Clear t's bit. Returns the element after it
+ *     COST   : O(1), or a word scan to find the next key
+ ****************************************/
+template <typename T>
+typename dense_unordered_set <T> ::iterator dense_unordered_set <T> ::erase(const T& t)
+{
+   if (!dense)
+      return iterator(typename custom::unordered_set<T>::const_iterator(sparse.erase(t)));
+
+   uint64_t k = key(t);
+   if (!covers(k))
+      return end();
+   size_t iWord = (size_t)((k - base) / WORD_BITS);
+   uint64_t bit = (uint64_t)1 << ((k - base) & WORD_MASK);
+   if (!(words[iWord] & bit))
+      return end();
+
+   words[iWord] &= ~bit;
+   numElements--;
+   return at(iWord, words[iWord] & ~(bit - 1));
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: BUILD
+ * Fill an empty set from a range, one key at a time
+ ****************************************/
+template <typename T>
+template <class Iterator>
+void dense_unordered_set <T> ::build(Iterator first, Iterator last, std::input_iterator_tag)
+{
+   for (auto it = first; it != last; ++it)
+      insert(*it);
+}
+
+/*****************************************
+ * DENSE UNORDERED SET :: BUILD
+ * Fill an empty set from a range we can read twice. The first pass
+ * finds the span, so the bitmap is sized once or the keys go
+ * straight into the hash. The second sets bits blindly, duplicates
+ * and all, and then one popcount per word gives the size
+ *     COST   : O(n + words)
+ ****************************************/
+template <typename T>
+template <class Iterator>
+void dense_unordered_set <T> ::build(Iterator first, Iterator last, std::forward_iterator_tag)
+{
+   if (first == last)
+      return;
+
+   uint64_t lo = key(*first);
+   uint64_t hi = lo;
+   size_t num = 0;
+   for (auto it = first; it != last; ++it, num++)
+   {
+      lo = std::min(lo, key(*it));
+      hi = std::max(hi, key(*it));
+   }
+   lo &= ~WORD_MASK;
+   if ((hi - lo) / WORD_BITS + 1 > maxWords(num))
+   {
+      dense = false;
+      for (auto it = first; it != last; ++it)
+         sparse.insert(*it);
+      return;
+   }
+
+   base = lo;
+   words.assign((size_t)((hi - lo) / WORD_BITS + 1), 0);
+   for (auto it = first; it != last; ++it)
+   {
+      uint64_t offset = key(*it) - base;
+      words[(size_t)(offset / WORD_BITS)] |= (uint64_t)1 << (offset & WORD_MASK);
+   }
+   for (uint64_t word : words)
+      numElements += popcount(word);
+}
+
+} // namespace custom
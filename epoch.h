@@ -0,0 +1,212 @@
+/***********************************************************************
+ * Header:
+ *    EPOCH
+ * Summary:
+ *    Epoch-based reclamation. A reader pins the current epoch for the
+ *    length of a read and never takes a lock. A writer that unlinks a
+ *    node retires it instead of deleting it; the node is only freed once
+ *    the epoch has moved on twice, by which time every reader that could
+ *    have seen it has finished
+ *
+ *    This will contain the class definition of:
+ *        epoch_domain        : The epoch, every thread's slot, and the retired nodes
+ *        epoch_domain::guard : Pin the epoch for the length of a read
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>     // for std::atomic
+#include <cstdint>    // for uint64_t
+#include <mutex>      // for std::mutex
+#include <stdexcept>  // for std::length_error
+#include <vector>     // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * EPOCH DOMAIN
+ * One per program. Each thread claims a slot the first time it reads
+ * and gives it back when it exits
+ ************************************************/
+class epoch_domain
+{
+public:
+   static const size_t MAX_THREADS = 256;   // threads that may read at once
+   static const size_t COLLECT_EVERY = 64;  // retirements between collections
+
+   static epoch_domain& global()
+   {
+      static epoch_domain domain;
+      return domain;
+   }
+
+   // nobody can be reading any more, so free everything still waiting
+   ~epoch_domain()
+   {
+      for (auto& r : retired)
+         r.deleter(r.p);
+   }
+
+   class guard;
+
+   //
+   // Reclaim
+   //
+   void retire(void* p, void (*deleter)(void*))
+   {
+      std::lock_guard<std::mutex> lock(retireLock);
+      retired.push_back(Retired{ p, deleter, epoch.load() });
+      if (retired.size() % COLLECT_EVERY == 0)
+         collect_locked();
+   }
+   void collect()
+   {
+      std::lock_guard<std::mutex> lock(retireLock);
+      collect_locked();
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   epoch_domain() : epoch(1), numSlots(0)
+   {
+      for (auto& slot : slots)
+      {
+         slot.state = 0;
+         slot.owned = false;
+      }
+   }
+
+   // what a thread announces; padded so readers never share a cache line
+   struct Slot
+   {
+      std::atomic<uint64_t> state;   // 0 when quiescent, else the pinned epoch
+      std::atomic<bool>     owned;   // a live thread holds this slot
+      char padding[64 - sizeof(std::atomic<uint64_t>) - sizeof(std::atomic<bool>)];
+   };
+
+   struct Retired
+   {
+      void*    p;
+      void   (*deleter)(void*);
+      uint64_t epoch;               // the epoch when it was unlinked
+   };
+
+   // this thread's slot and how deeply it is pinned
+   struct Registration
+   {
+      size_t iSlot = MAX_THREADS;
+      size_t depth = 0;
+      ~Registration()
+      {
+         if (iSlot != MAX_THREADS)
+            global().slots[iSlot].owned.store(false, std::memory_order_release);
+      }
+   };
+   static Registration& registration()
+   {
+      static thread_local Registration reg;
+      return reg;
+   }
+
+   size_t claim();
+   void   collect_locked();
+
+   std::atomic<uint64_t> epoch;             // the global epoch, starts at 1
+   std::atomic<size_t>   numSlots;          // high-water mark of claimed slots
+   Slot                  slots[MAX_THREADS];
+   std::mutex            retireLock;
+   std::vector<Retired>  retired;
+};
+
+/************************************************
+ * EPOCH DOMAIN :: GUARD
+ * Nothing retired while a guard is alive will be freed
+ * until it is gone. Guards may nest
+ ************************************************/
+class epoch_domain::guard
+{
+public:
+   guard() : reg(registration())
+   {
+      if (reg.depth++ == 0)
+      {
+         epoch_domain& d = global();
+         if (reg.iSlot == MAX_THREADS)
+            reg.iSlot = d.claim();
+         d.slots[reg.iSlot].state.store(d.epoch.load());
+      }
+   }
+   ~guard()
+   {
+      if (--reg.depth == 0)
+         global().slots[reg.iSlot].state.store(0, std::memory_order_release);
+   }
+   guard(const guard&) = delete;
+   guard& operator = (const guard&) = delete;
+
+private:
+   Registration& reg;
+};
+
+/*****************************************
+ * EPOCH DOMAIN :: CLAIM
+ * Find a slot no live thread owns
+ *     COST   : O(MAX_THREADS) once per thread
+ ****************************************/
+inline size_t epoch_domain::claim()
+{
+   for (size_t i = 0; i < MAX_THREADS; i++)
+   {
+      bool expected = false;
+      if (!slots[i].owned.load() && slots[i].owned.compare_exchange_strong(expected, true))
+      {
+         size_t num = numSlots.load();
+         while (num < i + 1 && !numSlots.compare_exchange_weak(num, i + 1))
+            ;
+         return i;
+      }
+   }
+   throw std::length_error("epoch_domain: too many reading threads");
+}
+
+/*****************************************
+ * EPOCH DOMAIN :: COLLECT
+ * Move the epoch on as far as the pinned readers allow, up to
+ * twice, then free whatever was retired two or more epochs ago.
+ * With nobody reading, what was retired is freed by the first
+ * collection after it. The caller holds retireLock
+ *     COST   : O(threads + retired)
+ ****************************************/
+inline void epoch_domain::collect_locked()
+{
+   uint64_t e = epoch.load();
+   size_t num = numSlots.load();
+   for (int step = 0; step < 2; step++)
+   {
+      bool caughtUp = true;
+      for (size_t i = 0; caughtUp && i < num; i++)
+      {
+         uint64_t state = slots[i].state.load();
+         caughtUp = (state == 0 || state == e);
+      }
+      if (!caughtUp || !epoch.compare_exchange_strong(e, e + 1))
+         break;
+      e++;
+   }
+
+   size_t iKeep = 0;
+   for (size_t i = 0; i < retired.size(); i++)
+      if (retired[i].epoch + 2 <= e)
+         retired[i].deleter(retired[i].p);
+      else
+         retired[iKeep++] = retired[i];
+   retired.resize(iKeep);
+}
+
+} // namespace custom
@@ -0,0 +1,209 @@
+/***********************************************************************
+ * Header:
+ *    EPOCH HASH
+ * Summary:
+ *    A hash for read-mostly tables. Lookups take no locks at all: they
+ *    walk the bucket chains under an epoch guard. Writers take a lock
+ *    for their one bucket, publish new links with release stores, and
+ *    retire what they unlink to the epoch domain rather than freeing it
+ *
+ *    This will contain the class definition of:
+ *        concurrent_unordered_set : A hash with a lock-free read path
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "epoch.h"    // for epoch_domain
+#include <atomic>     // for std::atomic
+#include <mutex>      // for std::mutex
+
+namespace custom
+{
+
+/************************************************
+ * CONCURRENT UNORDERED SET
+ * Any number of threads may call contains(), insert() and erase()
+ * at once. Writers to different buckets never wait on each other;
+ * readers never wait on anybody
+ ************************************************/
+template <typename T>
+class concurrent_unordered_set
+{
+public:
+   //
+   // Construct
+   //
+   concurrent_unordered_set() : numElements(0)
+   {
+      for (auto& bucket : buckets)
+         bucket.pHead = nullptr;
+   }
+   concurrent_unordered_set(const concurrent_unordered_set&) = delete;
+   concurrent_unordered_set& operator = (const concurrent_unordered_set&) = delete;
+   ~concurrent_unordered_set();
+
+   //
+   // Hash
+   //
+   size_t bucket_count() const { return NUM_BUCKETS; }
+   size_t bucket(const T& t) const { return t % bucket_count(); }
+
+   //
+   // Access - no locks
+   //
+   bool contains(const T& t) const;
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   bool insert(const T& t);
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t);
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size()  const { return numElements.load(std::memory_order_relaxed); }
+   bool   empty() const { return size() == 0; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const size_t NUM_BUCKETS = 10;
+
+   struct Node
+   {
+      Node(const T& data, Node* pNext) : data(data), pNext(pNext) {}
+      T data;
+      std::atomic<Node*> pNext;
+   };
+
+   // the head the readers look at lives on a different cache line
+   // from the lock the writers take
+   struct Bucket
+   {
+      std::atomic<Node*> pHead;
+      char padding[64 - sizeof(std::atomic<Node*>)];
+      std::mutex writeLock;
+   };
+
+   static void deleteNode(void* p)  { delete static_cast<Node*>(p); }
+   static void deleteChain(void* p)
+   {
+      Node* pNode = static_cast<Node*>(p);
+      while (pNode)
+      {
+         Node* pNext = pNode->pNext.load(std::memory_order_relaxed);
+         delete pNode;
+         pNode = pNext;
+      }
+   }
+
+   Bucket buckets[NUM_BUCKETS];
+   std::atomic<size_t> numElements;
+};
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: DESTRUCTOR
+ * Nobody may be reading any more, so the chains go straight away
+ ****************************************/
+template <typename T>
+concurrent_unordered_set <T> ::~concurrent_unordered_set()
+{
+   for (auto& bucket : buckets)
+      deleteChain(bucket.pHead.load(std::memory_order_relaxed));
+}
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: CONTAINS
+ * Walk the one chain t could be on. The acquire loads pair with the
+ * writers' release stores, so every node we reach is fully built
+ *     COST   : O(n) with respect to the bucket, no locks
+ ****************************************/
+template <typename T>
+bool concurrent_unordered_set <T> ::contains(const T& t) const
+{
+   epoch_domain::guard guard;
+   for (Node* p = buckets[bucket(t)].pHead.load(std::memory_order_acquire);
+        p;
+        p = p->pNext.load(std::memory_order_acquire))
+      if (p->data == t)
+         return true;
+   return false;
+}
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: INSERT
+ * Build the node, then publish it at the head of the chain
+ *     COST   : O(n) with respect to the bucket
+ ****************************************/
+template <typename T>
+bool concurrent_unordered_set <T> ::insert(const T& t)
+{
+   Bucket& b = buckets[bucket(t)];
+   std::lock_guard<std::mutex> lock(b.writeLock);
+   Node* pHead = b.pHead.load(std::memory_order_relaxed);
+   for (Node* p = pHead; p; p = p->pNext.load(std::memory_order_relaxed))
+      if (p->data == t)
+         return false;
+
+   b.pHead.store(new Node(t, pHead), std::memory_order_release);
+   numElements.fetch_add(1, std::memory_order_relaxed);
+   return true;
+}
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: ERASE
+ * Link around the node. A reader already standing on it can still
+ * follow its pNext, so it is retired rather than freed
+ *     COST   : O(n) with respect to the bucket
+ ****************************************/
+template <typename T>
+size_t concurrent_unordered_set <T> ::erase(const T& t)
+{
+   Bucket& b = buckets[bucket(t)];
+   std::lock_guard<std::mutex> lock(b.writeLock);
+   std::atomic<Node*>* pLink = &b.pHead;
+   for (Node* p = pLink->load(std::memory_order_relaxed); p; p = pLink->load(std::memory_order_relaxed))
+   {
+      if (p->data == t)
+      {
+         pLink->store(p->pNext.load(std::memory_order_relaxed), std::memory_order_release);
+         numElements.fetch_sub(1, std::memory_order_relaxed);
+         epoch_domain::global().retire(p, &deleteNode);
+         return 1;
+      }
+      pLink = &p->pNext;
+   }
+   return 0;
+}
+
+/*****************************************
+ * CONCURRENT UNORDERED SET :: CLEAR
+ * Cut each chain off whole and retire it in one piece
+ *     COST   : O(bucket_count())
+ ****************************************/
+template <typename T>
+void concurrent_unordered_set <T> ::clear()
+{
+   for (auto& b : buckets)
+   {
+      std::lock_guard<std::mutex> lock(b.writeLock);
+      Node* pChain = b.pHead.exchange(nullptr, std::memory_order_acq_rel);
+      for (Node* p = pChain; p; p = p->pNext.load(std::memory_order_relaxed))
+         numElements.fetch_sub(1, std::memory_order_relaxed);
+      if (pChain)
+         epoch_domain::global().retire(pChain, &deleteChain);
+   }
+}
+
+} // namespace custom
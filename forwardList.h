@@ -0,0 +1,537 @@
+/***********************************************************************
+ * Header:
+ *    FORWARD LIST
+ * Summary:
+ *    A singly linked list. Each node carries one link, to the next,
+ *    and the list itself is only the pointer to the first node: no
+ *    pTail and no count. That is half the link overhead of list per
+ *    element and a third of its size per list, which is what counts
+ *    for short chains such as hash buckets that are only ever walked
+ *    forward.
+ *
+ *    With no way back, everything that changes the list works on the
+ *    element after an iterator: insert_after, erase_after and
+ *    splice_after. before_begin() is the place before the first
+ *    element, so the front can be changed the same way as the middle
+ *
+ *    This will contain the class definition of:
+ *        forward_list                 : A singly linked list
+ *        forward_list::iterator       : An iterator through the list
+ *        forward_list::const_iterator : The same, read only
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include "nodePool.h"       // for node_pool, where the nodes come from
+#include <cassert>          // for assert
+#include <cstddef>          // for size_t
+#include <exception>        // for std::exception_ptr
+#include <functional>       // for std::less
+#include <initializer_list> // for std::initializer_list
+#include <type_traits>      // for std::enable_if and std::is_integral
+#include <utility>          // for std::swap and std::move
+
+namespace custom
+{
+    /**************************************************
+     * FORWARD LIST
+     * A chain of nodes linked through pNext alone
+     **************************************************/
+    template <typename T>
+    class forward_list
+    {
+    public:
+        //
+        // Construct
+        //
+
+        forward_list() { head.pNext = nullptr; }
+        forward_list(size_t num, const T& t) : forward_list()
+        {
+            iterator it = before_begin();
+            for (size_t i = 0; i < num; i++)
+                it = insert_after(it, t);
+        }
+        forward_list(const forward_list& rhs) : forward_list()
+        {
+            insert_after(before_begin(), rhs.begin(), rhs.end());
+        }
+        forward_list(forward_list&& rhs) : forward_list()
+        {
+            swap(rhs);
+        }
+        forward_list(const std::initializer_list<T>& il) : forward_list()
+        {
+            insert_after(before_begin(), il.begin(), il.end());
+        }
+        template <class Iterator, class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        forward_list(Iterator first, Iterator last) : forward_list()
+        {
+            insert_after(before_begin(), first, last);
+        }
+        ~forward_list() { clear(); }
+
+        //
+        // Assign
+        //
+
+        forward_list& operator = (const forward_list& rhs)
+        {
+            if (this != &rhs)
+            {
+                forward_list copy(rhs);
+                swap(copy);
+            }
+            return *this;
+        }
+        forward_list& operator = (forward_list&& rhs)
+        {
+            clear();
+            swap(rhs);
+            return *this;
+        }
+        forward_list& operator = (const std::initializer_list<T>& il)
+        {
+            forward_list copy(il);
+            swap(copy);
+            return *this;
+        }
+        void swap(forward_list& rhs) { std::swap(head.pNext, rhs.head.pNext); }
+
+        //
+        // Iterator
+        //
+
+        class iterator;
+        class const_iterator;
+        iterator before_begin() { return iterator(&head); }
+        iterator begin()        { return iterator(head.pNext); }
+        iterator end()          { return iterator(nullptr); }
+
+        const_iterator before_begin() const { return const_iterator(&head); }
+        const_iterator begin()        const { return const_iterator(head.pNext); }
+        const_iterator end()          const { return const_iterator(nullptr); }
+        const_iterator cbefore_begin() const { return before_begin(); }
+        const_iterator cbegin()        const { return begin(); }
+        const_iterator cend()          const { return end(); }
+
+        //
+        // Access
+        //
+
+        T& front()             { return dataOf(head.pNext); }
+        const T& front() const { return dataOf(head.pNext); }
+        iterator find(const T& t);
+        iterator find_before(const T& t);
+
+        //
+        // Insert
+        //
+
+        void push_front(const T& t) { insert_after(before_begin(), t); }
+        void push_front(T&& t)      { insert_after(before_begin(), std::move(t)); }
+        iterator insert_after(iterator it, const T& t) { return linkAfter(it.p, new Node(t)); }
+        iterator insert_after(iterator it, T&& t)      { return linkAfter(it.p, new Node(std::move(t))); }
+        template <class Iterator, class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        iterator insert_after(iterator it, Iterator first, Iterator last);
+        void splice_after(iterator it, forward_list& rhs);
+        void splice_after(iterator it, forward_list& rhs, iterator itBefore);
+
+        //
+        // Remove
+        //
+
+        void pop_front() { erase_after(before_begin()); }
+        iterator erase_after(iterator it);
+        iterator erase_after(iterator itFirst, iterator itLast);
+        void clear() { erase_after(before_begin(), end()); }
+
+        //
+        // Reorder
+        //
+
+        void sort() { sort(std::less<T>()); }
+        template <class Compare>
+        void sort(Compare comp);
+
+        //
+        // Status - there is no size(): keeping a count would put a
+        // second word in every list, and every bucket
+        //
+
+        bool empty() const { return head.pNext == nullptr; }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        // just the link, so that the list's head can stand in for
+        // the node before the first
+        struct Link
+        {
+            Link* pNext;
+        };
+        struct Node : public Link
+        {
+            Node(const T& data) : data(data) { this->pNext = nullptr; }
+            Node(T&& data) : data(std::move(data)) { this->pNext = nullptr; }
+            T data;
+
+            // nodes come from node_pool, as list's do. Besides the
+            // speed, a node the heap handed out one at a time would
+            // carry the heap's own header, which is as big as the link
+            // we saved
+            static void* operator new (size_t size)
+            {
+                assert(size == sizeof(Node));
+                return node_pool<Node>::allocate();
+            }
+            static void  operator delete (void* p) noexcept { node_pool<Node>::deallocate(p); }
+        };
+
+        static T& dataOf(Link* p) { return static_cast<Node*>(p)->data; }
+        static const T& dataOf(const Link* p) { return static_cast<const Node*>(p)->data; }
+        static iterator linkAfter(Link* pPrev, Node* pNew);
+        template <class Compare>
+        static void merge_chains(Link*& pLeft, Link* pRight, Compare& comp);
+
+        Link head;   // head.pNext is the first node
+    };
+
+    /*************************************************
+     * FORWARD LIST ITERATOR
+     * A link: either a node, or the list's head for before_begin
+     *************************************************/
+    template <typename T>
+    class forward_list <T> ::iterator
+    {
+    public:
+        iterator() : p(nullptr) {}
+        explicit iterator(Link* p) : p(p) {}
+
+        bool operator != (const iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const iterator& rhs) const { return rhs.p == p; }
+
+        T& operator * () { return dataOf(p); }
+
+        iterator& operator ++ ()
+        {
+            p = p->pNext;
+            return *this;
+        }
+        iterator operator ++ (int postfix)
+        {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        friend class forward_list <T>;
+        friend class forward_list <T> ::const_iterator;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        Link* p;   // null at the end
+    };
+
+    /*************************************************
+     * FORWARD LIST CONST ITERATOR
+     * Iterate through a forward list without changing it
+     ************************************************/
+    template <typename T>
+    class forward_list <T> ::const_iterator
+    {
+    public:
+        const_iterator() : p(nullptr) {}
+        explicit const_iterator(const Link* p) : p(p) {}
+        const_iterator(const iterator& rhs) : p(rhs.p) {}
+
+        bool operator != (const const_iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const const_iterator& rhs) const { return rhs.p == p; }
+
+        const T& operator * () const { return dataOf(p); }
+
+        const_iterator& operator ++ ()
+        {
+            p = p->pNext;
+            return *this;
+        }
+        const_iterator operator ++ (int postfix)
+        {
+            const_iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        friend class forward_list <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        const Link* p;
+    };
+
+    /*****************************************
+     * FORWARD LIST :: FIND
+     * The first element equal to t
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T>
+    typename forward_list <T> ::iterator forward_list <T> ::find(const T& t)
+    {
+        iterator it = find_before(t);
+        return it == end() ? it : ++it;
+    }
+
+    /*****************************************
+     * FORWARD LIST :: FIND BEFORE
+     * The place before the first element equal to t, which is what
+     * erase_after needs to take it out
+     *     OUTPUT : before_begin() if t is first, end() if it is missing
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T>
+    typename forward_list <T> ::iterator forward_list <T> ::find_before(const T& t)
+    {
+        for (Link* p = &head; p->pNext; p = p->pNext)
+            if (dataOf(p->pNext) == t)
+                return iterator(p);
+        return end();
+    }
+
+    /*****************************************
+     * FORWARD LIST :: LINK AFTER
+     * Hang a new node after pPrev
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T>
+    typename forward_list <T> ::iterator forward_list <T> ::linkAfter(Link* pPrev, Node* pNew)
+    {
+        pNew->pNext = pPrev->pNext;
+        pPrev->pNext = pNew;
+        return iterator(pNew);
+    }
+
+    /*****************************************
+     * FORWARD LIST :: INSERT AFTER a range
+     * Copy a range in after it, in order. The chain is built off to
+     * the side first, so a copy that throws leaves the list as it was
+     *     OUTPUT : the last element inserted, or it if there were none
+     *     COST   : O(n) with respect to the range
+     ****************************************/
+    template <typename T>
+    template <class Iterator, class>
+    typename forward_list <T> ::iterator forward_list <T> ::insert_after(iterator it, Iterator first, Iterator last)
+    {
+        Link chain;
+        chain.pNext = nullptr;
+        Link* pLast = &chain;
+        try
+        {
+            for (; first != last; ++first)
+                pLast = pLast->pNext = new Node(*first);
+        }
+        catch (...)
+        {
+            while (chain.pNext)
+            {
+                Link* p = chain.pNext;
+                chain.pNext = p->pNext;
+                delete static_cast<Node*>(p);
+            }
+            throw;
+        }
+        if (pLast == &chain)
+            return it;
+
+        pLast->pNext = it.p->pNext;
+        it.p->pNext = chain.pNext;
+        return iterator(pLast);
+    }
+
+    /*****************************************
+     * FORWARD LIST :: SPLICE AFTER
+     * Move every node of rhs in after it, or just the one after
+     * itBefore. Nothing is copied or allocated
+     *     COST   : O(m) for a whole list, to find its last node,
+     *              O(1) for one
+     ****************************************/
+    template <typename T>
+    void forward_list <T> ::splice_after(iterator it, forward_list& rhs)
+    {
+        if (&rhs == this || rhs.empty())
+            return;
+
+        Link* pLast = rhs.head.pNext;
+        while (pLast->pNext)
+            pLast = pLast->pNext;
+        pLast->pNext = it.p->pNext;
+        it.p->pNext = rhs.head.pNext;
+        rhs.head.pNext = nullptr;
+    }
+
+    template <typename T>
+    void forward_list <T> ::splice_after(iterator it, forward_list&, iterator itBefore)
+    {
+        Link* p = itBefore.p->pNext;
+        if (p == nullptr || it.p == itBefore.p || it.p == p)
+            return;
+
+        itBefore.p->pNext = p->pNext;
+        p->pNext = it.p->pNext;
+        it.p->pNext = p;
+    }
+
+    /*****************************************
+     * FORWARD LIST :: ERASE AFTER
+     * Take out the element after it, or everything strictly between
+     * itFirst and itLast
+     *     OUTPUT : the element after the last one erased
+     *     COST   : O(1) for one, O(n) for a range
+     ****************************************/
+    template <typename T>
+    typename forward_list <T> ::iterator forward_list <T> ::erase_after(iterator it)
+    {
+        Link* p = it.p->pNext;
+        if (p == nullptr)
+            return end();
+        it.p->pNext = p->pNext;
+        delete static_cast<Node*>(p);
+        return iterator(it.p->pNext);
+    }
+
+    template <typename T>
+    typename forward_list <T> ::iterator forward_list <T> ::erase_after(iterator itFirst, iterator itLast)
+    {
+        Link* p = itFirst.p->pNext;
+        itFirst.p->pNext = itLast.p;
+        while (p != itLast.p)
+        {
+            Link* pNext = p->pNext;
+            delete static_cast<Node*>(p);
+            p = pNext;
+        }
+        return itLast;
+    }
+
+    /******************************************
+     * FORWARD LIST :: SORT
+     * the same stable bottom-up merge sort as list::sort: nodes come
+     * off the front one at a time and carry up bins[i], each holding
+     * a sorted run of 2^i nodes, like a binary counter. With only
+     * pNext there is no second pass to put the back links right.
+     * Should comp throw, the nodes are chained back up in no
+     * particular order, so none is lost
+     *     INPUT  : comp(a, b) is true when a goes before b
+     *     COST   : O(n log n), and no allocation at all
+     ******************************************/
+    template <typename T>
+    template <class Compare>
+    void forward_list <T> ::sort(Compare comp)
+    {
+        if (head.pNext == nullptr || head.pNext->pNext == nullptr)
+            return;
+
+        Link* bins[64] = {};   // enough for 2^64 nodes
+        Link* p = head.pNext;
+        std::exception_ptr error;
+        try
+        {
+            while (p)
+            {
+                Link* pRun = p;
+                p = p->pNext;
+                pRun->pNext = nullptr;
+
+                // the bins hold older nodes, so they go on the left
+                size_t i = 0;
+                for (; bins[i]; i++)
+                {
+                    merge_chains(bins[i], pRun, comp);
+                    pRun = bins[i];
+                    bins[i] = nullptr;
+                }
+                bins[i] = pRun;
+            }
+
+            // the higher the bin, the older its nodes
+            for (size_t i = 0; i + 1 < 64; i++)
+            {
+                Link* pRun = bins[i];
+                bins[i] = nullptr;
+                if (pRun)
+                    merge_chains(bins[i + 1], pRun, comp);
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        // gather what is left, which is only bins[63] unless comp threw
+        head.pNext = p;
+        for (Link* pBin : bins)
+            if (pBin)
+            {
+                Link* pLast = pBin;
+                while (pLast->pNext)
+                    pLast = pLast->pNext;
+                pLast->pNext = head.pNext;
+                head.pNext = pBin;
+            }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /******************************************
+     * FORWARD LIST :: MERGE CHAINS
+     * merge the sorted chain pRight into the sorted chain pLeft.
+     * Left wins a tie, which is what makes sort stable. If comp
+     * throws, what is left of both is hung off the end as it
+     * stands, so pLeft still holds every node
+     ******************************************/
+    template <typename T>
+    template <class Compare>
+    void forward_list <T> ::merge_chains(Link*& pLeft, Link* pRight, Compare& comp)
+    {
+        Link first;
+        Link* pLast = &first;
+        Link* pL = pLeft;
+        try
+        {
+            while (pL && pRight)
+            {
+                if (comp(dataOf(pRight), dataOf(pL)))
+                {
+                    pLast->pNext = pRight;
+                    pRight = pRight->pNext;
+                }
+                else
+                {
+                    pLast->pNext = pL;
+                    pL = pL->pNext;
+                }
+                pLast = pLast->pNext;
+            }
+        }
+        catch (...)
+        {
+            pLast->pNext = pL;
+            while (pLast->pNext)
+                pLast = pLast->pNext;
+            pLast->pNext = pRight;
+            pLeft = first.pNext;
+            throw;
+        }
+        pLast->pNext = pL ? pL : pRight;
+        pLeft = first.pNext;
+    }
+
+} // namespace custom
@@ -13,6 +13,14 @@
  *    This will contain the class definition of:
  *        unordered_set           : A class that represents a hash
  *        unordered_set::iterator : An interator through hash
+ *        unordered_set::const_iterator : An iterator that cannot change the hash
+ *        bucket_index            : The elements of one bucket, by value
+ *    and the functions:
+ *        parallel_for_each       : Visit every element on all the cores
+ *        parallel_reduce         : Fold every element on all the cores
+ *        erase_if                : Remove everything a predicate picks
+ *        set_union, set_intersection, set_difference, is_subset
+ *                                : Set algebra, bucket against bucket
  * Author
  *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell 
  ************************************************************************/
@@ -20,12 +28,46 @@
 #pragma once
 
 #include "list.h"     // because this->buckets[0] is a list
+#include "pair.h"     // because insert() returns a pair
+#include "parallel.h" // for bucket_range and parallel_for
 #include <memory>     // for std::allocator
 #include <functional> // for std::hash
 #include <cmath>      // for std::ceil
+#include <exception>  // for std::exception_ptr
+#include <thread>     // for std::thread
+#include <type_traits> // for std::is_same
+#include <vector>     // for std::vector
    
 namespace custom
 {
+/************************************************
+ * BUCKET INDEX
+ * Where the elements of a bucket are, by value, so one bucket of
+ * k can be checked against itself or another in O(k) rather than
+ * O(k^2). Like the hash, it needs nothing of T but % and ==. The
+ * elements of a bucket all leave the same remainder by the hash's
+ * bucket count, so the index's size shares no factor with it
+ ************************************************/
+template <typename T>
+class bucket_index
+{
+public:
+   bucket_index(size_t num, size_t numBuckets);
+
+   // false, and nothing added, if an equal element is already here
+   bool insert(const T* p);
+   bool contains(const T& t) const;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   size_t home(const T& t) const { return (size_t)(t % slots.size()); }
+
+   std::vector<const T*> slots;   // open addressing, at most half full
+};
+
 /************************************************
  * UNORDERED SET
  * A set implemented as a hash
@@ -41,34 +83,38 @@ public:
    {
        numElements = 0;
        maxLoadFactor = 1.0;
-       
+       findPolicy = find_policy::stay;
    }
-   unordered_set(unordered_set&  rhs) 
+   unordered_set(const unordered_set& rhs) 
    {
-       *this = rhs;
+       numElements = 0;
+       maxLoadFactor = rhs.maxLoadFactor;
+       findPolicy = rhs.findPolicy;
+       clone(rhs);
    }
    unordered_set(unordered_set&& rhs) 
    {
+       findPolicy = rhs.findPolicy;
        *this = std::move(rhs);
    }
+   // a random-access range is built on numThreads threads (0 means
+   // one per core)
    template <class Iterator>
-   unordered_set(Iterator first, Iterator last)
+   unordered_set(Iterator first, Iterator last, size_t numThreads = 0)
    {
        numElements = 0;
-       auto it = first;
-       while (it != last)
-       {
-           insert(*it);
-           it++;
-       }
+       maxLoadFactor = 1.0;
+       findPolicy = find_policy::stay;
+       build(first, last, numThreads, is_random_access_iterator<Iterator>());
    }
 
    //
    // Assign - Alex
    //
-   unordered_set& operator = (unordered_set& rhs) 
+   unordered_set& operator = (const unordered_set& rhs) 
    {
       numElements = rhs.numElements; 
+      findPolicy = rhs.findPolicy;
       for (int i = 0; i < bucket_count(); i++)
          buckets[i] = rhs.buckets[i];
       
@@ -77,6 +123,7 @@ public:
    unordered_set& operator = (unordered_set&& rhs)
    {
        numElements = std::move(rhs.numElements);
+       findPolicy = rhs.findPolicy;
        rhs.numElements = NULL;
        for (int i = 0; i < bucket_count(); i++)
        {
@@ -98,6 +145,7 @@ public:
    {
        std::swap(this->numElements, rhs.numElements);
        std::swap(this->buckets, rhs.buckets);
+       std::swap(this->findPolicy, rhs.findPolicy);
    }
 
    // 
@@ -113,7 +161,9 @@ public:
    // Iterator
    //
    class iterator;
+   class const_iterator;
    class local_iterator;
+   class const_local_iterator;
    iterator begin()
    {
        if (size() == 0)
@@ -148,16 +198,52 @@ public:
        //return local_iterator(nullptr);
        return buckets[iBucket].end();
    }
+   const_iterator begin() const
+   {
+      for (size_t i = 0; i < bucket_count(); i++)
+         if (!buckets[i].empty())
+            return const_iterator(buckets + i, buckets + bucket_count(), buckets[i].begin());
+      return end();
+   }
+   const_iterator end() const
+   {
+      return const_iterator(buckets + bucket_count(), buckets + bucket_count(), buckets[0].end());
+   }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+   const_local_iterator begin(size_t iBucket) const { return buckets[iBucket].begin(); }
+   const_local_iterator end(size_t iBucket)   const { return buckets[iBucket].end();   }
+
+   // every bucket, as a range the parallel algorithms can split
+   bucket_range<custom::list<T>> range(size_t grain = 1)
+   {
+      return bucket_range<custom::list<T>>(buckets, buckets + bucket_count(), grain);
+   }
+   bucket_range<const custom::list<T>> range(size_t grain = 1) const
+   {
+      return bucket_range<const custom::list<T>>(buckets, buckets + bucket_count(), grain);
+   }
 
    //
    // Access - Jon
    //
-   size_t bucket(const T& t)
+   size_t bucket(const T& t) const
    {
         //auto cheese = bucket_count();
         return hash(t) % bucket_count();
    }
+   // find() moves a hit toward the front of its bucket if the policy
+   // says so. The const find() and contains() leave the buckets alone
    iterator find(const T& t);
+   const_iterator find(const T& t) const;
+   void set_find_policy(find_policy policy) { findPolicy = policy; }
+   find_policy get_find_policy() const      { return findPolicy; }
+   bool contains(const T& t) const
+   {
+      const custom::list<T>& bucket = buckets[this->bucket(t)];
+      return bucket.find(t) != bucket.end();
+   }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
 
    //   
    // Insert - Steve
@@ -169,12 +255,17 @@ public:
    // 
    // Remove - Steve
    //
+   // each bucket hands its nodes back to the pool in one step when
+   // T needs no destructor, so this is O(bucket_count())
    void clear() noexcept { 
        for (auto& bucket : buckets)
             bucket.clear();
        numElements = 0; 
    }
    iterator erase(const T& t);
+   iterator erase(const const_iterator& first, const const_iterator& last);
+   template <typename U, class Predicate>
+   friend size_t erase_if(unordered_set<U>& s, Predicate pred);
 
    //
    // Status
@@ -190,15 +281,44 @@ public:
       return buckets[i].size(); // Steve, guessing here, but brought % up -- Nice guess bro
    }
 
+   //
+   // Set algebra - every set has the same buckets and hash, so bucket i
+   // of one set can only ever match bucket i of another
+   //
+   template <typename U>
+   friend unordered_set<U> set_union(const unordered_set<U>& lhs, const unordered_set<U>& rhs);
+   template <typename U>
+   friend unordered_set<U> set_intersection(const unordered_set<U>& lhs, const unordered_set<U>& rhs);
+   template <typename U>
+   friend unordered_set<U> set_difference(const unordered_set<U>& lhs, const unordered_set<U>& rhs);
+   template <typename U>
+   friend bool is_subset(const unordered_set<U>& lhs, const unordered_set<U>& rhs);
+
+   // folds its shards together by relinking buckets
+   template <typename U>
+   friend class sharded_unordered_set;
 
 #ifdef DEBUG // make this visible to the unit tests
 public:
 #else
 private:
 #endif
+   // below this many elements per thread, a bulk build is not worth the
+   // threads; below this many in all, neither is the set algebra
+   static const size_t PARALLEL_GRAIN = 4096;
+
+   template <class Iterator>
+   void build(Iterator first, Iterator last, size_t, std::false_type);
+   template <class Iterator>
+   void build(Iterator first, Iterator last, size_t numThreads, std::true_type);
+   void clone(const unordered_set& rhs);
+   template <class Merge>
+   static void zip(const unordered_set& lhs, const unordered_set& rhs, unordered_set& out, Merge merge);
+
    float maxLoadFactor;            // numElements / bucket_count()
    custom::list<T> buckets [10];   // exactly 10 buckets
    int numElements;                // number of elements in the Hash
+   find_policy findPolicy;         // what find() does with a hit
 };
 
 
@@ -259,6 +379,10 @@ public:
        return it;
    }
 
+   // the hash unlinks through pBucket and itList
+   friend class unordered_set <T>;
+   friend class unordered_set <T> ::const_iterator;
+
 #ifdef DEBUG // make this visible to the unit tests
 public:
 #else
@@ -283,7 +407,7 @@ public:
    //
    local_iterator() { itList = nullptr; }
    local_iterator(const typename custom::list<T>::iterator& itList) { this->itList = itList; }
-   local_iterator(const local_iterator& rhs) { this = rhs; } 
+   local_iterator(const local_iterator& rhs) { *this = rhs; } 
 
    //
    // Assign
@@ -313,7 +437,7 @@ public:
    //
    local_iterator& operator ++ ()
    {
-       itList++;
+       ++itList;
        return *this;
    }
    local_iterator operator ++ (int postfix)
@@ -323,6 +447,8 @@ public:
        return it;
    }
 
+   friend class unordered_set <T> ::const_local_iterator;
+
 #ifdef DEBUG // make this visible to the unit tests
 public:
 #else
@@ -332,6 +458,173 @@ private:
 };
 
 
+/************************************************
+ * UNORDERED SET CONST ITERATOR
+ * Iterator for an unordered set that cannot change it
+ ************************************************/
+template <typename T>
+class unordered_set <T> ::const_iterator
+{
+public:
+   // 
+   // Construct
+   //
+   const_iterator() : pBucket(nullptr), pBucketEnd(nullptr), itList(nullptr) {}
+   const_iterator(const custom::list<T>* pBucket,
+                  const custom::list<T>* pBucketEnd,
+                  typename custom::list<T>::const_iterator itList)
+      : pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList) {}
+   const_iterator(const iterator& rhs)
+      : pBucket(rhs.pBucket), pBucketEnd(rhs.pBucketEnd), itList(rhs.itList) {}
+   const_iterator(const const_iterator& rhs) { *this = rhs; }
+
+   //
+   // Assign
+   //
+   const_iterator& operator = (const const_iterator& rhs)
+   {
+      this->itList     = rhs.itList;
+      this->pBucket    = rhs.pBucket;
+      this->pBucketEnd = rhs.pBucketEnd;
+      return *this;
+   }
+
+   //
+   // Compare
+   //
+   bool operator != (const const_iterator& rhs) const { return rhs.itList != itList; }
+   bool operator == (const const_iterator& rhs) const { return rhs.itList == itList; }
+
+   // 
+   // Access
+   //
+   const T& operator * () const { return *itList; }
+
+   //
+   // Arithmetic
+   //
+   const_iterator& operator ++ ();
+   const_iterator operator ++ (int postfix)
+   {
+      auto it = *this;
+      ++(*this);
+      return it;
+   }
+
+   // the hash unlinks through pBucket and itList
+   friend class unordered_set <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const custom::list<T> *pBucket;
+   const custom::list<T> *pBucketEnd;
+   typename list<T>::const_iterator itList;
+};
+
+
+/************************************************
+ * UNORDERED SET CONST LOCAL ITERATOR
+ * Iterator for a single bucket that cannot change it
+ ************************************************/
+template <typename T>
+class unordered_set <T> ::const_local_iterator
+{
+public:
+   // 
+   // Construct
+   //
+   const_local_iterator() : itList(nullptr) {}
+   const_local_iterator(const typename custom::list<T>::const_iterator& itList) : itList(itList) {}
+   const_local_iterator(const local_iterator& rhs) : itList(rhs.itList) {}
+
+   // 
+   // Compare
+   //
+   bool operator != (const const_local_iterator& rhs) const { return rhs.itList != itList; }
+   bool operator == (const const_local_iterator& rhs) const { return rhs.itList == itList; }
+
+   // 
+   // Access
+   //
+   const T& operator * () const { return *itList; }
+
+   // 
+   // Arithmetic
+   //
+   const_local_iterator& operator ++ ()
+   {
+      ++itList;
+      return *this;
+   }
+   const_local_iterator operator ++ (int postfix)
+   {
+      auto it = *this;
+      ++(*this);
+      return it;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   typename list<T>::const_iterator itList;
+};
+
+
+/*****************************************
+ * BUCKET INDEX :: CONSTRUCTOR
+ * Room for num elements: more than twice as many slots, and
+ * a count coprime to numBuckets
+ ****************************************/
+template <typename T>
+bucket_index<T>::bucket_index(size_t num, size_t numBuckets)
+{
+   size_t size = 2 * num + 1;
+   for (;; size++)
+   {
+      size_t a = size;
+      size_t b = numBuckets;
+      while (b)
+      {
+         size_t r = a % b;
+         a = b;
+         b = r;
+      }
+      if (a == 1)
+         break;
+   }
+   slots.assign(size, nullptr);
+}
+
+/*****************************************
+ * BUCKET INDEX :: INSERT and CONTAINS
+ * Linear probing from the element's home slot
+ *     COST   : O(1) expected
+ ****************************************/
+template <typename T>
+bool bucket_index<T>::insert(const T* p)
+{
+   size_t slot = home(*p);
+   for (; slots[slot]; slot = (slot + 1) % slots.size())
+      if (*slots[slot] == *p)
+         return false;
+   slots[slot] = p;
+   return true;
+}
+
+template <typename T>
+bool bucket_index<T>::contains(const T& t) const
+{
+   for (size_t slot = home(t); slots[slot]; slot = (slot + 1) % slots.size())
+      if (*slots[slot] == t)
+         return true;
+   return false;
+}
+
 /*****************************************
  * UNORDERED SET :: ERASE
  * Remove one element from the unordered set
@@ -368,6 +661,46 @@ typename unordered_set <T> ::iterator unordered_set<T>::erase(const T& t)
     return itReturn; 
 }
 
+/*****************************************
+ * UNORDERED SET :: ERASE
+ * Remove the elements [first, last). Whole runs of each bucket are
+ * unlinked at once and the count is updated once at the end
+ ****************************************/
+template <typename T>
+typename unordered_set <T> ::iterator unordered_set<T>::erase(const const_iterator& first,
+                                                              const const_iterator& last)
+{
+    // we own the buckets, so we may change them
+    custom::list<T>* pBucket = const_cast<custom::list<T>*>(first.pBucket);
+    custom::list<T>* pBucketEnd = buckets + bucket_count();
+    typename custom::list<T>::const_iterator itList = first.itList;
+    iterator itReturn = end();
+    size_t num = 0;
+
+    // everything from here to the end of each bucket before last's
+    for (; pBucket != last.pBucket && pBucket != pBucketEnd; ++pBucket)
+    {
+        if (pBucket != first.pBucket)
+            itList = pBucket->begin();
+        size_t sizeOld = pBucket->size();
+        pBucket->erase(itList, pBucket->end());
+        num += sizeOld - pBucket->size();
+    }
+
+    // the front of last's bucket
+    if (pBucket != pBucketEnd)
+    {
+        if (pBucket != first.pBucket)
+            itList = pBucket->begin();
+        size_t sizeOld = pBucket->size();
+        itReturn = iterator(pBucket, pBucketEnd, pBucket->erase(itList, last.itList));
+        num += sizeOld - pBucket->size();
+    }
+
+    numElements -= (int)num;
+    return itReturn;
+}
+
 /*****************************************
  * UNORDERED SET :: INSERT
  * Insert one element into the hash
@@ -427,9 +760,205 @@ void unordered_set<T>::insert(const std::initializer_list<T> & il)
     //swap(bucketNew);
 }
 
+/*****************************************
+ * UNORDERED SET :: BUILD
+ * Fill an empty hash from a range, one element at a time. Any
+ * iterator that is not random access comes here, even one
+ * with no iterator_traits
+ ****************************************/
+template <typename T>
+template <class Iterator>
+void unordered_set<T>::build(Iterator first, Iterator last, size_t, std::false_type)
+{
+    for (auto it = first; it != last; ++it)
+        insert(*it);
+}
+
+/*****************************************
+ * UNORDERED SET :: BUILD
+ * Fill an empty hash from a random-access range in parallel.
+ *   1. Each thread takes a slice of the range and partitions its
+ *      keys by bucket into lists of its own
+ *   2. Each thread then owns a subset of the buckets, splices the
+ *      partitions for those buckets together in slice order, and
+ *      drops the duplicates, remembering what it has kept in a
+ *      bucket_index so a bucket of k is O(k), not O(k^2)
+ * No two threads ever touch the same list, so there are no locks, and
+ * every bucket ends up in the same order a serial insert would give.
+ * If a copy of T throws on any thread, the hash is left empty and
+ * the exception is thrown again here
+ ****************************************/
+template <typename T>
+template <class Iterator>
+void unordered_set<T>::build(Iterator first, Iterator last, size_t numThreads, std::true_type)
+{
+    size_t num = last - first;
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    if (numThreads > num / PARALLEL_GRAIN)
+        numThreads = num / PARALLEL_GRAIN;
+    if (numThreads < 2)
+    {
+        build(first, last, 1, std::false_type());
+        return;
+    }
+
+    const size_t numBuckets = bucket_count();
+    std::vector<custom::list<T>> partitions(numThreads * numBuckets);
+    std::vector<size_t> counts(numThreads, 0);
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<std::thread> threads;
+
+    // partition each slice by bucket
+    for (size_t t = 0; t < numThreads; t++)
+        threads.push_back(std::thread([&, t]()
+        {
+            try
+            {
+                custom::list<T>* pPartition = &partitions[t * numBuckets];
+                Iterator itEnd = first + (num * (t + 1) / numThreads);
+                for (Iterator it = first + (num * t / numThreads); it != itEnd; ++it)
+                    pPartition[bucket(*it)].push_back(*it);
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        }));
+    for (auto& thread : threads)
+        thread.join();
+    threads.clear();
+    for (auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    // stitch each bucket together and remove the duplicates
+    for (size_t t = 0; t < numThreads; t++)
+        threads.push_back(std::thread([&, t]()
+        {
+            try
+            {
+                for (size_t iBucket = t; iBucket < numBuckets; iBucket += numThreads)
+                {
+                    custom::list<T>& bucket = buckets[iBucket];
+                    for (size_t p = 0; p < numThreads; p++)
+                        bucket.splice(bucket.end(), partitions[p * numBuckets + iBucket]);
+
+                    bucket_index<T> seen(bucket.size(), numBuckets);
+                    auto it = bucket.begin();
+                    while (it != bucket.end())
+                        if (seen.insert(&*it))
+                            ++it;
+                        else
+                            it = bucket.erase(it);
+                    counts[t] += bucket.size();
+                }
+            }
+            catch (...)
+            {
+                errors[t] = std::current_exception();
+            }
+        }));
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+        if (error)
+        {
+            for (size_t i = 0; i < numBuckets; i++)
+                buckets[i].clear();
+            std::rethrow_exception(error);
+        }
+
+    for (size_t t = 0; t < numThreads; t++)
+        numElements += (int)counts[t];
+}
+
+/*****************************************
+ * UNORDERED SET :: CLONE
+ * Copy rhs into this empty hash. The nodes come from as few
+ * contiguous blocks as the pool's chunks allow, and each bucket is copied
+ * straight across, so nothing is hashed again. If a copy throws,
+ * the hash is left empty
+ ****************************************/
+template <typename T>
+void unordered_set<T>::clone(const unordered_set& rhs)
+{
+    typedef typename custom::list<T>::Node Node;
+
+    size_t num = 0;
+    for (size_t i = 0; i < bucket_count(); i++)
+        num += rhs.buckets[i].size();
+
+    Node* pBlock = nullptr;
+    size_t numBlock = 0;
+    size_t iBlock = 0;
+    size_t iNode = 0;
+    try
+    {
+        for (size_t i = 0; i < bucket_count(); i++)
+            for (auto it = rhs.buckets[i].cbegin(); it != rhs.buckets[i].cend(); ++it)
+            {
+                if (iBlock == numBlock)
+                {
+                    numBlock = num - iNode;
+                    pBlock = Node::carve(numBlock);
+                    iBlock = 0;
+                }
+                buckets[i].link_back(new (pBlock + iBlock) Node(*it));
+                iBlock++;
+                iNode++;
+            }
+    }
+    catch (...)
+    {
+        // the slots we never built on still belong to the pool
+        for (size_t i = iBlock; i < numBlock; i++)
+            Node::operator delete(pBlock + i);
+        clear();
+        throw;
+    }
+    numElements = (int)num;
+}
+
+/*****************************************
+ * UNORDERED SET :: ZIP
+ * Fill out bucket by bucket with merge(lhs[i], rhs[i], out[i]),
+ * spreading the buckets across the cores once there are enough
+ * elements to pay for the threads. Each worker only writes to the
+ * buckets it was handed, so no locks are needed. If merge throws,
+ * out is left empty and the exception is thrown again here
+ ****************************************/
+template <typename T>
+template <class Merge>
+void unordered_set<T>::zip(const unordered_set& lhs, const unordered_set& rhs, unordered_set& out, Merge merge)
+{
+    out.clear();
+    size_t numThreads = (size_t)(lhs.size() + rhs.size()) < PARALLEL_GRAIN ? 1 : 0;
+    try
+    {
+        parallel_for(lhs.range(), [&](const bucket_range<const custom::list<T>>& r)
+        {
+            for (const custom::list<T>* pBucket = r.begin(); pBucket != r.end(); ++pBucket)
+            {
+                size_t i = pBucket - lhs.buckets;
+                merge(lhs.buckets[i], rhs.buckets[i], out.buckets[i]);
+            }
+        }, numThreads);
+    }
+    catch (...)
+    {
+        out.clear();
+        throw;
+    }
+
+    for (size_t i = 0; i < out.bucket_count(); i++)
+        out.numElements += (int)out.buckets[i].size();
+}
+
 /*****************************************
  * UNORDERED SET :: FIND
- * Find an element in an unordered set
+ * Find an element in an unordered set, and promote it within its
+ * bucket as the find policy says
  ****************************************/
 template <typename T>
 typename unordered_set <T> ::iterator unordered_set<T>::find(const T& t)
@@ -445,7 +974,7 @@ typename unordered_set <T> ::iterator unordered_set<T>::find(const T& t)
         }
     }*/
     auto iBucket = bucket(t);
-    auto itList = buckets[iBucket].find(t);
+    auto itList = buckets[iBucket].find(t, findPolicy);
 
     if (itList != buckets[iBucket].end())
         return iterator(&buckets[iBucket], &buckets[bucket_count()], itList);
@@ -453,6 +982,18 @@ typename unordered_set <T> ::iterator unordered_set<T>::find(const T& t)
     return end();
 }
 
+template <typename T>
+typename unordered_set <T> ::const_iterator unordered_set<T>::find(const T& t) const
+{
+    size_t iBucket = bucket(t);
+    auto itList = buckets[iBucket].find(t);
+
+    if (itList != buckets[iBucket].end())
+        return const_iterator(buckets + iBucket, buckets + bucket_count(), itList);
+
+    return end();
+}
+
 /*****************************************
  * UNORDERED SET :: ITERATOR :: INCREMENT
  * Advance by one element in an unordered set
@@ -477,6 +1018,240 @@ typename unordered_set <T> ::iterator & unordered_set<T>::iterator::operator ++
     return *this;
 }
 
+/*****************************************
+ * UNORDERED SET :: CONST ITERATOR :: INCREMENT
+ * Advance by one element in an unordered set
+ ****************************************/
+template <typename T>
+typename unordered_set <T> ::const_iterator & unordered_set<T>::const_iterator::operator ++ ()
+{
+    if (pBucket == pBucketEnd)
+        return *this;
+
+    ++itList;
+    if (itList != pBucket->end())
+        return *this;
+
+    ++pBucket;
+    while (pBucket != pBucketEnd && pBucket->empty())
+        ++pBucket;
+
+    if (pBucket != pBucketEnd)
+        itList = pBucket->begin();
+
+    return *this;
+}
+
+/*****************************************
+ * PARALLEL FOR EACH
+ * Call fn(element) on every element, spreading the buckets across
+ * the cores. fn is called from several threads at once. If it
+ * throws, the rest of the buckets may or may not be visited, and
+ * the first exception comes back out of here
+ ****************************************/
+template <typename T, class Function>
+void parallel_for_each(unordered_set<T>& s, Function fn)
+{
+    parallel_for(s.range(), [&fn](const bucket_range<custom::list<T>>& r)
+    {
+        for (custom::list<T>* pBucket = r.begin(); pBucket != r.end(); ++pBucket)
+            for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+                fn(*it);
+    });
+}
+
+template <typename T, class Function>
+void parallel_for_each(const unordered_set<T>& s, Function fn)
+{
+    parallel_for(s.range(), [&fn](const bucket_range<const custom::list<T>>& r)
+    {
+        for (const custom::list<T>* pBucket = r.begin(); pBucket != r.end(); ++pBucket)
+            for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+                fn(*it);
+    });
+}
+
+/*****************************************
+ * PARALLEL REDUCE
+ * Fold every element into one value, spreading the buckets across
+ * numThreads workers (0 means one per core; op alone uses them all).
+ *   With fold and combine: each worker starts from identity and
+ *   takes in its elements with fold(value, element); the workers'
+ *   values are merged with combine(value, value). identity must
+ *   leave a value unchanged under combine (0 for +)
+ *   With op alone: op(T, T) is both, so Value must be T. Each worker
+ *   starts from its first element, and init is taken in once at
+ *   the end, so it need not be an identity
+ * combine and op must be associative and commutative
+ ****************************************/
+template <typename T, class Value, class Fold, class Combine>
+Value parallel_reduce(const unordered_set<T>& s, const Value& identity, Fold fold, Combine combine,
+                      size_t numThreads = 0)
+{
+    return parallel_reduce(s.range(), identity,
+        [&fold](Value value, const bucket_range<const custom::list<T>>& r)
+        {
+            for (const custom::list<T>* pBucket = r.begin(); pBucket != r.end(); ++pBucket)
+                for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+                    value = fold(value, *it);
+            return value;
+        }, combine, numThreads);
+}
+
+template <typename T, class Value, class Op>
+Value parallel_reduce(const unordered_set<T>& s, const Value& init, Op op)
+{
+    static_assert(std::is_same<Value, T>::value,
+                  "parallel_reduce with one op folds elements into each other; pass a fold and a combine");
+
+    // a worker's value, which has none until its first element
+    struct Partial
+    {
+        bool has;
+        T value;
+    };
+    Partial partial = parallel_reduce(s, Partial{ false, T() },
+        [&op](const Partial& p, const T& t) { return Partial{ true, p.has ? op(p.value, t) : t }; },
+        [&op](const Partial& lhs, const Partial& rhs)
+        {
+            if (!lhs.has || !rhs.has)
+                return lhs.has ? lhs : rhs;
+            return Partial{ true, op(lhs.value, rhs.value) };
+        });
+    return partial.has ? op(init, partial.value) : init;
+}
+
+/*****************************************
+ * SET UNION
+ * Everything in lhs followed by what rhs adds, bucket by bucket.
+ * Each bucket of lhs is indexed once, so a pair of buckets of k
+ * is O(k)
+ ****************************************/
+template <typename T>
+unordered_set<T> set_union(const unordered_set<T>& lhs, const unordered_set<T>& rhs)
+{
+    unordered_set<T> out;
+    unordered_set<T>::zip(lhs, rhs, out,
+        [&lhs](const custom::list<T>& l, const custom::list<T>& r, custom::list<T>& o)
+        {
+            bucket_index<T> index(l.size(), lhs.bucket_count());
+            for (auto it = l.begin(); it != l.end(); ++it)
+            {
+                o.push_back(*it);
+                index.insert(&*it);
+            }
+            for (auto it = r.begin(); it != r.end(); ++it)
+                if (!index.contains(*it))
+                    o.push_back(*it);
+        });
+    return out;
+}
+
+/*****************************************
+ * SET INTERSECTION
+ * What lhs and rhs have in common, in lhs order. Each bucket of
+ * rhs is indexed once, so a pair of buckets of k is O(k)
+ ****************************************/
+template <typename T>
+unordered_set<T> set_intersection(const unordered_set<T>& lhs, const unordered_set<T>& rhs)
+{
+    unordered_set<T> out;
+    unordered_set<T>::zip(lhs, rhs, out,
+        [&lhs](const custom::list<T>& l, const custom::list<T>& r, custom::list<T>& o)
+        {
+            if (r.empty())
+                return;
+            bucket_index<T> index(r.size(), lhs.bucket_count());
+            for (auto it = r.begin(); it != r.end(); ++it)
+                index.insert(&*it);
+            for (auto it = l.begin(); it != l.end(); ++it)
+                if (index.contains(*it))
+                    o.push_back(*it);
+        });
+    return out;
+}
+
+/*****************************************
+ * SET DIFFERENCE
+ * What lhs has that rhs does not, in lhs order. Each bucket of
+ * rhs is indexed once, so a pair of buckets of k is O(k)
+ ****************************************/
+template <typename T>
+unordered_set<T> set_difference(const unordered_set<T>& lhs, const unordered_set<T>& rhs)
+{
+    unordered_set<T> out;
+    unordered_set<T>::zip(lhs, rhs, out,
+        [&lhs](const custom::list<T>& l, const custom::list<T>& r, custom::list<T>& o)
+        {
+            bucket_index<T> index(r.size(), lhs.bucket_count());
+            for (auto it = r.begin(); it != r.end(); ++it)
+                index.insert(&*it);
+            for (auto it = l.begin(); it != l.end(); ++it)
+                if (!index.contains(*it))
+                    o.push_back(*it);
+        });
+    return out;
+}
+
+/*****************************************
+ * IS SUBSET
+ * Is every element of lhs also in rhs? Each bucket of rhs is
+ * indexed once, so a pair of buckets of k is O(k)
+ ****************************************/
+template <typename T>
+bool is_subset(const unordered_set<T>& lhs, const unordered_set<T>& rhs)
+{
+    if (lhs.size() > rhs.size())
+        return false;
+
+    size_t numThreads = (size_t)(lhs.size() + rhs.size()) < unordered_set<T>::PARALLEL_GRAIN ? 1 : 0;
+    return parallel_reduce(lhs.range(), true,
+        [&](bool subset, const bucket_range<const custom::list<T>>& r)
+        {
+            for (const custom::list<T>* pBucket = r.begin(); subset && pBucket != r.end(); ++pBucket)
+            {
+                const custom::list<T>& bucket = rhs.buckets[pBucket - lhs.buckets];
+                if (pBucket->size() > bucket.size())
+                    return false;
+                bucket_index<T> index(bucket.size(), lhs.bucket_count());
+                for (auto it = bucket.begin(); it != bucket.end(); ++it)
+                    index.insert(&*it);
+                for (auto it = pBucket->begin(); subset && it != pBucket->end(); ++it)
+                    subset = index.contains(*it);
+            }
+            return subset;
+        },
+        [](bool lhs, bool rhs) { return lhs && rhs; }, numThreads);
+}
+
+/*****************************************
+ * ERASE IF
+ * Remove every element the predicate picks, one pass per bucket with
+ * no lookups. Returns how many were removed. Should the predicate
+ * throw, what it picked before stays removed and is counted
+ ****************************************/
+template <typename T, class Predicate>
+size_t erase_if(unordered_set<T>& s, Predicate pred)
+{
+    size_t num = 0;
+    for (size_t i = 0; i < s.bucket_count(); i++)
+    {
+        custom::list<T>& bucket = s.buckets[i];
+        size_t numBefore = bucket.size();
+        try
+        {
+            num += bucket.remove_if(pred);
+        }
+        catch (...)
+        {
+            s.numElements -= (int)(num + numBefore - bucket.size());
+            throw;
+        }
+    }
+    s.numElements -= (int)num;
+    return num;
+}
+
 /*****************************************
  * SWAP
  * Stand-alone unordered set swap
@@ -486,6 +1261,7 @@ void swap(unordered_set<T>& lhs, unordered_set<T>& rhs)
 {
     std::swap(lhs.numElements, rhs.numElements);
     std::swap(lhs.buckets, rhs.buckets);  
+    std::swap(lhs.findPolicy, rhs.findPolicy);
 }
 
 }
@@ -0,0 +1,530 @@
+/***********************************************************************
+ * Header:
+ *    INT HASH
+ * Summary:
+ *    A lock-free set of unsigned integers kept in one flat array of
+ *    atomic slots with linear probing. insert() claims an empty slot
+ *    with a CAS, erase() flags the key as erased but leaves it in its
+ *    slot, and contains() is a plain run of loads with no retries. When
+ *    the array fills up, every writer that notices helps migrate it
+ *    into a bigger one, and nobody waits for the migration to finish
+ *
+ *    This will contain the class definition of:
+ *        concurrent_int_set : A lock-free open-addressing set of integers
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "epoch.h"     // for epoch_domain, which frees the old arrays
+#include <atomic>      // for std::atomic
+#include <cstdint>     // for uint64_t
+#include <limits>      // for std::numeric_limits
+#include <memory>      // for std::unique_ptr
+#include <stdexcept>   // for std::invalid_argument
+#include <type_traits> // for std::is_unsigned
+
+namespace custom
+{
+
+/************************************************
+ * CONCURRENT INT SET
+ * Any number of threads may call any member at once. The top two
+ * bits of a slot say what has become of its key, so only keys up to
+ * MAX_KEY can be stored
+ *
+ * A slot, once it holds a key, holds that key for good. Erasing it
+ * sets DEAD, and inserting it again clears DEAD in the same slot, so
+ * a key never has more than one slot in an array. A migration first
+ * freezes a live key with PRIME, which no writer may touch, then
+ * copies it on and marks the slot MOVED. A writer that finds an
+ * array migrating settles its own key there - freezes and copies
+ * it, or seals the empty slot its probe ends on - and writes to the
+ * next array, so whatever the next array holds for a key is always
+ * newer than a frozen copy still on its way
+ ************************************************/
+template <typename T = uint64_t>
+class concurrent_int_set
+{
+   static_assert(std::is_unsigned<T>::value, "concurrent_int_set holds unsigned integers");
+
+public:
+   //
+   // Construct
+   //
+   explicit concurrent_int_set(size_t capacity = MIN_CAPACITY) : numElements(0), numRetired(0)
+   {
+      size_t pow2 = MIN_CAPACITY;
+      while (pow2 < capacity)
+         pow2 *= 2;
+      pTable = new Table(pow2);
+   }
+   concurrent_int_set(const concurrent_int_set&) = delete;
+   concurrent_int_set& operator = (const concurrent_int_set&) = delete;
+   ~concurrent_int_set()
+   {
+      for (Table* p = pTable.load(); p; )
+      {
+         Table* pNext = p->pNext.load();
+         delete p;
+         p = pNext;
+      }
+   }
+
+   //
+   // Access - wait-free
+   //
+   bool contains(T key) const;
+   size_t count(T key) const { return contains(key) ? 1 : 0; }
+
+   //
+   // Insert - an array retired meanwhile is collected on the way out
+   //
+   bool insert(T key)
+   {
+      size_t numBefore = numRetired.load();
+      bool inserted = add(key);
+      reclaim(numBefore);
+      return inserted;
+   }
+
+   //
+   // Remove
+   //
+   size_t erase(T key)
+   {
+      size_t numBefore = numRetired.load();
+      size_t num = remove(key);
+      reclaim(numBefore);
+      return num;
+   }
+
+   //
+   // Status
+   //
+   size_t size()  const { return numElements.load(); }
+   bool   empty() const { return size() == 0; }
+   size_t capacity() const
+   {
+      epoch_domain::guard guard;
+      return pTable.load()->capacity;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const T PRIME   = T(T(1) << (std::numeric_limits<T>::digits - 1));  // live, being copied on
+   static const T DEAD    = T(PRIME >> 1);                                     // erased
+   static const T MOVED   = T(PRIME | DEAD);                                   // in the next array now
+   static const T EMPTY   = T(~T(0));
+   static const T SEALED  = T(~T(0) - 1);     // was empty, and nothing may go here any more
+   static const T MAX_KEY = T(DEAD - 3);      // so no key looks like EMPTY or SEALED
+   static const size_t MIN_CAPACITY  = 16;
+   static const size_t MIGRATE_CHUNK = 256;  // slots a helper takes at a time
+
+   // one generation of the slot array
+   struct Table
+   {
+      explicit Table(size_t capacity)
+         : capacity(capacity), slots(new std::atomic<T>[capacity]),
+           used(0), pNext(nullptr), claimed(0), migrated(0)
+      {
+         for (size_t i = 0; i < capacity; i++)
+            slots[i].store(EMPTY, std::memory_order_relaxed);
+      }
+
+      // capacity is a power of two, so this is key % capacity
+      size_t home(T key) const { return (size_t)key & (capacity - 1); }
+      size_t next(size_t i) const { return (i + 1) & (capacity - 1); }
+
+      size_t capacity;
+      std::unique_ptr<std::atomic<T>[]> slots;
+      std::atomic<size_t> used;      // slots that are no longer EMPTY
+      std::atomic<Table*> pNext;     // where a migration is going
+      std::atomic<size_t> claimed;   // slots handed out to helpers
+      std::atomic<size_t> migrated;  // slots the helpers have finished
+   };
+
+   // what one array says about a key
+   enum Found { ABSENT, LIVE, ERASED, FROZEN, CARRIED, LATER };
+
+   // the key in a slot, whatever its flags. EMPTY and SEALED give
+   // values past MAX_KEY, so they never match a key
+   static T keyOf(T v) { return T(v & ~MOVED); }
+
+   static void  deleteTable(void* p) { delete static_cast<Table*>(p); }
+   static Found find(const Table* p, T key);
+
+   bool   add(T key);
+   size_t remove(T key);
+   void   reclaim(size_t numBefore);
+   Table* target(T key);
+   void   settle(Table* p, T key);
+   void   grow(Table* p);
+   void   help(Table* p);
+   void   migrate(Table* p, size_t i);
+   void   place(Table* p, T key);
+   void   publish();
+
+   std::atomic<Table*> pTable;
+   std::atomic<size_t> numElements;
+   std::atomic<size_t> numRetired;   // arrays handed to the epoch domain
+};
+
+/*****************************************
+ * CONCURRENT INT SET :: FIND
+ * Probe one array from the key's home slot until we find the key or
+ * the end of its run. A sealed end means the key may have been
+ * written to the next array since
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+typename concurrent_int_set <T> ::Found concurrent_int_set <T> ::find(const Table* p, T key)
+{
+   size_t i = p->home(key);
+   for (size_t n = 0; n < p->capacity; n++, i = p->next(i))
+   {
+      T v = p->slots[i].load(std::memory_order_acquire);
+      if (v == EMPTY)
+         return ABSENT;
+      if (v == SEALED)
+         return LATER;
+      if (keyOf(v) == key)
+         return v == key ? LIVE : v == (key | DEAD) ? ERASED : v == (key | PRIME) ? FROZEN : CARRIED;
+   }
+   return LATER;
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: CONTAINS
+ * Ask each array in turn, oldest first. A frozen key is still in
+ * the set unless a newer array says otherwise, and a carried one is
+ * whatever the newer arrays say. No CAS and no retry, so every call
+ * finishes in a bounded number of steps
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+bool concurrent_int_set <T> ::contains(T key) const
+{
+   if (key > MAX_KEY)
+      return false;
+
+   epoch_domain::guard guard;
+   bool live = false;   // what an older array says, while its copy is on the way
+   for (const Table* p = pTable.load(std::memory_order_acquire); p; p = p->pNext.load(std::memory_order_acquire))
+      switch (find(p, key))
+      {
+         case LIVE:    return true;
+         case ERASED:  return false;
+         case ABSENT:  return live;
+         case FROZEN:  live = true;  break;
+         case CARRIED: live = false; break;
+         case LATER:   break;
+      }
+   return live;
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: ADD
+ * Claim the first empty slot along the probe with a CAS, or bring
+ * back the key's own slot if it was erased. Two threads inserting
+ * the same key always race for the same slot, and the loser sees
+ * the winner's key there
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+bool concurrent_int_set <T> ::add(T key)
+{
+   if (key > MAX_KEY)
+      throw std::invalid_argument("concurrent_int_set: key is reserved");
+
+   epoch_domain::guard guard;
+   for (;;)
+   {
+      Table* p = target(key);
+      if (p->used.load() >= p->capacity / 4 * 3)
+      {
+         grow(p);
+         continue;
+      }
+
+      size_t i = p->home(key);
+      bool moving = false;
+      for (size_t n = 0; !moving && n < p->capacity; )
+      {
+         T v = p->slots[i].load();
+         if (v == EMPTY || v == (key | DEAD))
+         {
+            if (p->slots[i].compare_exchange_strong(v, key))
+            {
+               if (v == EMPTY)
+                  p->used++;
+               numElements++;
+               return true;
+            }
+            continue;   // somebody beat us to it; look again
+         }
+         if (v == key)
+            return false;
+         moving = (v == SEALED || keyOf(v) == key);
+         i = p->next(i);
+         n++;
+      }
+
+      // the array started moving under us, or it was full
+      if (!moving)
+         grow(p);
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: REMOVE
+ * Flag the key as erased, leaving it in its slot
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+size_t concurrent_int_set <T> ::remove(T key)
+{
+   if (key > MAX_KEY)
+      return 0;
+
+   epoch_domain::guard guard;
+   for (;;)
+   {
+      Table* p = target(key);
+      size_t i = p->home(key);
+      bool moving = false;
+      for (size_t n = 0; !moving && n < p->capacity; )
+      {
+         T v = p->slots[i].load();
+         if (v == EMPTY || v == (key | DEAD))
+            return 0;
+         if (v == key)
+         {
+            if (p->slots[i].compare_exchange_strong(v, T(key | DEAD)))
+            {
+               numElements--;
+               return 1;
+            }
+            continue;
+         }
+         moving = (v == SEALED || keyOf(v) == key);
+         i = p->next(i);
+         n++;
+      }
+      if (!moving)
+         return 0;
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: RECLAIM
+ * An array goes only a few times as the set grows, too rarely for
+ * the epoch domain to get round to it by itself. So whoever sees
+ * one retired while it wrote collects, now that it is no longer
+ * pinned: with nobody else reading, the old array is freed here
+ *     COST   : O(threads + retired) after a migration, else O(1)
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::reclaim(size_t numBefore)
+{
+   if (numRetired.load() != numBefore)
+      epoch_domain::global().collect();
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: TARGET
+ * The array to write key to: the newest one. Every older array
+ * along the way gets some help with its migration, and has the
+ * key settled so nothing more is written there
+ ****************************************/
+template <typename T>
+typename concurrent_int_set <T> ::Table* concurrent_int_set <T> ::target(T key)
+{
+   Table* p = pTable.load();
+   for (Table* pNext = p->pNext.load(); pNext; pNext = p->pNext.load())
+   {
+      help(p);
+      settle(p, key);
+      p = pNext;
+   }
+   return p;
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: SETTLE
+ * Finish with key in a migrating array: copy its slot on if it
+ * has one, or seal the empty slot its probe ends on so that no
+ * writer can put it there after we have looked
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::settle(Table* p, T key)
+{
+   size_t i = p->home(key);
+   for (size_t n = 0; n < p->capacity; )
+   {
+      T v = p->slots[i].load();
+      if (v == SEALED)
+         return;
+      if (v == EMPTY)
+      {
+         if (p->slots[i].compare_exchange_strong(v, SEALED))
+            return;
+         continue;
+      }
+      if (keyOf(v) == key)
+      {
+         migrate(p, i);
+         return;
+      }
+      i = p->next(i);
+      n++;
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: GROW
+ * Start a migration out of p, unless one has started already.
+ * The new array doubles unless most of the used slots are erased
+ * keys, in which case the same size gets rid of them
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::grow(Table* p)
+{
+   if (p->pNext.load() == nullptr)
+   {
+      size_t newCapacity = (numElements.load() * 4 >= p->capacity) ? p->capacity * 2 : p->capacity;
+      Table* pNew = new Table(newCapacity);
+      Table* pExpected = nullptr;
+      if (!p->pNext.compare_exchange_strong(pExpected, pNew))
+         delete pNew;
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: HELP
+ * Take chunks of p and migrate them until there are none left to
+ * take. Whoever finishes the last chunk publishes the new array.
+ * Nobody waits for a chunk somebody else has taken: writers go on
+ * to the next array as soon as their own key is settled
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::help(Table* p)
+{
+   for (;;)
+   {
+      size_t iFirst = p->claimed.fetch_add(MIGRATE_CHUNK);
+      if (iFirst >= p->capacity)
+         return;
+      size_t iLast = (iFirst + MIGRATE_CHUNK < p->capacity) ? iFirst + MIGRATE_CHUNK : p->capacity;
+      for (size_t i = iFirst; i < iLast; i++)
+         migrate(p, i);
+
+      if (p->migrated.fetch_add(iLast - iFirst) + (iLast - iFirst) == p->capacity)
+         publish();
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: PUBLISH
+ * Move pTable past every array, oldest first, whose migration has
+ * finished, and retire each. An array that finishes before an older
+ * one waits for it, since the older one still links to it
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::publish()
+{
+   for (;;)
+   {
+      Table* p = pTable.load();
+      Table* pNext = p->pNext.load();
+      if (pNext == nullptr || p->migrated.load() != p->capacity)
+         return;
+      if (pTable.compare_exchange_strong(p, pNext))
+      {
+         epoch_domain::global().retire(p, &deleteTable);
+         numRetired++;
+      }
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: MIGRATE
+ * Move slot i of p into the next array. Any number of threads may
+ * move the same slot. A live key is frozen first, so the copy cannot
+ * go stale, and copied before the slot says MOVED, so a reader
+ * always finds it in one array or the other. An erased key is not
+ * copied at all
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::migrate(Table* p, size_t i)
+{
+   std::atomic<T>& slot = p->slots[i];
+   T v = slot.load();
+   for (;;)
+   {
+      if (v == SEALED || (v != EMPTY && (v & MOVED) == MOVED))
+         return;
+      if (v == EMPTY)
+      {
+         if (slot.compare_exchange_strong(v, SEALED))
+            return;
+      }
+      else if (v & DEAD)
+      {
+         if (slot.compare_exchange_strong(v, T(v | MOVED)))
+            return;
+      }
+      else if ((v & PRIME) || slot.compare_exchange_strong(v, T(v | PRIME)))
+      {
+         place(p->pNext.load(), keyOf(v));
+         slot.store(T(keyOf(v) | MOVED));
+         return;
+      }
+   }
+}
+
+/*****************************************
+ * CONCURRENT INT SET :: PLACE
+ * Copy a frozen key into p, unless p already has a slot for it: an
+ * earlier copy, or a write made since, which is newer. If the key's
+ * run in p is sealed, it belongs in the array after p
+ *     COST   : O(probe length)
+ ****************************************/
+template <typename T>
+void concurrent_int_set <T> ::place(Table* p, T key)
+{
+   for (;;)
+   {
+      size_t i = p->home(key);
+      for (size_t n = 0; n < p->capacity; )
+      {
+         T v = p->slots[i].load();
+         if (v == EMPTY)
+         {
+            if (p->slots[i].compare_exchange_strong(v, key))
+            {
+               p->used++;
+               return;
+            }
+            continue;   // lost the slot to another writer; look again
+         }
+         if (keyOf(v) == key)
+            return;
+         if (v == SEALED)
+            break;
+         i = p->next(i);
+         n++;
+      }
+
+      // sealed, or full with nowhere to put it
+      grow(p);
+      p = p->pNext.load();
+   }
+}
+
+} // namespace custom
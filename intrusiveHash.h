@@ -0,0 +1,310 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE HASH
+ * Summary:
+ *    A chained hash set whose buckets are intrusive lists, so the
+ *    objects in it carry the chain links themselves. Inserting links an
+ *    object in where it already is and erasing unlinks it; the only
+ *    allocation is the bucket array, and a rehash moves links rather
+ *    than objects. An object with one hook per set can be in several
+ *    sets at once, each indexing it by its own hash
+ *
+ *    This will contain the class definition of:
+ *        intrusive_unordered_set           : A hash of objects through one hook
+ *        intrusive_unordered_set::iterator : An iterator through it
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "intrusiveList.h" // for the buckets and the hook
+#include "pair.h"          // because insert() returns a pair
+#include <functional>      // for std::hash and std::equal_to
+#include <utility>         // for std::swap
+#include <vector>          // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * INTRUSIVE UNORDERED SET
+ * H hashes an object and E compares two, so that sets on different
+ * hooks can key the same objects differently. The set does not own
+ * what is in it: an object must outlive its time in the set, and
+ * must not change its hash while it is there
+ ************************************************/
+template <typename T, list_hook<T> T::*Hook, typename H = std::hash<T>, typename E = std::equal_to<T>>
+class intrusive_unordered_set
+{
+public:
+   //
+   // Construct - a set can be moved but not copied, the objects
+   // have only the one hook for it
+   //
+   explicit intrusive_unordered_set(size_t numBuckets = MIN_BUCKETS, const H& h = H(), const E& e = E())
+      : buckets(round(numBuckets)), numElements(0), hasher(h), equal(e) {}
+   intrusive_unordered_set(const intrusive_unordered_set& rhs) = delete;
+   intrusive_unordered_set(intrusive_unordered_set&& rhs) : intrusive_unordered_set()
+   {
+      swap(rhs);
+   }
+
+   //
+   // Assign
+   //
+   intrusive_unordered_set& operator = (const intrusive_unordered_set& rhs) = delete;
+   intrusive_unordered_set& operator = (intrusive_unordered_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(intrusive_unordered_set& rhs)
+   {
+      std::swap(buckets, rhs.buckets);
+      std::swap(numElements, rhs.numElements);
+      std::swap(hasher, rhs.hasher);
+      std::swap(equal, rhs.equal);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access
+   //
+   size_t bucket(const T& t) const { return hasher(t) & (buckets.size() - 1); }
+   iterator find(const T& t) const;
+   bool contains(const T& t) const { return find(t) != end(); }
+   size_t count(const T& t) const  { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert - links t in, unless something equal is already there
+   //
+   custom::pair<iterator, bool> insert(T& t);
+
+   //
+   // Remove - unlinks, the objects themselves are untouched
+   //
+   void clear() noexcept
+   {
+      for (auto& bucket : buckets)
+         bucket.clear();
+      numElements = 0;
+   }
+   iterator erase(const iterator& it);
+   size_t erase(const T& t);
+
+   //
+   // Status
+   //
+   size_t size() const         { return numElements; }
+   bool empty() const          { return numElements == 0; }
+   size_t bucket_count() const { return buckets.size(); }
+   size_t bucket_size(size_t i) const { return buckets[i].size(); }
+   void rehash(size_t numBuckets);
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   typedef intrusive_list<T, Hook> Bucket;
+   static const size_t MIN_BUCKETS = 8;
+
+   // the next power of two that is at least n, and at least MIN_BUCKETS
+   static size_t round(size_t n)
+   {
+      size_t num = MIN_BUCKETS;
+      while (num < n)
+         num *= 2;
+      return num;
+   }
+
+   std::vector<Bucket> buckets;   // a power of two of them
+   size_t numElements;
+   H hasher;
+   E equal;
+};
+
+/************************************************
+ * INTRUSIVE UNORDERED SET ITERATOR
+ * A bucket, and a place in its chain
+ ************************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+class intrusive_unordered_set <T, Hook, H, E> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : pBucket(nullptr), pBucketEnd(nullptr) {}
+   iterator(const Bucket* pBucket, const Bucket* pBucketEnd, const typename Bucket::iterator& itList)
+      : pBucket(pBucket), pBucketEnd(pBucketEnd), itList(itList) {}
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return pBucket == rhs.pBucket && itList == rhs.itList; }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access
+   //
+   T& operator * () const { return *itList; }
+   T* operator -> () const { return &*itList; }
+
+   //
+   // Arithmetic - on to the next object, or the next bucket with one
+   //
+   iterator& operator ++ ()
+   {
+      if (++itList != typename Bucket::iterator())
+         return *this;
+      while (++pBucket != pBucketEnd)
+         if (!pBucket->empty())
+         {
+            itList = pBucket->begin();
+            return *this;
+         }
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+   friend class intrusive_unordered_set <T, Hook, H, E>;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const Bucket* pBucket;
+   const Bucket* pBucketEnd;
+   typename Bucket::iterator itList;
+};
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: BEGIN / END
+ * The first object of the first bucket that has one
+ ****************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+typename intrusive_unordered_set <T, Hook, H, E> ::iterator intrusive_unordered_set <T, Hook, H, E> ::begin() const
+{
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   for (const Bucket* p = buckets.data(); p != pEnd; ++p)
+      if (!p->empty())
+         return iterator(p, pEnd, p->begin());
+   return end();
+}
+
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+typename intrusive_unordered_set <T, Hook, H, E> ::iterator intrusive_unordered_set <T, Hook, H, E> ::end() const
+{
+   const Bucket* pEnd = buckets.data() + buckets.size();
+   return iterator(pEnd, pEnd, typename Bucket::iterator());
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: FIND
+ * Walk the one chain t could be on
+ *     COST   : O(1) on average
+ ****************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+typename intrusive_unordered_set <T, Hook, H, E> ::iterator intrusive_unordered_set <T, Hook, H, E> ::find(const T& t) const
+{
+   const Bucket* pBucket = buckets.data() + bucket(t);
+   for (auto itList = pBucket->begin(); itList != pBucket->end(); ++itList)
+      if (equal(*itList, t))
+         return iterator(pBucket, buckets.data() + buckets.size(), itList);
+   return end();
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: INSERT
+ * Link t onto the front of its chain, doubling the buckets
+ * first if there would be more objects than buckets
+ *     INPUT  : the object, which must not be in a set on this hook
+ *     OUTPUT : where it is, and whether it went in
+ *     COST   : O(1) on average
+ ****************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+custom::pair<typename intrusive_unordered_set <T, Hook, H, E> ::iterator, bool> intrusive_unordered_set <T, Hook, H, E> ::insert(T& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+
+   if (numElements + 1 > buckets.size())
+      rehash(buckets.size() * 2);
+
+   Bucket* pBucket = buckets.data() + bucket(t);
+   auto itList = pBucket->insert(pBucket->begin(), t);
+   numElements++;
+   return custom::pair<iterator, bool>(iterator(pBucket, buckets.data() + buckets.size(), itList), true);
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: ERASE
+ * Unlink one object from its chain
+ *     INPUT  : the object, or an iterator to it
+ *     OUTPUT : the object after it, or how many went
+ *     COST   : O(1) on average
+ ****************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+typename intrusive_unordered_set <T, Hook, H, E> ::iterator intrusive_unordered_set <T, Hook, H, E> ::erase(const iterator& it)
+{
+   if (it == end())
+      return end();
+   iterator itNext(it);
+   ++itNext;
+   const_cast<Bucket*>(it.pBucket)->erase(it.itList);
+   numElements--;
+   return itNext;
+}
+
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+size_t intrusive_unordered_set <T, Hook, H, E> ::erase(const T& t)
+{
+   iterator it = find(t);
+   if (it == end())
+      return 0;
+   erase(it);
+   return 1;
+}
+
+/*****************************************
+ * INTRUSIVE UNORDERED SET :: REHASH
+ * Move every object's links onto a new set of chains. Iterators
+ * go stale; the objects do not move
+ *     INPUT  : at least how many buckets
+ *     COST   : O(n + buckets)
+ ****************************************/
+template <typename T, list_hook<T> T::*Hook, typename H, typename E>
+void intrusive_unordered_set <T, Hook, H, E> ::rehash(size_t numBuckets)
+{
+   numBuckets = round(numBuckets);
+   if (numBuckets == buckets.size())
+      return;
+
+   std::vector<Bucket> newBuckets(numBuckets);
+   for (auto& bucket : buckets)
+      while (!bucket.empty())
+      {
+         T& t = bucket.front();
+         bucket.pop_front();
+         newBuckets[hasher(t) & (numBuckets - 1)].push_front(t);
+      }
+   buckets.swap(newBuckets);
+}
+
+} // namespace custom
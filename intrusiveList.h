@@ -0,0 +1,288 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list of objects that carry their own links. An
+ *    object gives the list a list_hook member, and the list threads
+ *    the objects together through it: nothing is allocated and nothing
+ *    is copied, so an object that lives in a pool can be on a list
+ *    where it is. An object with two hooks can be on two lists at once.
+ *    The list does not own what is on it; clearing it, or destroying
+ *    it, only unlinks
+ *
+ *    This will contain the class definitions of:
+ *        list_hook                : The links an object carries
+ *        intrusive_list           : A list of objects through one hook
+ *        intrusive_list::iterator : An iterator through it
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for assert
+#include <cstddef>     // for size_t
+#include <utility>     // for std::swap
+
+namespace custom
+{
+    /**************************************************
+     * LIST HOOK
+     * The two links a list needs. An object may be on one list
+     * per hook, and must stay put while it is on one
+     **************************************************/
+    template <typename T>
+    struct list_hook
+    {
+        list_hook() : pNext(nullptr), pPrev(nullptr) {}
+
+        // a copy of an object is on no list
+        list_hook(const list_hook&) : list_hook() {}
+        list_hook& operator = (const list_hook&) { return *this; }
+
+        T* pNext;
+        T* pPrev;
+    };
+
+    /**************************************************
+     * INTRUSIVE LIST
+     * The interface of list, taking objects by reference rather
+     * than by value. Hook names the member the links are in
+     **************************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    class intrusive_list
+    {
+    public:
+        //
+        // Construct - a list can be moved but not copied, since
+        // an object has only the one set of links
+        //
+
+        intrusive_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+        intrusive_list(const intrusive_list& rhs) = delete;
+        intrusive_list(intrusive_list&& rhs) noexcept : intrusive_list()
+        {
+            swap(rhs);
+        }
+        ~intrusive_list() { clear(); }
+
+        //
+        // Assign
+        //
+
+        intrusive_list& operator = (const intrusive_list& rhs) = delete;
+        intrusive_list& operator = (intrusive_list&& rhs) noexcept
+        {
+            clear();
+            swap(rhs);
+            return *this;
+        }
+        void swap(intrusive_list& rhs) noexcept
+        {
+            std::swap(numElements, rhs.numElements);
+            std::swap(pHead, rhs.pHead);
+            std::swap(pTail, rhs.pTail);
+        }
+
+        //
+        // Iterator
+        //
+
+        class iterator;
+        iterator begin()  const { return iterator(pHead); }
+        iterator rbegin() const { return iterator(pTail); }
+        iterator end()    const { return iterator(nullptr); }
+
+        // the iterator to an object known to be on this list
+        static iterator iterator_to(T& t) { return iterator(&t); }
+
+        //
+        // Access - the list must not be empty
+        //
+
+        T& front() const { assert(!empty()); return *pHead; }
+        T& back()  const { assert(!empty()); return *pTail; }
+        iterator find(const T& t) const;
+
+        //
+        // Insert - t must not be on another list through this hook
+        //
+
+        void push_front(T& t) { insert(begin(), t); }
+        void push_back(T& t)  { insert(end(), t); }
+        iterator insert(iterator it, T& t);
+
+        //
+        // Remove - unlinks, the object itself is untouched
+        //
+
+        void pop_front() { if (!empty()) erase(begin()); }
+        void pop_back()  { if (!empty()) erase(rbegin()); }
+        void clear();
+        iterator erase(const iterator& it);
+        void remove(T& t) { erase(iterator_to(t)); }
+
+        //
+        // Status
+        //
+
+        bool empty()  const { return numElements == 0; }
+        size_t size() const { return numElements; }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        static list_hook<T>& hook(T* p) { return p->*Hook; }
+
+        size_t numElements;
+        T* pHead;
+        T* pTail;
+    };
+
+    /*************************************************
+     * INTRUSIVE LIST ITERATOR
+     * A pointer to the object, which knows its neighbours
+     *************************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    class intrusive_list <T, Hook> ::iterator
+    {
+    public:
+        iterator() : p(nullptr) {}
+        explicit iterator(T* p) : p(p) {}
+
+        bool operator != (const iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const iterator& rhs) const { return rhs.p == p; }
+
+        T& operator * () const { return *p; }
+        T* operator -> () const { return p; }
+
+        iterator& operator ++ ()
+        {
+            p = (p->*Hook).pNext;
+            return *this;
+        }
+        iterator operator ++ (int postfix)
+        {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        // prefix decrement: stays put at the front, as list's does
+        iterator& operator -- ()
+        {
+            if ((p->*Hook).pPrev)
+                p = (p->*Hook).pPrev;
+            return *this;
+        }
+        iterator operator -- (int postfix)
+        {
+            iterator it(*this);
+            --(*this);
+            return it;
+        }
+
+        friend class intrusive_list <T, Hook>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        T* p;   // null at the end
+    };
+
+    /*****************************************
+     * INTRUSIVE LIST :: FIND
+     * The first object equal to t
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    typename intrusive_list <T, Hook> ::iterator intrusive_list <T, Hook> ::find(const T& t) const
+    {
+        for (T* p = pHead; p; p = hook(p).pNext)
+            if (*p == t)
+                return iterator(p);
+        return end();
+    }
+
+    /*****************************************
+     * INTRUSIVE LIST :: INSERT
+     * Link t in before it
+     *     INPUT  : where to put it, and the object
+     *     OUTPUT : an iterator to the object
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    typename intrusive_list <T, Hook> ::iterator intrusive_list <T, Hook> ::insert(iterator it, T& t)
+    {
+        T* pNew = &t;
+        T* pNext = it.p;
+        T* pPrev = pNext ? hook(pNext).pPrev : pTail;
+
+        hook(pNew).pNext = pNext;
+        hook(pNew).pPrev = pPrev;
+        if (pPrev)
+            hook(pPrev).pNext = pNew;
+        else
+            pHead = pNew;
+        if (pNext)
+            hook(pNext).pPrev = pNew;
+        else
+            pTail = pNew;
+
+        numElements++;
+        return iterator(pNew);
+    }
+
+    /*****************************************
+     * INTRUSIVE LIST :: ERASE
+     * Unlink one object and clear its hook
+     *     INPUT  : the object to take off
+     *     OUTPUT : the object after it
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    typename intrusive_list <T, Hook> ::iterator intrusive_list <T, Hook> ::erase(const iterator& it)
+    {
+        T* p = it.p;
+        if (!p)
+            return end();
+
+        T* pNext = hook(p).pNext;
+        T* pPrev = hook(p).pPrev;
+        if (pPrev)
+            hook(pPrev).pNext = pNext;
+        else
+            pHead = pNext;
+        if (pNext)
+            hook(pNext).pPrev = pPrev;
+        else
+            pTail = pPrev;
+
+        hook(p).pNext = hook(p).pPrev = nullptr;
+        numElements--;
+        return iterator(pNext);
+    }
+
+    /*****************************************
+     * INTRUSIVE LIST :: CLEAR
+     * Unlink everything, leaving the objects where they are
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T, list_hook<T> T::*Hook>
+    void intrusive_list <T, Hook> ::clear()
+    {
+        T* p = pHead;
+        while (p)
+        {
+            T* pNext = hook(p).pNext;
+            hook(p).pNext = hook(p).pPrev = nullptr;
+            p = pNext;
+        }
+        pHead = pTail = nullptr;
+        numElements = 0;
+    }
+
+} // namespace custom
@@ -14,6 +14,7 @@
  *    This will contain the class definition of:
  *        List         : A class that represents a List
  *        ListIterator : An iterator through List
+ *        ListConstIterator : An iterator through a List that cannot change it
  * Author
  *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell 
  ************************************************************************/
@@ -23,9 +24,44 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <type_traits> // for std::is_trivially_destructible
+#include <functional>  // for std::less and std::equal_to
+#include <iterator>    // for std::distance and std::iterator_traits
+#include <cstdint>     // for uintptr_t
+#include <exception>   // for std::exception_ptr
+#include <utility>     // for std::swap
+#include <vector>      // for std::vector
+#include "nodePool.h"   // for node_pool
 
 namespace custom
 {
+    template <typename T>
+    class unordered_set;
+
+    // what a successful find does with the node it found, so that
+    // keys looked up often drift toward the head of their list
+    enum class find_policy
+    {
+        stay,            // leave it where it is
+        move_to_front,   // relink it at the head
+        transpose        // swap it with the node before it
+    };
+
+    // whether a range can be measured before it is walked, so that
+    // its nodes can be carved in blocks
+    template <class Iterator, class = void>
+    struct is_forward_iterator : std::false_type {};
+    template <class Iterator>
+    struct is_forward_iterator <Iterator, typename std::enable_if<std::is_base_of<std::forward_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>::value>::type> : std::true_type {};
+
+    // whether a range can be cut into slices without a walk. An
+    // iterator with no traits at all is neither, and is only walked
+    template <class Iterator, class = void>
+    struct is_random_access_iterator : std::false_type {};
+    template <class Iterator>
+    struct is_random_access_iterator <Iterator, typename std::enable_if<std::is_base_of<std::random_access_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>::value>::type> : std::true_type {};
 
     /**************************************************
      * LIST
@@ -40,31 +76,44 @@ namespace custom
         //
 
         list();
-        list(list <T>& rhs);
+        list(const list <T>& rhs);
         list(list <T>&& rhs);
         list(size_t num, const T& t);
         list(size_t num);
         list(const std::initializer_list<T>& il);
-        template <class Iterator>
+        template <class Iterator, class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
         list(Iterator first, Iterator last);
-        ~list() { clear(); }
+        ~list()
+        {
+            clear();
+            delete pCheckpoints;
+        }
 
         //
         // Assign
         //
 
-        list <T>& operator = (list& rhs);
+        list <T>& operator = (const list& rhs);
         list <T>& operator = (list&& rhs);
         list <T>& operator = (const std::initializer_list<T>& il);
+        void assign(size_t num, const T& t);
+        template <class Iterator, class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        void assign(Iterator first, Iterator last);
 
         //
         // Iterator
         //
 
         class iterator;
+        class const_iterator;
         iterator begin() { return iterator(pHead); }
         iterator rbegin() { return iterator(pTail); }
         iterator end() { return iterator(nullptr); }
+        const_iterator begin()  const { return const_iterator(pHead); }
+        const_iterator rbegin() const { return const_iterator(pTail); }
+        const_iterator end()    const { return const_iterator(nullptr); }
+        const_iterator cbegin() const { return const_iterator(pHead); }
+        const_iterator cend()   const { return const_iterator(nullptr); }
 
         //
         // Access
@@ -83,8 +132,17 @@ namespace custom
         void push_back(T&& data);
         iterator insert(iterator it, const T& data);
         iterator insert(iterator it, T&& data);
+        iterator insert(iterator it, size_t num, const T& data);
+        template <class Iterator, class = typename std::enable_if<!std::is_integral<Iterator>::value>::type>
+        iterator insert(iterator it, Iterator first, Iterator last);
+        void splice(iterator it, list& rhs);
+        void merge(list& rhs) { merge(rhs, std::less<T>()); }
+        template <class Compare>
+        void merge(list& rhs, Compare comp);
 
         iterator find(const T& data);
+        iterator find(const T& data, find_policy policy);
+        const_iterator find(const T& data) const;
         //
         // Remove
         //
@@ -93,6 +151,22 @@ namespace custom
         void pop_front();
         void clear();
         iterator erase(const iterator& it);
+        iterator erase(const const_iterator& first, const const_iterator& last);
+        template <class Predicate>
+        size_t remove_if(Predicate pred);
+        size_t remove(const T& data);
+        size_t unique() { return unique(std::equal_to<T>()); }
+        template <class BinaryPredicate>
+        size_t unique(BinaryPredicate eq);
+
+        //
+        // Reorder - these only relink nodes, never allocating or copying
+        //
+
+        void sort() { sort(std::less<T>()); }
+        template <class Compare>
+        void sort(Compare comp);
+        void reverse();
 
         //
         // Status - Finished
@@ -101,19 +175,92 @@ namespace custom
         bool empty()  const { return size() == 0; }
         size_t size() const { return numElements; }
 
+        //
+        // Checkpoints - opt in to a mark every interval nodes, so the
+        // list can be cut into pieces of about that size without a
+        // walk. Segment i runs from segment(i) to segment(i + 1)
+        //
+
+        void set_checkpoint_interval(size_t interval);
+        size_t checkpoint_interval() const { return pCheckpoints ? pCheckpoints->interval : 0; }
+        size_t num_segments() const;
+        iterator segment(size_t i);
+        const_iterator segment(size_t i) const;
 
 #ifdef DEBUG // make this visible to the unit tests
     public:
 #else
     private:
 #endif
+        // the hash builds its buckets a node at a time
+        template <typename U>
+        friend class unordered_set;
+
         // nested linked list class
         class Node;
 
+        void link_back(Node* pNew);
+        iterator link_chain(iterator it, Node* pFirst, Node* pLast, size_t num);
+        void truncate(Node* p, size_t numKept);
+        template <class Iterator>
+        iterator insert_n(iterator it, Iterator first, size_t num);
+        template <class Iterator>
+        void assign_n(Iterator first, size_t num);
+        template <class Iterator>
+        iterator insert_range(iterator it, Iterator first, Iterator last, std::true_type);
+        template <class Iterator>
+        iterator insert_range(iterator it, Iterator first, Iterator last, std::false_type);
+
+        // the same value over and over, so a fill goes through insert_n
+        struct Repeat
+        {
+            const T* p;
+            const T& operator * () const { return *p; }
+            Repeat& operator ++ () { return *this; }
+        };
+
+        void relink_prev();
+        template <class Compare>
+        static void merge_chains(Node*& pLeft, Node* pRight, Compare& comp);
+
+        // the marks are only ever moved forward, dropped, or laid anew,
+        // so each change below costs O(1) unless it drops a mark. They
+        // always follow the list's order: whatever would break that
+        // lays them again on the spot, so reading them never writes
+        struct Checkpoints
+        {
+            static const size_t NONE = (size_t)-1;
+
+            size_t interval;                // the nodes wanted per segment
+            std::vector<Node*> marks;       // the first node of every segment but the first
+            std::vector<size_t> index;      // where each mark is in marks, by its address
+            size_t numLast;                 // nodes in the last segment
+            size_t numDrift;                // nodes put in or taken out away from the back
+
+            size_t find(const Node* p) const;
+            void   add(size_t i);
+            void   remove(const Node* p);
+            void   reindex();
+            size_t home(const Node* p) const
+            {
+                return (size_t)(reinterpret_cast<uintptr_t>(p) / sizeof(Node)) & (index.size() - 1);
+            }
+        };
+        void checkpoint_back(Node* p);
+        void checkpoint_insert(Node* pFirst, Node* pLast, size_t num);
+        void checkpoint_erase(Node* p);
+        void checkpoint_balance()
+        {
+            if (pCheckpoints && pCheckpoints->numDrift * 2 > numElements)
+                checkpoint_relay();
+        }
+        void checkpoint_relay();
+
         // member variables
         size_t numElements; // though we could count, it is faster to keep a variable
         Node* pHead;    // pointer to the beginning of the list
         Node* pTail;    // pointer to the ending of the list
+        Checkpoints* pCheckpoints;  // null unless asked for
     };
 
     /*************************************************
@@ -134,6 +281,22 @@ namespace custom
         Node(const T& data) : pNext(nullptr), pPrev(nullptr), data(data) { } // Copy Constructor
         Node(T&& data) : pNext(nullptr), pPrev(nullptr), data(std::move(data)) { } // Move Constructor
 
+        //
+        // Allocate - nodes come from a per-thread pool so freed
+        // storage is handed back out before we go to the heap again
+        //
+
+        static void* operator new (size_t size)
+        {
+            assert(size == sizeof(Node));
+            return node_pool<Node>::allocate();
+        }
+        static void* operator new (size_t, void* p) noexcept { return p; }
+        static void  operator delete (void* p) noexcept { node_pool<Node>::deallocate(p); }
+        static void  operator delete (void*, void*) noexcept { }
+        static Node* carve(size_t& num) { return node_pool<Node>::carve(num); }
+        static void  release(Node* pFirst, Node* pLast, size_t num) noexcept;
+
        //
        // Data
        //
@@ -143,6 +306,29 @@ namespace custom
         Node* pPrev;       // pointer to previous node
     };
 
+    /*************************************************
+     * NODE :: RELEASE
+     * Destroy a whole chain [pFirst, pLast] of num nodes that
+     * is already unlinked from its list, then give it back to
+     * the pool
+     *     COST   : O(n) with respect to the chain,
+     *              O(1) when T is trivially destructible
+     *************************************************/
+    template <typename T>
+    void list <T> ::Node::release(Node* pFirst, Node* pLast, size_t num) noexcept
+    {
+        if (pFirst == nullptr)
+            return;
+        if (!std::is_trivially_destructible<T>::value)
+            for (Node* p = pFirst; ; p = p->pNext)
+            {
+                p->data.~T();
+                if (p == pLast)
+                    break;
+            }
+        node_pool<Node>::recycle(pFirst, pLast, num);
+    }
+
     /*************************************************
      * LIST ITERATOR - Finished
      * Iterate through a List, non-constant version
@@ -165,7 +351,7 @@ namespace custom
         bool operator == (const iterator& rhs) const { return rhs.p == p; }
 
         // dereference operator, fetch a node
-        T& operator * ()
+        T& operator * () const
         {
             return p->data;
         }
@@ -208,10 +394,13 @@ namespace custom
             return *this;
         }
 
-        // two friends who need to access p directly
+        // the list and the friends who need to access p directly
+        friend class list <T>;
+        friend class list <T> ::const_iterator;
         friend iterator list <T> ::insert(iterator it, const T& data);
         friend iterator list <T> ::insert(iterator it, T&& data);
         friend iterator list <T> ::erase(const iterator& it);
+        friend void list <T> ::splice(iterator it, list& rhs);
 
 #ifdef DEBUG // make this visible to the unit tests
     public:
@@ -222,6 +411,76 @@ namespace custom
         typename list <T> ::Node* p;
     };
 
+    /*************************************************
+     * LIST CONST ITERATOR
+     * Iterate through a List without changing it
+     ************************************************/
+    template <typename T>
+    class list <T> ::const_iterator
+    {
+    public:
+        const_iterator() { p = nullptr; }
+        const_iterator(const Node* pRHS) { p = pRHS; }
+        const_iterator(const iterator& rhs) { p = rhs.p; }
+        const_iterator(const const_iterator& rhs) { p = rhs.p; }
+        const_iterator& operator = (const const_iterator& rhs)
+        {
+            this->p = rhs.p;
+            return *this;
+        }
+
+        // equals, not equals operator
+        bool operator != (const const_iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const const_iterator& rhs) const { return rhs.p == p; }
+
+        // dereference operator, fetch a node
+        const T& operator * () const
+        {
+            return p->data;
+        }
+
+        // postfix increment
+        const_iterator operator ++ (int postfix)
+        {
+            const_iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        // prefix increment
+        const_iterator& operator ++ ()
+        {
+            p = p->pNext;
+            return *this;
+        }
+
+        // postfix decrement
+        const_iterator operator -- (int postfix)
+        {
+            const_iterator it(*this);
+            --(*this);
+            return it;
+        }
+
+        // prefix decrement
+        const_iterator& operator -- ()
+        {
+            if (p->pPrev)
+                p = p->pPrev;
+            return *this;
+        }
+
+        friend class list <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+
+        const typename list <T> ::Node* p;
+    };
+
     /*****************************************
      * LIST :: NON-DEFAULT constructors
      * Create a list initialized to a value
@@ -229,20 +488,10 @@ namespace custom
     template <typename T>
     list <T> ::list(size_t num, const T& t)
     {
-        if (num) {
-            Node* pPrevious = pHead = pTail = new Node(T(t));
-            pHead->pPrev = nullptr;
-
-            for (int i = 1; i < num; i++) {
-                Node* pNew = new Node(T(t));
-                pNew->pPrev = pPrevious;
-                pNew->pPrev->pNext = pNew;
-                pPrevious = pNew;
-            }
-            pPrevious->pNext = nullptr;
-            pTail = pPrevious;
-        }
-        numElements = num;
+        pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
+        numElements = 0;
+        insert(end(), num, t);
     }
 
     /*****************************************
@@ -250,17 +499,13 @@ namespace custom
      * Create a list initialized to a set of values
      ****************************************/
     template <typename T>
-    template <class Iterator>
+    template <class Iterator, class>
     list <T> ::list(Iterator first, Iterator last)
     {
-        /*pHead = pTail = nullptr;
-        numElements = 0;*/
-        auto it = first;
-        while (it != last)
-        {
-            push_back(*it);
-            it++;
-        }
+        pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
+        numElements = 0;
+        insert(end(), first, last);
     }
 
     /*****************************************
@@ -270,16 +515,10 @@ namespace custom
     template <typename T>
     list <T> ::list(const std::initializer_list<T>& il)
     {
-        /*numElements = 0;
-        pHead = pTail = nullptr;*/
-
-        if (il.size() > 0)
-        {
-            for (T const item : il)
-            {
-                push_back(item);
-            }
-        }
+        numElements = 0;
+        pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
+        insert(end(), il.begin(), il.end());
     }
 
     /*****************************************
@@ -289,20 +528,10 @@ namespace custom
     template <typename T>
     list <T> ::list(size_t num)
     {
-        if (num) {
-            Node* pPrevious = pHead = pTail = new Node(0);
-            pHead->pPrev = nullptr;
-
-            for (int i = 1; i < num; i++) {
-                Node* pNew = new Node(T(0));
-                pNew->pPrev = pPrevious;
-                pNew->pPrev->pNext = pNew;
-                pPrevious = pNew;
-            }
-            pPrevious->pNext = nullptr;
-            pTail = pPrevious;
-        }
-        numElements = num;
+        pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
+        numElements = 0;
+        insert(end(), num, T());
     }
 
     /*****************************************
@@ -313,18 +542,20 @@ namespace custom
     {
         numElements = 0;
         pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
     }
 
     /*****************************************
      * LIST :: COPY constructors - Alexander
      ****************************************/
     template <typename T>
-    list <T> ::list(list& rhs)
+    list <T> ::list(const list& rhs)
     {
         pHead = pTail = nullptr;
+        pCheckpoints = nullptr;
         numElements = 0;
+        set_checkpoint_interval(rhs.checkpoint_interval());
         *this = rhs;
-        
     }
 
     /*****************************************
@@ -337,10 +568,12 @@ namespace custom
         pHead = rhs.pHead;
         pTail = rhs.pTail;
         numElements = rhs.numElements;
+        pCheckpoints = rhs.pCheckpoints;
 
         rhs.pHead = nullptr;
         rhs.pTail = nullptr;
         rhs.numElements = 0;
+        rhs.pCheckpoints = nullptr;
     }
 
     /**********************************************
@@ -351,40 +584,10 @@ namespace custom
      *     COST   : O(n) with respect to the number of nodes
      *********************************************/
     template <typename T>
-    list <T>& list <T> :: operator = (list <T>& rhs)
+    list <T>& list <T> :: operator = (const list <T>& rhs)
     {
-        iterator itRHS = rhs.begin();
-        iterator itLHS = begin();
-        while (itRHS != rhs.end() && itLHS != end())
-        {
-            *itLHS = *itRHS;
-            ++itRHS;
-            ++itLHS;
-        }
-        if (itRHS != rhs.end()) {
-            while (itRHS != rhs.end()) {
-                push_back(*itRHS);
-                ++itRHS;
-            }
-        }
-        else if (rhs.size() == 0)
-        {
-            clear();
-        }
-        else if (itLHS != end())
-        {
-            Node* p = itLHS.p;
-            pTail = p->pPrev;
-            Node* pNext = p->pNext;
-            while (p) {
-                pNext = p->pNext;
-                delete p;
-                p = pNext;
-                numElements--;
-            }
-            pTail->pNext = NULL;
-        }
-
+        if (this != &rhs)
+            assign_n(rhs.begin(), rhs.size());
         return *this;
     }
 
@@ -414,43 +617,78 @@ namespace custom
     template <typename T>
     list <T>& list <T> :: operator = (const std::initializer_list<T>& rhs)
     {
-        if (rhs.size() == 0)
-            return *this;
+        assign(rhs.begin(), rhs.end());
+        return *this;
+    }
 
-        const int* itRHS = rhs.begin();
-        iterator itLHS = begin();
-        while (itRHS != rhs.end() && itLHS != end())
-        {
-            *itLHS = *itRHS;
-            ++itRHS;
-            ++itLHS;
-        }
-        if (itRHS != rhs.end()) {
-            while (itRHS != rhs.end()) {
-                push_back(*itRHS);
-                ++itRHS;
-            }
-        }
-        else if (rhs.size() == 0)
-        {
-            clear();
-        }
-        else if (itLHS != end())
-        {
-            Node* p = itLHS.p;
-            pTail = p->pPrev;
-            Node* pNext = p->pNext;
-            while (p) {
-                pNext = p->pNext;
-                delete p;
-                p = pNext;
-                numElements--;
-            }
-            pTail->pNext = NULL;
-        }
+    /**********************************************
+     * LIST :: ASSIGN
+     * Make the list num copies of t, or a copy of a range. The
+     * nodes already here are written over; what more is needed
+     * is carved in blocks, and what is left over is freed
+     *     INPUT  : the new contents
+     *     COST   : O(n), one allocation per chunk when the count is known
+     *********************************************/
+    template <typename T>
+    void list <T> ::assign(size_t num, const T& t)
+    {
+        Repeat repeat = { &t };
+        assign_n(repeat, num);
+    }
+
+    template <typename T>
+    template <class Iterator, class>
+    void list <T> ::assign(Iterator first, Iterator last)
+    {
+        Node* p = pHead;
+        size_t num = 0;
+        for (; p && first != last; p = p->pNext, ++first, num++)
+            p->data = *first;
 
+        if (first != last)
+            insert(end(), first, last);
+        else
+            truncate(p, num);
+    }
 
-        return *this;
+    template <typename T>
+    template <class Iterator>
+    void list <T> ::assign_n(Iterator first, size_t num)
+    {
+        Node* p = pHead;
+        size_t i = 0;
+        for (; p && i < num; p = p->pNext, ++first, i++)
+            p->data = *first;
+
+        if (i < num)
+            insert_n(end(), first, num - i);
+        else
+            truncate(p, num);
+    }
+
+    /**********************************************
+     * LIST :: TRUNCATE
+     * Free p and everything after it
+     *     INPUT  : the first node to go, and how many stay
+     *     COST   : O(n) with respect to the nodes freed,
+     *              O(1) when T is trivially destructible,
+     *              plus O(numKept) to lay any checkpoints again
+     *********************************************/
+    template <typename T>
+    void list <T> ::truncate(Node* p, size_t numKept)
+    {
+        if (p == nullptr)
+            return;
+        Node* pLast = pTail;
+        pTail = p->pPrev;
+        if (pTail)
+            pTail->pNext = nullptr;
+        else
+            pHead = nullptr;
+        Node::release(p, pLast, numElements - numKept);
+        numElements = numKept;
+        if (pCheckpoints)
+            checkpoint_relay();
     }
 
     /**********************************************
@@ -458,19 +696,18 @@ namespace custom
      * Remove all the items currently in the linked list
      *     INPUT  :
      *     OUTPUT :
-     *     COST   : O(n) with respect to the number of nodes
+     *     COST   : O(n) with respect to the number of nodes,
+     *              O(1) when T is trivially destructible
      *********************************************/
     template <typename T>
     void list <T> ::clear()
     {
-        while (pHead != NULL)
-        {
-            Node* pDelete = pHead;
-            pHead = pHead->pNext;
-            delete pDelete;
-        }
-        pTail = nullptr;
+        // hand the whole chain back at once
+        Node::release(pHead, pTail, numElements);
+        pHead = pTail = nullptr;
         numElements = 0;
+        if (pCheckpoints)
+            checkpoint_relay();
     }
 
     /*********************************************
@@ -483,21 +720,24 @@ namespace custom
     template <typename T>
     void list <T> ::push_back(const T& data)
     {
-        Node* pNew = new Node(data);
-        pNew->pPrev = pTail;
-        if (pTail)
-            pTail->pNext = pNew;
-        else
-            pHead = pNew;
-
-        pTail = pNew;
-        numElements++;
+        link_back(new Node(data));
     }
 
     template <typename T>
     void list <T> ::push_back(T&& data)
     {
-        Node* pNew = new Node(data);
+        link_back(new Node(std::move(data)));
+    }
+
+    /*********************************************
+     * LIST :: LINK BACK
+     * hang a node that is already built off the end
+     *    INPUT  : the node, which now belongs to the list
+     *    COST   : O(1)
+     *********************************************/
+    template <typename T>
+    void list <T> ::link_back(Node* pNew)
+    {
         pNew->pPrev = pTail;
         if (pTail)
             pTail->pNext = pNew;
@@ -506,7 +746,41 @@ namespace custom
 
         pTail = pNew;
         numElements++;
+        if (pCheckpoints)
+            checkpoint_back(pNew);
+    }
+
+    /*********************************************
+     * LIST :: LINK CHAIN
+     * hang a chain of nodes that is already built in front of it
+     *    INPUT  : where it goes, and the chain, which now
+     *             belongs to the list
+     *    OUTPUT : an iterator to the first of the chain
+     *    COST   : O(1)
+     *********************************************/
+    template <typename T>
+    typename list <T> ::iterator list <T> ::link_chain(iterator it, Node* pFirst, Node* pLast, size_t num)
+    {
+        if (num == 0)
+            return it;
+
+        Node* pNext = it.p;
+        Node* pPrev = pNext ? pNext->pPrev : pTail;
+        pFirst->pPrev = pPrev;
+        pLast->pNext = pNext;
+        if (pPrev)
+            pPrev->pNext = pFirst;
+        else
+            pHead = pFirst;
+        if (pNext)
+            pNext->pPrev = pLast;
+        else
+            pTail = pLast;
 
+        numElements += num;
+        if (pCheckpoints)
+            checkpoint_insert(pFirst, pLast, num);
+        return iterator(pFirst);
     }
 
     /*********************************************
@@ -532,6 +806,8 @@ namespace custom
                 pHead = pNew;
             }
             numElements++;
+            if (pCheckpoints)
+                checkpoint_insert(pNew, pNew, 1);
         }
     }
 
@@ -551,6 +827,8 @@ namespace custom
                 pHead = pNew;
             }
             numElements++;
+            if (pCheckpoints)
+                checkpoint_insert(pNew, pNew, 1);
         }
     }
 
@@ -567,20 +845,17 @@ namespace custom
     {
         if (!empty())
         {
-            if (numElements <= 1) {
-                pTail = pHead = nullptr;
-            }
-            else {
-                Node* pNew = pHead;
-
-                while (pNew != nullptr) {
-                    if (pNew->pNext == pTail)
-                        pNew->pNext = nullptr;
-                    pNew = pNew->pNext;
-                }
-                pTail = pTail->pPrev;
-            }
+            Node* pDelete = pTail;
+            if (pCheckpoints)
+                checkpoint_erase(pDelete);
+            pTail = pTail->pPrev;
+            if (pTail)
+                pTail->pNext = nullptr;
+            else
+                pHead = nullptr;
+            delete pDelete;
             numElements--;
+            checkpoint_balance();
         }
     }
 
@@ -596,20 +871,17 @@ namespace custom
     {
         if (!empty())
         {
-            if (numElements == 1 || numElements == NULL) {
-                pTail = pHead = nullptr;
-            }
-            else {
-                Node* pNew = pTail;
-
-                while (pNew != nullptr) {
-                    if (pNew->pPrev == pHead)
-                        pNew->pPrev = nullptr;
-                    pNew = pNew->pPrev;
-                }
-                pHead = pHead->pNext;
-            }
-            numElements > 0 ? numElements-- : 0;
+            Node* pDelete = pHead;
+            if (pCheckpoints)
+                checkpoint_erase(pDelete);
+            pHead = pHead->pNext;
+            if (pHead)
+                pHead->pPrev = nullptr;
+            else
+                pTail = nullptr;
+            delete pDelete;
+            numElements--;
+            checkpoint_balance();
         }
     }
 
@@ -658,6 +930,8 @@ namespace custom
         iterator itNext = end();
         if (it.p != nullptr)
         {
+            if (pCheckpoints)
+                checkpoint_erase(it.p);
             if (it.p->pNext)
             {
                 it.p->pNext->pPrev = it.p->pPrev;
@@ -680,41 +954,216 @@ namespace custom
             }
             delete it.p;
             numElements--;
+            checkpoint_balance();
         }
         return itNext;
     }
 
     /******************************************
-     * LIST :: INSERT
-     * add an item to the middle of the list
-     *     INPUT  : data to be added to the list
-     *              an iterator to the location where it is to be inserted
-     *     OUTPUT : iterator to the new item
-     *     COST   : O(1)
+     * LIST :: REMOVE RANGE
+     * remove the items [first, last) with one unlink
+     *     INPUT  : an iterator to the first item being removed
+     *              an iterator to the item after the last one
+     *     OUTPUT : last
+     *     COST   : O(n) with respect to the items removed
      ******************************************/
     template <typename T>
-    typename list <T> ::iterator list <T> ::insert(list <T> ::iterator it,
-        const T& data)
+    typename list <T> ::iterator list <T> ::erase(const list <T> ::const_iterator& first,
+        const list <T> ::const_iterator& last)
     {
-        Node* pNew = new Node(data);
+        // we own the nodes, so we may change them
+        Node* pNext = const_cast<Node*>(last.p);
+        if (first.p == nullptr || first.p == pNext)
+            return iterator(pNext);
+
+        // the chain being removed is [pFirst, pLast]
+        Node* pFirst = const_cast<Node*>(first.p);
+        Node* pLast = pNext ? pNext->pPrev : pTail;
+        size_t num = 1;
+        for (Node* p = pFirst; p != pLast; p = p->pNext)
+            num++;
+        if (pCheckpoints)
+            for (Node* p = pFirst; p != pNext; p = p->pNext)
+                checkpoint_erase(p);
+
+        if (pFirst->pPrev)
+            pFirst->pPrev->pNext = pNext;
+        else
+            pHead = pNext;
+        if (pNext)
+            pNext->pPrev = pFirst->pPrev;
+        else
+            pTail = pFirst->pPrev;
 
-        if (numElements == 0)
+        numElements -= num;
+        Node::release(pFirst, pLast, num);
+        checkpoint_balance();
+        return iterator(pNext);
+    }
+
+    /******************************************
+     * LIST :: REMOVE IF
+     * remove every item the predicate picks in one pass. The
+     * removed nodes are gathered into a chain and freed together.
+     * Should pred throw, those picked before it are still removed
+     *     INPUT  : pred(data) is true for the items to remove
+     *     OUTPUT : the number of items removed
+     *     COST   : O(n)
+     ******************************************/
+    template <typename T>
+    template <class Predicate>
+    size_t list <T> ::remove_if(Predicate pred)
+    {
+        Node* pFirst = nullptr;   // the removed nodes
+        Node* pLast = nullptr;
+        size_t num = 0;
+
+        std::exception_ptr error;
+        try
         {
-            numElements = 1;
-            pHead = pTail = pNew;
-            return begin();
+            Node* p = pHead;
+            while (p)
+            {
+                Node* pNext = p->pNext;
+                if (pred(p->data))
+                {
+                    if (p->pPrev)
+                        p->pPrev->pNext = p->pNext;
+                    else
+                        pHead = p->pNext;
+                    if (p->pNext)
+                        p->pNext->pPrev = p->pPrev;
+                    else
+                        pTail = p->pPrev;
+
+                    if (pLast)
+                        pLast->pNext = p;
+                    else
+                        pFirst = p;
+                    pLast = p;
+                    num++;
+                }
+                p = pNext;
+            }
         }
-
-        if (it.p)
+        catch (...)
         {
-            pNew->pNext = it.p;
-            pNew->pPrev = it.p->pPrev;
-            it.p->pPrev = pNew;
+            error = std::current_exception();
+        }
 
-            if (pNew->pPrev)
-                pNew->pPrev->pNext = pNew;
+        numElements -= num;
+        Node::release(pFirst, pLast, num);
+        if (num && pCheckpoints)
+            checkpoint_relay();
+        if (error)
+            std::rethrow_exception(error);
+        return num;
+    }
 
-            if (it.p == pHead)
+    /******************************************
+     * LIST :: REMOVE
+     * remove every item equal to data
+     *     INPUT  : the value to remove
+     *     OUTPUT : the number of items removed
+     *     COST   : O(n)
+     ******************************************/
+    template <typename T>
+    size_t list <T> ::remove(const T& data)
+    {
+        // nodes are freed only after the pass, so data may be one of them
+        return remove_if([&data](const T& value) { return value == data; });
+    }
+
+    /******************************************
+     * LIST :: UNIQUE
+     * remove every item equal to the one before it, so a sorted
+     * list keeps one of each. Freed together, and kept removed
+     * should eq throw, like remove_if
+     *     INPUT  : eq(previous, item) is true for the items to remove
+     *     OUTPUT : the number of items removed
+     *     COST   : O(n)
+     ******************************************/
+    template <typename T>
+    template <class BinaryPredicate>
+    size_t list <T> ::unique(BinaryPredicate eq)
+    {
+        Node* pFirst = nullptr;   // the removed nodes
+        Node* pLast = nullptr;
+        size_t num = 0;
+
+        std::exception_ptr error;
+        try
+        {
+            for (Node* p = pHead; p && p->pNext; )
+            {
+                Node* pDup = p->pNext;
+                if (!eq(p->data, pDup->data))
+                {
+                    p = pDup;
+                    continue;
+                }
+
+                p->pNext = pDup->pNext;
+                if (pDup->pNext)
+                    pDup->pNext->pPrev = p;
+                else
+                    pTail = p;
+
+                if (pLast)
+                    pLast->pNext = pDup;
+                else
+                    pFirst = pDup;
+                pLast = pDup;
+                num++;
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        numElements -= num;
+        Node::release(pFirst, pLast, num);
+        if (num && pCheckpoints)
+            checkpoint_relay();
+        if (error)
+            std::rethrow_exception(error);
+        return num;
+    }
+
+    /******************************************
+     * LIST :: INSERT
+     * add an item to the middle of the list
+     *     INPUT  : data to be added to the list
+     *              an iterator to the location where it is to be inserted
+     *     OUTPUT : iterator to the new item
+     *     COST   : O(1)
+     ******************************************/
+    template <typename T>
+    typename list <T> ::iterator list <T> ::insert(list <T> ::iterator it,
+        const T& data)
+    {
+        Node* pNew = new Node(data);
+
+        if (numElements == 0)
+        {
+            numElements = 1;
+            pHead = pTail = pNew;
+            if (pCheckpoints)
+                checkpoint_insert(pNew, pNew, 1);
+            return begin();
+        }
+
+        if (it.p)
+        {
+            pNew->pNext = it.p;
+            pNew->pPrev = it.p->pPrev;
+            it.p->pPrev = pNew;
+
+            if (pNew->pPrev)
+                pNew->pPrev->pNext = pNew;
+
+            if (it.p == pHead)
                 pHead = pNew;
         }
         else
@@ -725,6 +1174,8 @@ namespace custom
         }
 
         numElements++;
+        if (pCheckpoints)
+            checkpoint_insert(pNew, pNew, 1);
         return iterator(pNew);
         /*return end();*/
     }
@@ -739,6 +1190,8 @@ namespace custom
         {
             numElements = 1;
             pHead = pTail = pNew;
+            if (pCheckpoints)
+                checkpoint_insert(pNew, pNew, 1);
             return begin();
         }
 
@@ -762,10 +1215,615 @@ namespace custom
         }
 
         numElements++;
+        if (pCheckpoints)
+            checkpoint_insert(pNew, pNew, 1);
         return iterator(pNew);
         /*return end();*/
     }
     
+    /******************************************
+     * LIST :: INSERT a range
+     * add num copies of data, or a copy of a range, in front of it.
+     * When the count is known the nodes are carved from as few
+     * blocks as the pool's chunks allow and linked in one pass; otherwise they are made one
+     * at a time. Either way the chain is built off to the side and
+     * hung in at the end, so a copy that throws leaves the list as
+     * it was
+     *     INPUT  : where to put them, and what
+     *     OUTPUT : iterator to the first new item, or it if none
+     *     COST   : O(n), one allocation per chunk when the count is known
+     ******************************************/
+    template <typename T>
+    typename list <T> ::iterator list <T> ::insert(iterator it, size_t num, const T& data)
+    {
+        Repeat repeat = { &data };
+        return insert_n(it, repeat, num);
+    }
+
+    template <typename T>
+    template <class Iterator, class>
+    typename list <T> ::iterator list <T> ::insert(iterator it, Iterator first, Iterator last)
+    {
+        return insert_range(it, first, last, is_forward_iterator<Iterator>());
+    }
+
+    template <typename T>
+    template <class Iterator>
+    typename list <T> ::iterator list <T> ::insert_range(iterator it, Iterator first, Iterator last,
+                                                         std::true_type)
+    {
+        return insert_n(it, first, (size_t)std::distance(first, last));
+    }
+
+    template <typename T>
+    template <class Iterator>
+    typename list <T> ::iterator list <T> ::insert_range(iterator it, Iterator first, Iterator last,
+                                                         std::false_type)
+    {
+        Node* pFirst = nullptr;
+        Node* pLast = nullptr;
+        size_t num = 0;
+        try
+        {
+            for (; first != last; ++first, num++)
+            {
+                Node* pNew = new Node(*first);
+                pNew->pPrev = pLast;
+                if (pLast)
+                    pLast->pNext = pNew;
+                else
+                    pFirst = pNew;
+                pLast = pNew;
+            }
+        }
+        catch (...)
+        {
+            Node::release(pFirst, pLast, num);
+            throw;
+        }
+        return link_chain(it, pFirst, pLast, num);
+    }
+
+    template <typename T>
+    template <class Iterator>
+    typename list <T> ::iterator list <T> ::insert_n(iterator it, Iterator first, size_t num)
+    {
+        if (num == 0)
+            return it;
+
+        // a block at a time, as big as the pool's chunks allow
+        Node* pFirst = nullptr;
+        Node* pLast = nullptr;
+        size_t numBuilt = 0;
+        while (numBuilt < num)
+        {
+            size_t numBlock = num - numBuilt;
+            Node* pBlock = Node::carve(numBlock);
+            for (size_t i = 0; i < numBlock; i++, ++first)
+            {
+                try
+                {
+                    new (pBlock + i) Node(*first);
+                }
+                catch (...)
+                {
+                    // destroy what was built; the rest still belongs to the pool
+                    for (; i < numBlock; i++)
+                        Node::operator delete(pBlock + i);
+                    Node::release(pFirst, pLast, numBuilt);
+                    throw;
+                }
+                pBlock[i].pPrev = pLast;
+                if (pLast)
+                    pLast->pNext = pBlock + i;
+                else
+                    pFirst = pBlock + i;
+                pLast = pBlock + i;
+                numBuilt++;
+            }
+        }
+        return link_chain(it, pFirst, pLast, num);
+    }
+
+    /******************************************
+     * LIST :: SPLICE
+     * move every node of another list in front of an item
+     * in this one. Nothing is allocated or copied
+     *     INPUT  : an iterator to the location where they go
+     *              the list to take the nodes from (left empty)
+     *     OUTPUT :
+     *     COST   : O(1)
+     ******************************************/
+    template <typename T>
+    void list <T> ::splice(list <T> ::iterator it, list <T>& rhs)
+    {
+        if (rhs.pHead == nullptr || &rhs == this)
+            return;
+
+        if (it.p == nullptr)
+        {
+            // on to the end
+            rhs.pHead->pPrev = pTail;
+            if (pTail)
+                pTail->pNext = rhs.pHead;
+            else
+                pHead = rhs.pHead;
+            pTail = rhs.pTail;
+        }
+        else
+        {
+            // in front of it
+            rhs.pHead->pPrev = it.p->pPrev;
+            rhs.pTail->pNext = it.p;
+            if (it.p->pPrev)
+                it.p->pPrev->pNext = rhs.pHead;
+            else
+                pHead = rhs.pHead;
+            it.p->pPrev = rhs.pTail;
+        }
+
+        // our marks are still in order, with one segment longer
+        numElements += rhs.numElements;
+        if (pCheckpoints)
+            pCheckpoints->numDrift += rhs.numElements;
+        rhs.pHead = rhs.pTail = nullptr;
+        rhs.numElements = 0;
+        checkpoint_balance();
+        if (rhs.pCheckpoints)
+            rhs.checkpoint_relay();
+    }
+
+    /******************************************
+     * LIST :: MERGE
+     * move every node of another sorted list into this sorted
+     * one, keeping it sorted. On a tie ours come first. Should
+     * comp throw, we still end up with every node, though no
+     * longer sorted, and rhs is left empty all the same
+     *     INPUT  : the list to take the nodes from (left empty)
+     *              comp(a, b) is true when a goes before b
+     *     OUTPUT :
+     *     COST   : O(n + m), relinking only
+     ******************************************/
+    template <typename T>
+    template <class Compare>
+    void list <T> ::merge(list <T>& rhs, Compare comp)
+    {
+        if (rhs.pHead == nullptr || &rhs == this)
+            return;
+
+        std::exception_ptr error;
+        try
+        {
+            merge_chains(pHead, rhs.pHead, comp);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        relink_prev();
+        numElements += rhs.numElements;
+        rhs.pHead = rhs.pTail = nullptr;
+        rhs.numElements = 0;
+        if (pCheckpoints)
+            checkpoint_relay();
+        if (rhs.pCheckpoints)
+            rhs.checkpoint_relay();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /******************************************
+     * LIST :: SORT
+     * a stable bottom-up merge sort. Nodes are taken off the
+     * front one at a time; bins[i] holds a sorted run of 2^i of
+     * them, and a new run carries up the bins like a binary
+     * counter. Only pNext is touched until the end, when one pass
+     * puts pPrev back. Every node is always in p or in a bin, so
+     * should comp throw they are all chained back up, in no
+     * particular order, before it goes on
+     *     INPUT  : comp(a, b) is true when a goes before b
+     *     OUTPUT :
+     *     COST   : O(n log n), and no allocation at all
+     ******************************************/
+    template <typename T>
+    template <class Compare>
+    void list <T> ::sort(Compare comp)
+    {
+        if (numElements < 2)
+            return;
+
+        Node* bins[64] = {};   // enough for 2^64 nodes
+        Node* p = pHead;
+        std::exception_ptr error;
+        try
+        {
+            while (p)
+            {
+                Node* pRun = p;
+                p = p->pNext;
+                pRun->pNext = nullptr;
+
+                // the bins hold older nodes, so they go on the left
+                size_t i = 0;
+                for (; bins[i]; i++)
+                {
+                    merge_chains(bins[i], pRun, comp);
+                    pRun = bins[i];
+                    bins[i] = nullptr;
+                }
+                bins[i] = pRun;
+            }
+
+            // the higher the bin, the older its nodes, so each takes
+            // the ones below it on its right until the last holds all
+            for (size_t i = 0; i + 1 < 64; i++)
+            {
+                Node* pRun = bins[i];
+                bins[i] = nullptr;
+                if (pRun)
+                    merge_chains(bins[i + 1], pRun, comp);
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        // gather what is left, which is only bins[63] unless comp threw
+        pHead = p;
+        for (Node* pBin : bins)
+            if (pBin)
+            {
+                Node* pLast = pBin;
+                while (pLast->pNext)
+                    pLast = pLast->pNext;
+                pLast->pNext = pHead;
+                pHead = pBin;
+            }
+        relink_prev();
+        if (pCheckpoints)
+            checkpoint_relay();
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    /******************************************
+     * LIST :: REVERSE
+     * swap every node's links, then the ends
+     *     COST   : O(n)
+     ******************************************/
+    template <typename T>
+    void list <T> ::reverse()
+    {
+        for (Node* p = pHead; p; p = p->pPrev)
+            std::swap(p->pNext, p->pPrev);
+        std::swap(pHead, pTail);
+        if (pCheckpoints)
+            checkpoint_relay();
+    }
+
+    /******************************************
+     * LIST :: MERGE CHAINS
+     * merge the sorted chain pRight, linked through pNext alone,
+     * into the sorted chain pLeft. Left wins a tie, which is what
+     * makes sort stable. If comp throws, what is left of both is
+     * hung off the end as it stands, so pLeft still holds every node
+     ******************************************/
+    template <typename T>
+    template <class Compare>
+    void list <T> ::merge_chains(Node*& pLeft, Node* pRight, Compare& comp)
+    {
+        Node* pFirst = nullptr;
+        Node** ppLast = &pFirst;
+        Node* pL = pLeft;
+        try
+        {
+            while (pL && pRight)
+            {
+                if (comp(pRight->data, pL->data))
+                {
+                    *ppLast = pRight;
+                    pRight = pRight->pNext;
+                }
+                else
+                {
+                    *ppLast = pL;
+                    pL = pL->pNext;
+                }
+                ppLast = &(*ppLast)->pNext;
+            }
+        }
+        catch (...)
+        {
+            *ppLast = pL;
+            while (*ppLast)
+                ppLast = &(*ppLast)->pNext;
+            *ppLast = pRight;
+            pLeft = pFirst;
+            throw;
+        }
+        *ppLast = pL ? pL : pRight;
+        pLeft = pFirst;
+    }
+
+    /******************************************
+     * LIST :: RELINK PREV
+     * rebuild every pPrev, and pTail, from the pNext chain
+     ******************************************/
+    template <typename T>
+    void list <T> ::relink_prev()
+    {
+        Node* pPrev = nullptr;
+        for (Node* p = pHead; p; p = p->pNext)
+        {
+            p->pPrev = pPrev;
+            pPrev = p;
+        }
+        pTail = pPrev;
+    }
+
+    /******************************************
+     * LIST :: SET CHECKPOINT INTERVAL
+     * start keeping a mark every interval nodes, or stop with 0.
+     * The marks cost one pointer in a vector and two or so slots of
+     * an index by address per interval nodes, and nothing at all
+     * when they are off
+     *     INPUT  : the nodes wanted per segment, or 0
+     *     COST   : O(n) to lay the marks
+     ******************************************/
+    template <typename T>
+    void list <T> ::set_checkpoint_interval(size_t interval)
+    {
+        if (interval == 0)
+        {
+            delete pCheckpoints;
+            pCheckpoints = nullptr;
+            return;
+        }
+        if (pCheckpoints == nullptr)
+            pCheckpoints = new Checkpoints;
+        pCheckpoints->interval = interval;
+        checkpoint_relay();
+    }
+
+    /******************************************
+     * LIST :: NUM SEGMENTS
+     * how many pieces the marks cut the list into: one without
+     * them. Whatever changed the list already kept the marks in
+     * order, so this only reads and two readers may ask at once
+     *     COST   : O(1)
+     ******************************************/
+    template <typename T>
+    size_t list <T> ::num_segments() const
+    {
+        return pCheckpoints ? pCheckpoints->marks.size() + 1 : 1;
+    }
+
+    /******************************************
+     * LIST :: SEGMENT
+     * where segment i begins, or end() for i == num_segments()
+     *     COST   : O(1)
+     ******************************************/
+    template <typename T>
+    typename list <T> ::iterator list <T> ::segment(size_t i)
+    {
+        if (i == 0)
+            return begin();
+        if (pCheckpoints == nullptr || i > pCheckpoints->marks.size())
+            return end();
+        return iterator(pCheckpoints->marks[i - 1]);
+    }
+
+    template <typename T>
+    typename list <T> ::const_iterator list <T> ::segment(size_t i) const
+    {
+        if (i == 0)
+            return begin();
+        if (pCheckpoints == nullptr || i > pCheckpoints->marks.size())
+            return end();
+        return const_iterator(pCheckpoints->marks[i - 1]);
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINT RELAY
+     * lay the marks from scratch: every interval-th node. Called
+     * when the list is reordered, or once too much has been put in
+     * or taken out away from the back; the walk is then paid for
+     * by the n / 2 changes it took to get there
+     *     COST   : O(n)
+     ******************************************/
+    template <typename T>
+    void list <T> ::checkpoint_relay()
+    {
+        Checkpoints& c = *pCheckpoints;
+        c.marks.clear();
+        c.numLast = 0;
+        c.numDrift = 0;
+        for (Node* p = pHead; p; p = p->pNext)
+        {
+            if (c.numLast == c.interval)
+            {
+                c.marks.push_back(p);
+                c.numLast = 0;
+            }
+            c.numLast++;
+        }
+        c.reindex();
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINT BACK
+     * p was just linked on the end: start a segment with it if the
+     * last one is full
+     *     COST   : O(1)
+     ******************************************/
+    template <typename T>
+    void list <T> ::checkpoint_back(Node* p)
+    {
+        Checkpoints& c = *pCheckpoints;
+        if (c.numLast >= c.interval)
+        {
+            c.marks.push_back(p);
+            c.add(c.marks.size() - 1);
+            c.numLast = 0;
+        }
+        c.numLast++;
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINT INSERT
+     * the chain [pFirst, pLast] of num nodes was just linked in. On
+     * the end they are marked as they come; anywhere else they only
+     * make some segment longer
+     *     COST   : O(num) on the end, otherwise O(1)
+     ******************************************/
+    template <typename T>
+    void list <T> ::checkpoint_insert(Node* pFirst, Node* pLast, size_t num)
+    {
+        if (pLast != pTail)
+        {
+            pCheckpoints->numDrift += num;
+            checkpoint_balance();
+            return;
+        }
+        for (Node* p = pFirst; p; p = p->pNext)
+            checkpoint_back(p);
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINT ERASE
+     * p is about to be unlinked. A mark on it moves to the node
+     * after, unless that would leave its segment empty
+     *     COST   : O(1) expected, or O(n / interval) when p is a
+     *              mark and the node after is one too
+     ******************************************/
+    template <typename T>
+    void list <T> ::checkpoint_erase(Node* p)
+    {
+        Checkpoints& c = *pCheckpoints;
+        size_t i = c.find(p);
+        if (i == Checkpoints::NONE)
+        {
+            if (p == pTail && c.numLast > 0)
+                c.numLast--;
+            else
+                c.numDrift++;
+            return;
+        }
+
+        Node* pNext = p->pNext;
+        if (pNext == nullptr)
+        {
+            // the last segment was only p; the one before is full
+            c.remove(p);
+            c.marks.pop_back();
+            c.numLast = c.interval;
+        }
+        else if (c.find(pNext) != Checkpoints::NONE)
+        {
+            // every mark after p shifts down one place
+            c.marks.erase(c.marks.begin() + i);
+            c.reindex();
+        }
+        else
+        {
+            c.remove(p);
+            c.marks[i] = pNext;
+            c.add(i);
+            if (i + 1 == c.marks.size())
+                c.numLast--;
+            else
+                c.numDrift++;
+        }
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINTS :: FIND
+     * where the mark on p is in marks, or NONE if p is not one.
+     * The index is open addressing by the node's address, at most
+     * half full, so a probe is short
+     *     COST   : O(1) expected
+     ******************************************/
+    template <typename T>
+    size_t list <T> ::Checkpoints::find(const Node* p) const
+    {
+        if (index.empty())
+            return NONE;
+        for (size_t slot = home(p); index[slot] != NONE; slot = (slot + 1) & (index.size() - 1))
+            if (marks[index[slot]] == p)
+                return index[slot];
+        return NONE;
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINTS :: ADD
+     * marks[i] was just set: index it, growing the index first
+     * if it would be more than half full
+     *     COST   : O(1) amortized
+     ******************************************/
+    template <typename T>
+    void list <T> ::Checkpoints::add(size_t i)
+    {
+        if (marks.size() * 2 > index.size())
+        {
+            reindex();
+            return;
+        }
+        size_t slot = home(marks[i]);
+        while (index[slot] != NONE)
+            slot = (slot + 1) & (index.size() - 1);
+        index[slot] = i;
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINTS :: REMOVE
+     * forget the mark on p, which is still in marks. The entries
+     * after it in its run move back so no probe stops early
+     *     COST   : O(1) expected
+     ******************************************/
+    template <typename T>
+    void list <T> ::Checkpoints::remove(const Node* p)
+    {
+        size_t mask = index.size() - 1;
+        size_t hole = home(p);
+        while (marks[index[hole]] != p)
+            hole = (hole + 1) & mask;
+        for (size_t slot = (hole + 1) & mask; index[slot] != NONE; slot = (slot + 1) & mask)
+        {
+            // an entry may fill the hole unless its home lies after the
+            // hole and at or before where it sits now
+            size_t want = home(marks[index[slot]]);
+            if (((slot - want) & mask) >= ((slot - hole) & mask))
+            {
+                index[hole] = index[slot];
+                hole = slot;
+            }
+        }
+        index[hole] = NONE;
+    }
+
+    /******************************************
+     * LIST :: CHECKPOINTS :: REINDEX
+     * build the index again for every mark, at most half full
+     *     COST   : O(n / interval)
+     ******************************************/
+    template <typename T>
+    void list <T> ::Checkpoints::reindex()
+    {
+        size_t size = 8;
+        while (size < marks.size() * 2)
+            size *= 2;
+        index.assign(size, size_t(NONE));
+        for (size_t i = 0; i < marks.size(); i++)
+        {
+            size_t slot = home(marks[i]);
+            while (index[slot] != NONE)
+                slot = (slot + 1) & (size - 1);
+            index[slot] = i;
+        }
+    }
+
     template <typename T>
     typename list <T> ::iterator list <T> ::find(const T& data)
     {
@@ -775,6 +1833,60 @@ namespace custom
         return end();
     }
 
+    /******************************************
+     * LIST :: FIND with a policy
+     * find an item, then move it toward the head as the policy
+     * says. Only links change, so every iterator stays valid
+     *     INPUT  : the item to find, and what to do when found
+     *     OUTPUT : an iterator to it, or end()
+     *     COST   : O(n) to find it, O(1) to move it
+     ******************************************/
+    template <typename T>
+    typename list <T> ::iterator list <T> ::find(const T& data, find_policy policy)
+    {
+        iterator it = find(data);
+        Node* p = it.p;
+        if (p == nullptr || p == pHead || policy == find_policy::stay)
+            return it;
+
+        Node* pBefore = policy == find_policy::move_to_front ? pHead : p->pPrev;
+        // a mark moved back would put the marks out of order
+        bool moveMark = pCheckpoints && pCheckpoints->find(p) != Checkpoints::NONE;
+        if (pCheckpoints && !moveMark)
+            pCheckpoints->numDrift++;
+
+        // take p out
+        p->pPrev->pNext = p->pNext;
+        if (p->pNext)
+            p->pNext->pPrev = p->pPrev;
+        else
+            pTail = p->pPrev;
+
+        // and put it back in front of pBefore
+        p->pNext = pBefore;
+        p->pPrev = pBefore->pPrev;
+        if (pBefore->pPrev)
+            pBefore->pPrev->pNext = p;
+        else
+            pHead = p;
+        pBefore->pPrev = p;
+
+        if (moveMark)
+            checkpoint_relay();
+        else
+            checkpoint_balance();
+        return it;
+    }
+
+    template <typename T>
+    typename list <T> ::const_iterator list <T> ::find(const T& data) const
+    {
+        for (auto it = begin(); it != end(); ++it)
+            if (*it == data)
+                return it;
+        return end();
+    }
+
     /**********************************************
      * LIST :: assignment operator - MOVE
      * Copy one list onto another
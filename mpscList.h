@@ -0,0 +1,259 @@
+/***********************************************************************
+ * Header:
+ *    MPSC LIST
+ * Summary:
+ *    A singly linked work queue for many producer threads and one
+ *    consumer thread, with no lock. A producer links its node in with
+ *    one atomic exchange on the head and then publishes the link, so
+ *    producers never wait on each other or on the consumer. The
+ *    consumer owns the tail: a pop is a load of the tail's successor
+ *    and no read-modify-write at all. The list always keeps one node
+ *    that has been popped as its tail, so the producers and the
+ *    consumer never touch the same node's links at once
+ *
+ *    Popped nodes go onto a free list the producers take them from, so
+ *    a queue that runs steadily stops allocating. The consumer hands
+ *    them back in batches, keeping its atomics off the common path
+ *
+ *    This will contain the class definition of:
+ *        mpsc_list : A multi-producer single-consumer queue
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::forward
+
+namespace custom
+{
+    /**************************************************
+     * MPSC LIST
+     * Any number of threads may push_back() at once. Only one
+     * thread at a time may call try_pop_front() or empty()
+     **************************************************/
+    template <typename T>
+    class mpsc_list
+    {
+    public:
+        //
+        // Construct - the list is where the threads meet, so it
+        // can neither be copied nor moved
+        //
+
+        mpsc_list() : pTail(new Node), pFreeBatch(nullptr), pFreeBatchLast(nullptr), numFreeBatch(0)
+        {
+            pHead.store(pTail, std::memory_order_relaxed);
+            pFree.store(nullptr, std::memory_order_relaxed);
+            freeBusy.clear();
+        }
+        mpsc_list(const mpsc_list&) = delete;
+        mpsc_list& operator = (const mpsc_list&) = delete;
+        ~mpsc_list();
+
+        //
+        // Insert - any thread
+        //
+
+        void push_back(const T& t) { emplace(t); }
+        void push_back(T&& t)      { emplace(std::move(t)); }
+
+        //
+        // Remove - the consumer only
+        //
+
+        bool try_pop_front(T& t);
+
+        //
+        // Status - the consumer only. A push that has swapped the
+        // head but not yet published its link is not seen
+        //
+
+        bool empty() const { return pTail->pNext.load(std::memory_order_acquire) == nullptr; }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        static const size_t FREE_BATCH = 32;   // nodes handed back at once
+
+        // the element lives in raw storage, so the node that is the
+        // tail holds none and T needs no default constructor
+        struct Node
+        {
+            Node() : pNext(nullptr) {}
+            T* data() { return reinterpret_cast<T*>(storage); }
+
+            std::atomic<Node*> pNext;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        template <class U>
+        void emplace(U&& u);
+        void link(Node* pNew);
+        Node* allocate();
+        void recycle(Node* p);
+        static void deleteChain(Node* p);
+
+        // producers swap this, on its own cache line
+        std::atomic<Node*> pHead;
+        char paddingHead[64 - sizeof(std::atomic<Node*>)];
+
+        // the consumer's, and only the consumer's
+        Node* pTail;                // popped already: its successor is next
+        Node* pFreeBatch;           // popped nodes not yet handed back
+        Node* pFreeBatchLast;
+        size_t numFreeBatch;
+        char paddingTail[64];
+
+        // shared by the producers, and refilled by the consumer
+        std::atomic<Node*> pFree;   // a stack of spare nodes
+        std::atomic_flag freeBusy;  // held by the one producer popping pFree
+    };
+
+    /*****************************************
+     * MPSC LIST :: EMPLACE
+     * Build the element in a node, then link the node in
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T>
+    template <class U>
+    void mpsc_list <T> ::emplace(U&& u)
+    {
+        Node* pNew = allocate();
+        try
+        {
+            new (pNew->storage) T(std::forward<U>(u));
+        }
+        catch (...)
+        {
+            delete pNew;
+            throw;
+        }
+        link(pNew);
+    }
+
+    /*****************************************
+     * MPSC LIST :: LINK
+     * Swap the new node in as the head, then point the old head at
+     * it. Until that second store the consumer sees the list end at
+     * the old head, which only delays this element
+     *     COST   : O(1), one exchange
+     ****************************************/
+    template <typename T>
+    void mpsc_list <T> ::link(Node* pNew)
+    {
+        pNew->pNext.store(nullptr, std::memory_order_relaxed);
+        Node* pPrev = pHead.exchange(pNew, std::memory_order_acq_rel);
+        pPrev->pNext.store(pNew, std::memory_order_release);
+    }
+
+    /*****************************************
+     * MPSC LIST :: TRY POP FRONT
+     * Move the element out of the tail's successor, which becomes
+     * the new tail, and recycle the old tail
+     *     INPUT  : where to put the element
+     *     OUTPUT : false if there was none to take
+     *     COST   : O(1), no read-modify-write
+     ****************************************/
+    template <typename T>
+    bool mpsc_list <T> ::try_pop_front(T& t)
+    {
+        Node* pNext = pTail->pNext.load(std::memory_order_acquire);
+        if (pNext == nullptr)
+            return false;
+
+        t = std::move(*pNext->data());
+        pNext->data()->~T();
+        Node* pOld = pTail;
+        pTail = pNext;
+        recycle(pOld);
+        return true;
+    }
+
+    /*****************************************
+     * MPSC LIST :: ALLOCATE
+     * A spare node if one is free and no other producer is taking
+     * one right now, otherwise a new node. Only the flag holder pops
+     * the free stack and the consumer only pushes onto it, so a node
+     * cannot leave and come back under a pop: there is no ABA
+     *     COST   : O(1), never waits
+     ****************************************/
+    template <typename T>
+    typename mpsc_list <T> ::Node* mpsc_list <T> ::allocate()
+    {
+        if (pFree.load(std::memory_order_relaxed) != nullptr &&
+            !freeBusy.test_and_set(std::memory_order_acquire))
+        {
+            Node* p = pFree.load(std::memory_order_acquire);
+            while (p && !pFree.compare_exchange_weak(p, p->pNext.load(std::memory_order_relaxed),
+                                                     std::memory_order_acquire, std::memory_order_acquire))
+                ;
+            freeBusy.clear(std::memory_order_release);
+            if (p)
+                return p;
+        }
+        return new Node;
+    }
+
+    /*****************************************
+     * MPSC LIST :: RECYCLE
+     * Keep a popped node in the consumer's batch, and push the whole
+     * batch onto the free stack once it is full
+     *     COST   : O(1), one CAS per FREE_BATCH nodes
+     ****************************************/
+    template <typename T>
+    void mpsc_list <T> ::recycle(Node* p)
+    {
+        p->pNext.store(pFreeBatch, std::memory_order_relaxed);
+        if (pFreeBatch == nullptr)
+            pFreeBatchLast = p;
+        pFreeBatch = p;
+        if (++numFreeBatch < FREE_BATCH)
+            return;
+
+        Node* pTop = pFree.load(std::memory_order_relaxed);
+        do
+            pFreeBatchLast->pNext.store(pTop, std::memory_order_relaxed);
+        while (!pFree.compare_exchange_weak(pTop, pFreeBatch,
+                                            std::memory_order_release, std::memory_order_relaxed));
+        pFreeBatch = pFreeBatchLast = nullptr;
+        numFreeBatch = 0;
+    }
+
+    /*****************************************
+     * MPSC LIST :: DESTRUCTOR
+     * No thread may be using the list. Destroy what was never popped
+     * and free every node
+     ****************************************/
+    template <typename T>
+    mpsc_list <T> ::~mpsc_list()
+    {
+        Node* p = pTail->pNext.load(std::memory_order_relaxed);
+        delete pTail;
+        while (p)
+        {
+            Node* pNext = p->pNext.load(std::memory_order_relaxed);
+            p->data()->~T();
+            delete p;
+            p = pNext;
+        }
+        deleteChain(pFreeBatch);
+        deleteChain(pFree.load(std::memory_order_relaxed));
+    }
+
+    template <typename T>
+    void mpsc_list <T> ::deleteChain(Node* p)
+    {
+        while (p)
+        {
+            Node* pNext = p->pNext.load(std::memory_order_relaxed);
+            delete p;
+            p = pNext;
+        }
+    }
+
+} // namespace custom
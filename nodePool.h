@@ -0,0 +1,402 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    Where list and forward_list get their nodes. Each thread keeps a
+ *    chain of free nodes of its own, so most allocations and frees
+ *    touch nothing shared, and nodes are carved out of chunks rather
+ *    than asked of the heap one at a time.
+ *
+ *    A thread that frees what another thread made - a consumer
+ *    draining a producer's queue, a reader dropping a writer's
+ *    snapshot - would otherwise pile up free nodes its producer never
+ *    sees. So a thread holding more than HIGH_WATER free nodes hands
+ *    the surplus to a shared depot, sorted by the chunk each came
+ *    from. A thread that runs dry takes from the depot before it
+ *    carves a new chunk, and a chunk whose every node is back in the
+ *    depot goes back to the heap.
+ *
+ *    A whole chain given back at once - a list or a hash cleared -
+ *    that would put a thread past HIGH_WATER goes to the depot as it
+ *    is, spliced on by its ends, so clear() stays O(1) however long
+ *    the chain. Those loose nodes are handed out before any chunk is
+ *    carved, and are sorted into their chunks a batch at a time as
+ *    threads spill, or all at once as a thread exits.
+ *
+ *    This will contain the class definition of:
+ *        node_pool : Per-thread free chains over shared, returnable chunks
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include <atomic>      // for std::atomic
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uintptr_t
+#include <mutex>       // for std::mutex
+#include <new>         // for ::operator new and std::align_val_t
+
+namespace custom
+{
+    // the smallest power of two, at least a page, that holds n bytes
+    constexpr size_t node_pool_fit(size_t n, size_t bytes = 4096)
+    {
+        return bytes >= n ? bytes : node_pool_fit(n, bytes * 2);
+    }
+
+    /**************************************************
+     * NODE POOL
+     * Raw storage for one type of node. Node must have a pNext
+     * link the pool may use while the node is free; it is the
+     * caller's job to run constructors and destructors
+     **************************************************/
+    template <class Node>
+    class node_pool
+    {
+    public:
+        static void* allocate();
+        static void  deallocate(void* p) noexcept;
+        static Node* carve(size_t& num);
+        static void  recycle(Node* pFirst, Node* pLast, size_t num) noexcept;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        // the start of every chunk. Everything but the link fields of
+        // the chunk a thread is carving is only touched under depotLock
+        struct Chunk
+        {
+            Node*  pFree;       // this chunk's nodes in the depot
+            size_t numFree;
+            size_t numCarved;   // nodes ever handed out, known once closed
+            bool   open;        // a thread is still carving from it
+            Chunk* pPrev;       // the chunks with nodes in the depot
+            Chunk* pNext;
+            void*  pRaw;        // what the heap returned, if aligned by hand
+        };
+
+        // what each thread keeps for itself
+        struct Cache
+        {
+            Node*  pFree;       // free nodes, linked through pNext
+            size_t numFree;
+            Chunk* pOpen;       // the chunk being carved, if any
+            size_t numCarved;   // nodes carved from it so far
+            ~Cache();
+        };
+
+        static const size_t MIN_NODES = 64;
+        static const size_t FIRST = (sizeof(Chunk) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+        static const size_t BYTES = node_pool_fit(FIRST + MIN_NODES * sizeof(Node));  // a chunk, and its alignment
+        static const size_t CAPACITY = (BYTES - FIRST) / sizeof(Node);
+        static const size_t HIGH_WATER = 2 * CAPACITY;  // past this, a thread gives back
+
+        static Chunk* chunkOf(const void* p)
+        {
+            return reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(BYTES - 1));
+        }
+        static Node* slot(Chunk* pChunk, size_t i)
+        {
+            return reinterpret_cast<Node*>(reinterpret_cast<char*>(pChunk) + FIRST) + i;
+        }
+
+        static void open(Cache& c);
+        static void close(Cache& c);
+        static void spill(Cache& c, size_t numKept) noexcept;
+        static void file(size_t num);
+        static void put(Node* p);
+        static void retire(Chunk* pChunk);
+        static void freeChunk(Chunk* pChunk);
+
+        static thread_local Cache cache;
+        static std::mutex depotLock;
+        static Chunk* pDepot;                  // chunks with free nodes, under depotLock
+        static Node* pLoose;                   // whole chains given back, not yet sorted
+        static Node* pLooseLast;               //    into their chunks, under depotLock
+        static size_t numLoose;
+        static std::atomic<size_t> numChunks;  // on the heap right now
+    };
+
+    template <class Node>
+    thread_local typename node_pool <Node> ::Cache node_pool <Node> ::cache = { nullptr, 0, nullptr, 0 };
+    template <class Node>
+    std::mutex node_pool <Node> ::depotLock;
+    template <class Node>
+    typename node_pool <Node> ::Chunk* node_pool <Node> ::pDepot = nullptr;
+    template <class Node>
+    Node* node_pool <Node> ::pLoose = nullptr;
+    template <class Node>
+    Node* node_pool <Node> ::pLooseLast = nullptr;
+    template <class Node>
+    size_t node_pool <Node> ::numLoose = 0;
+    template <class Node>
+    std::atomic<size_t> node_pool <Node> ::numChunks(0);
+
+    /*************************************************
+     * NODE POOL :: ALLOCATE
+     * A free node of this thread's, then the next one of the
+     * chunk it is carving, then a chunk's worth of loose nodes or
+     * of one chunk's from the depot, and only then a new chunk
+     *     COST   : O(1) amortized
+     *************************************************/
+    template <class Node>
+    void* node_pool <Node> ::allocate()
+    {
+        Cache& c = cache;
+        if (c.pFree == nullptr && !(c.pOpen && c.numCarved < CAPACITY))
+        {
+            std::lock_guard<std::mutex> guard(depotLock);
+            if (pLoose)
+            {
+                Node* pLast = pLoose;
+                size_t num = 1;
+                for (; num < CAPACITY && pLast != pLooseLast; num++)
+                    pLast = static_cast<Node*>(pLast->pNext);
+                c.pFree = pLoose;
+                c.numFree = num;
+                pLoose = pLast == pLooseLast ? nullptr : static_cast<Node*>(pLast->pNext);
+                if (pLoose == nullptr)
+                    pLooseLast = nullptr;
+                numLoose -= num;
+                pLast->pNext = nullptr;
+            }
+            else if (pDepot)
+            {
+                Chunk* pChunk = pDepot;
+                pDepot = pChunk->pNext;
+                if (pDepot)
+                    pDepot->pPrev = nullptr;
+                c.pFree = pChunk->pFree;
+                c.numFree = pChunk->numFree;
+                pChunk->pFree = nullptr;
+                pChunk->numFree = 0;
+            }
+        }
+
+        if (c.pFree)
+        {
+            Node* p = c.pFree;
+            c.pFree = static_cast<Node*>(p->pNext);
+            c.numFree--;
+            return p;
+        }
+
+        if (c.pOpen == nullptr || c.numCarved == CAPACITY)
+            open(c);
+        return slot(c.pOpen, c.numCarved++);
+    }
+
+    /*************************************************
+     * NODE POOL :: DEALLOCATE
+     * The destructor has already run; keep the storage, unless
+     * this thread already keeps more than enough
+     *     COST   : O(1) amortized
+     *************************************************/
+    template <class Node>
+    void node_pool <Node> ::deallocate(void* p) noexcept
+    {
+        if (p == nullptr)
+            return;
+        Cache& c = cache;
+        Node* pNode = static_cast<Node*>(p);
+        pNode->pNext = c.pFree;
+        c.pFree = pNode;
+        if (++c.numFree > HIGH_WATER)
+            spill(c, CAPACITY);
+    }
+
+    /*************************************************
+     * NODE POOL :: CARVE
+     * Raw storage for up to num nodes side by side, so a bulk
+     * copy walks memory in order. num comes back as how many
+     * it got, at least one and at most a chunk's worth; ask
+     * again for the rest. Every node goes back through
+     * deallocate() like any other
+     *     COST   : O(1)
+     *************************************************/
+    template <class Node>
+    Node* node_pool <Node> ::carve(size_t& num)
+    {
+        Cache& c = cache;
+        if (num > CAPACITY)
+            num = CAPACITY;
+        if (c.pOpen == nullptr || CAPACITY - c.numCarved < num)
+            open(c);
+        Node* pBlock = slot(c.pOpen, c.numCarved);
+        c.numCarved += num;
+        return pBlock;
+    }
+
+    /*************************************************
+     * NODE POOL :: RECYCLE
+     * Give a whole chain [pFirst, pLast] of num nodes back at
+     * once. The caller has already destroyed the data. A chain
+     * that would put this thread past HIGH_WATER goes to the depot
+     * loose, to be sorted into its chunks later
+     *     COST   : O(1)
+     *************************************************/
+    template <class Node>
+    void node_pool <Node> ::recycle(Node* pFirst, Node* pLast, size_t num) noexcept
+    {
+        if (pFirst == nullptr)
+            return;
+        Cache& c = cache;
+        if (c.numFree + num <= HIGH_WATER)
+        {
+            pLast->pNext = c.pFree;
+            c.pFree = pFirst;
+            c.numFree += num;
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(depotLock);
+        pLast->pNext = pLoose;
+        pLoose = pFirst;
+        if (pLooseLast == nullptr)
+            pLooseLast = pLast;
+        numLoose += num;
+    }
+
+    /*************************************************
+     * NODE POOL :: OPEN / CLOSE
+     * Start carving a fresh chunk, closing the one before. A
+     * closed chunk can go back to the heap once every node
+     * carved from it is back in the depot
+     *     COST   : O(1)
+     *************************************************/
+    template <class Node>
+    void node_pool <Node> ::open(Cache& c)
+    {
+        void* pRaw;
+        Chunk* pChunk;
+#if defined(__cpp_aligned_new)
+        pRaw = ::operator new(BYTES, std::align_val_t(BYTES));
+        pChunk = static_cast<Chunk*>(pRaw);
+#else
+        pRaw = ::operator new(2 * BYTES);
+        pChunk = reinterpret_cast<Chunk*>((reinterpret_cast<uintptr_t>(pRaw) + BYTES - 1) & ~(uintptr_t)(BYTES - 1));
+#endif
+        numChunks++;
+        close(c);
+        new (pChunk) Chunk{ nullptr, 0, 0, true, nullptr, nullptr, pRaw };
+        c.pOpen = pChunk;
+        c.numCarved = 0;
+    }
+
+    template <class Node>
+    void node_pool <Node> ::close(Cache& c)
+    {
+        if (c.pOpen == nullptr)
+            return;
+        std::lock_guard<std::mutex> guard(depotLock);
+        c.pOpen->numCarved = c.numCarved;
+        c.pOpen->open = false;
+        retire(c.pOpen);
+        c.pOpen = nullptr;
+    }
+
+    /*************************************************
+     * NODE POOL :: SPILL
+     * Keep numKept of this thread's free nodes and put the rest
+     * in the depot, each with the other free nodes of its chunk.
+     * As many loose nodes are sorted along the way, so a chunk a
+     * cleared list was carved from can go back to the heap too
+     *     COST   : O(n) with respect to the nodes given back
+     *************************************************/
+    template <class Node>
+    void node_pool <Node> ::spill(Cache& c, size_t numKept) noexcept
+    {
+        std::lock_guard<std::mutex> guard(depotLock);
+        size_t num = c.numFree > numKept ? c.numFree - numKept : 0;
+        while (c.numFree > numKept)
+        {
+            Node* p = c.pFree;
+            c.pFree = static_cast<Node*>(p->pNext);
+            c.numFree--;
+            put(p);
+        }
+        file(num);
+    }
+
+    // up to num loose nodes into their chunks' share of the depot.
+    // Called under depotLock
+    template <class Node>
+    void node_pool <Node> ::file(size_t num)
+    {
+        for (; num && pLoose; num--)
+        {
+            Node* p = pLoose;
+            pLoose = static_cast<Node*>(p->pNext);
+            numLoose--;
+            put(p);
+        }
+        if (pLoose == nullptr)
+            pLooseLast = nullptr;
+    }
+
+    // one node into its chunk's share of the depot. Called under depotLock
+    template <class Node>
+    void node_pool <Node> ::put(Node* p)
+    {
+        Chunk* pChunk = chunkOf(p);
+        p->pNext = pChunk->pFree;
+        pChunk->pFree = p;
+        if (pChunk->numFree++ == 0)
+        {
+            pChunk->pPrev = nullptr;
+            pChunk->pNext = pDepot;
+            if (pDepot)
+                pDepot->pPrev = pChunk;
+            pDepot = pChunk;
+        }
+        retire(pChunk);
+    }
+
+    // back to the heap, if every node of a closed chunk is in the
+    // depot. Called under depotLock
+    template <class Node>
+    void node_pool <Node> ::retire(Chunk* pChunk)
+    {
+        if (pChunk->open || pChunk->numFree != pChunk->numCarved)
+            return;
+        if (pChunk->numFree)
+        {
+            if (pChunk->pPrev)
+                pChunk->pPrev->pNext = pChunk->pNext;
+            else
+                pDepot = pChunk->pNext;
+            if (pChunk->pNext)
+                pChunk->pNext->pPrev = pChunk->pPrev;
+        }
+        freeChunk(pChunk);
+    }
+
+    template <class Node>
+    void node_pool <Node> ::freeChunk(Chunk* pChunk)
+    {
+        numChunks--;
+#if defined(__cpp_aligned_new)
+        ::operator delete(pChunk->pRaw, std::align_val_t(BYTES));
+#else
+        ::operator delete(pChunk->pRaw);
+#endif
+    }
+
+    /*************************************************
+     * NODE POOL :: CACHE :: DESTRUCTOR
+     * The thread is going away; everything it holds goes to
+     * the depot, and every loose node is sorted there too
+     *     COST   : O(n) with respect to the nodes held and loose
+     *************************************************/
+    template <class Node>
+    node_pool <Node> ::Cache::~Cache()
+    {
+        spill(*this, 0);
+        close(*this);
+        std::lock_guard<std::mutex> guard(depotLock);
+        file(numLoose);
+    }
+
+} // namespace custom
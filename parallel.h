@@ -0,0 +1,341 @@
+/***********************************************************************
+ * Header:
+ *    PARALLEL
+ * Summary:
+ *    The pieces we need to run an algorithm across the buckets of a
+ *    hash, or the segments of a list, on more than one thread
+ *
+ *    This will contain the class definition of:
+ *        bucket_range    : A splittable range of buckets [pBucket, pBucketEnd)
+ *        list_range      : A splittable range of a list's segments
+ *        work_deque      : The queue of ranges each worker owns
+ *    and the functions:
+ *        parallel_for      : Hand out a range to a work-stealing team
+ *        parallel_reduce   : Fold a range into one value on that team
+ *        parallel_for_each : Visit every element of a list on that team
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "list.h"     // because a bucket is a list
+#include <atomic>     // for std::atomic
+#include <deque>      // for std::deque
+#include <exception>  // for std::exception_ptr
+#include <memory>     // for std::unique_ptr
+#include <mutex>      // for std::mutex
+#include <thread>     // for std::thread
+#include <utility>    // for std::declval
+#include <vector>     // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * BUCKET RANGE
+ * A contiguous run of buckets that can split itself in half.
+ * Bucket is custom::list<T> or const custom::list<T>
+ ************************************************/
+template <class Bucket>
+class bucket_range
+{
+public:
+   //
+   // Construct
+   //
+   bucket_range() : pBucket(nullptr), pBucketEnd(nullptr), grain(1) {}
+   bucket_range(Bucket* pBucket, Bucket* pBucketEnd, size_t grain = 1)
+      : pBucket(pBucket), pBucketEnd(pBucketEnd), grain(grain ? grain : 1) {}
+
+   //
+   // Split - give away the back half, keep the front half
+   //
+   bool is_divisible() const { return size() > grain; }
+   bucket_range split()
+   {
+      Bucket* pMiddle = pBucket + size() / 2;
+      bucket_range rhs(pMiddle, pBucketEnd, grain);
+      pBucketEnd = pMiddle;
+      return rhs;
+   }
+
+   //
+   // Access
+   //
+   Bucket* begin() const { return pBucket;    }
+   Bucket* end()   const { return pBucketEnd; }
+
+   //
+   // Status
+   //
+   size_t size()  const { return pBucketEnd - pBucket; }
+   bool   empty() const { return pBucket == pBucketEnd; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   Bucket* pBucket;     // first bucket in the range
+   Bucket* pBucketEnd;  // one past the last bucket in the range
+   size_t  grain;       // never split below this many buckets
+};
+
+/************************************************
+ * LIST RANGE
+ * A run of a list's segments [iSegment, iSegmentEnd), found
+ * through its checkpoints so that splitting needs no walk.
+ * List is custom::list<T> or const custom::list<T>
+ ************************************************/
+template <class List>
+class list_range
+{
+public:
+   // the list's iterator, or its const_iterator for a const list
+   typedef decltype(std::declval<List&>().segment(0)) iterator;
+
+   //
+   // Construct
+   //
+   list_range() : pList(nullptr), iSegment(0), iSegmentEnd(0), grain(1) {}
+   list_range(List* pList, size_t iSegment, size_t iSegmentEnd, size_t grain = 1)
+      : pList(pList), iSegment(iSegment), iSegmentEnd(iSegmentEnd), grain(grain ? grain : 1) {}
+
+   //
+   // Split - give away the back half, keep the front half
+   //
+   bool is_divisible() const { return size() > grain; }
+   list_range split()
+   {
+      size_t iMiddle = iSegment + size() / 2;
+      list_range rhs(pList, iMiddle, iSegmentEnd, grain);
+      iSegmentEnd = iMiddle;
+      return rhs;
+   }
+
+   //
+   // Access - the elements, from the first segment's first node up
+   // to the node that starts the segment after the last
+   //
+   iterator begin() const { return pList->segment(iSegment);    }
+   iterator end()   const { return pList->segment(iSegmentEnd); }
+
+   //
+   // Status
+   //
+   size_t size()  const { return iSegmentEnd - iSegment; }
+   bool   empty() const { return iSegment == iSegmentEnd; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   List*  pList;
+   size_t iSegment;     // first segment in the range
+   size_t iSegmentEnd;  // one past the last segment in the range
+   size_t grain;        // never split below this many segments
+};
+
+/************************************************
+ * WORK DEQUE
+ * The owner pushes and pops at the back, thieves take
+ * from the front where the biggest pieces are
+ ************************************************/
+template <class Range>
+class work_deque
+{
+public:
+   void push(const Range& range)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      ranges.push_back(range);
+   }
+   bool pop(Range& range)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      if (ranges.empty())
+         return false;
+      range = ranges.back();
+      ranges.pop_back();
+      return true;
+   }
+   bool steal(Range& range)
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      if (ranges.empty())
+         return false;
+      range = ranges.front();
+      ranges.pop_front();
+      return true;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   std::mutex lock;
+   std::deque<Range> ranges;
+};
+
+/*****************************************
+ * NUMBER OF WORKERS
+ * How many threads are worth starting for a range
+ ****************************************/
+template <class Range>
+size_t num_workers(const Range& range, size_t numThreads)
+{
+   if (numThreads == 0)
+      numThreads = std::thread::hardware_concurrency();
+   if (numThreads > range.size())
+      numThreads = range.size();
+   return numThreads ? numThreads : 1;
+}
+
+/*****************************************
+ * PARALLEL FOR
+ * Run body(range, iWorker) over pieces of the range on a team of
+ * numThreads workers (0 means one per core). Each worker splits
+ * what it has until the pieces are indivisible, keeping the halves
+ * it gives away in its own deque. An idle worker steals from the
+ * front of someone else's deque, so a few heavy buckets do not
+ * leave the rest of the team waiting. If the body throws, no more
+ * pieces are handed out, every worker is joined, and the first
+ * exception is thrown again here.
+ ****************************************/
+template <class Range, class Body>
+void parallel_for_worker(Range range, const Body& body, size_t numThreads)
+{
+   numThreads = num_workers(range, numThreads);
+   if (numThreads == 1 || !range.is_divisible())
+   {
+      if (!range.empty())
+         body(range, 0);
+      return;
+   }
+
+   std::unique_ptr<work_deque<Range>[]> deques(new work_deque<Range>[numThreads]);
+   std::atomic<size_t> pending(1);  // ranges handed out but not yet finished
+   std::atomic<bool> failed(false);
+   std::exception_ptr error;        // the first thrown, under errorLock
+   std::mutex errorLock;
+   deques[0].push(range);
+
+   auto worker = [&](size_t iWorker)
+   {
+      Range r;
+      size_t iVictim = iWorker;
+      while (pending.load() != 0 && !failed.load())
+      {
+         bool found = deques[iWorker].pop(r);
+         for (size_t i = 1; !found && i < numThreads; i++)
+         {
+            iVictim = (iVictim + 1) % numThreads;
+            if (iVictim != iWorker)
+               found = deques[iVictim].steal(r);
+         }
+         if (!found)
+         {
+            std::this_thread::yield();
+            continue;
+         }
+
+         try
+         {
+            while (r.is_divisible())
+            {
+               pending++;
+               deques[iWorker].push(r.split());
+            }
+            if (!r.empty())
+               body(r, iWorker);
+         }
+         catch (...)
+         {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!error)
+               error = std::current_exception();
+            failed = true;
+         }
+         pending--;
+      }
+   };
+
+   std::vector<std::thread> threads;
+   for (size_t i = 1; i < numThreads; i++)
+      threads.push_back(std::thread(worker, i));
+   worker(0);
+   for (auto& thread : threads)
+      thread.join();
+   if (error)
+      std::rethrow_exception(error);
+}
+
+template <class Range, class Body>
+void parallel_for(Range range, const Body& body, size_t numThreads = 0)
+{
+   parallel_for_worker(range, [&body](const Range& r, size_t) { body(r); }, numThreads);
+}
+
+/*****************************************
+ * PARALLEL REDUCE
+ * Fold every piece of the range into a value. Each worker keeps
+ * its own running value, starting from identity, through
+ * fold(value, range); the workers' values are then merged with
+ * combine(value, value). identity must leave a value unchanged
+ * under combine (0 for +, 1 for *), and combine must be associative
+ * and commutative since the pieces finish in no particular order.
+ ****************************************/
+template <class Range, class Value, class Fold, class Combine>
+Value parallel_reduce(Range range, const Value& identity, Fold fold, Combine combine,
+                      size_t numThreads = 0)
+{
+   // padded so two workers never write to the same cache line
+   struct Partial
+   {
+      Value value;
+      char  padding[64];
+   };
+
+   numThreads = num_workers(range, numThreads);
+   std::vector<Partial> partial(numThreads, Partial{ identity, {} });
+   parallel_for_worker(range, [&](const Range& r, size_t iWorker)
+   {
+      partial[iWorker].value = fold(partial[iWorker].value, r);
+   }, numThreads);
+
+   Value value = identity;
+   for (auto& p : partial)
+      value = combine(value, p.value);
+   return value;
+}
+
+/*****************************************
+ * PARALLEL FOR EACH
+ * Call fn(element) on every element of a list, cutting it at its
+ * checkpoints. A list that keeps none is one segment, so it is
+ * visited on this thread alone. The list must not change meanwhile
+ ****************************************/
+template <class T, class Function>
+void parallel_for_each(list<T>& l, Function fn, size_t numThreads = 0)
+{
+   parallel_for(list_range<list<T>>(&l, 0, l.num_segments()), [&fn](const list_range<list<T>>& r)
+   {
+      for (auto it = r.begin(); it != r.end(); ++it)
+         fn(*it);
+   }, numThreads);
+}
+
+template <class T, class Function>
+void parallel_for_each(const list<T>& l, Function fn, size_t numThreads = 0)
+{
+   parallel_for(list_range<const list<T>>(&l, 0, l.num_segments()), [&fn](const list_range<const list<T>>& r)
+   {
+      for (auto it = r.begin(); it != r.end(); ++it)
+         fn(*it);
+   }, numThreads);
+}
+
+} // namespace custom
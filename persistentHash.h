@@ -0,0 +1,679 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT HASH
+ * Summary:
+ *    An immutable hash set, kept as a hash array mapped trie: each
+ *    level of the trie takes the next five bits of an element's hash
+ *    to pick one of up to 32 children, and a branch stores only the
+ *    children it has, packed behind a 32 bit map of which ones those
+ *    are. insert() and erase() copy the one path from the root to the
+ *    element and share every other node with the version they came
+ *    from, so a new version costs a few small nodes, not a new table.
+ *    Elements whose whole hashes are equal share a collision node.
+ *
+ *    No node is written after it is built, so threads read their own
+ *    versions with no lock; only the reference counts are shared
+ *
+ *    This will contain the class definition of:
+ *        persistent_unordered_set           : An immutable HAMT set
+ *        persistent_unordered_set::iterator : An iterator through one version
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "bits.h"           // for popcount
+#include "persistentList.h" // for the elements of a collision node
+#include <atomic>           // for std::atomic
+#include <cstdint>          // for uint32_t
+#include <functional>       // for std::hash and std::equal_to
+#include <initializer_list> // for std::initializer_list
+#include <new>              // for placement new
+#include <utility>          // for std::swap
+
+namespace custom
+{
+
+/************************************************
+ * PERSISTENT UNORDERED SET
+ * One version of the set. Copying a version is O(1) and shares
+ * every node; a version object, like any other object, must not be
+ * assigned on one thread while another reads it
+ ************************************************/
+template <typename T, typename H = std::hash<T>, typename E = std::equal_to<T>>
+class persistent_unordered_set
+{
+public:
+   //
+   // Construct
+   //
+   explicit persistent_unordered_set(const H& h = H(), const E& e = E())
+      : pRoot(nullptr), numElements(0), hasher(h), equal(e) {}
+   persistent_unordered_set(const persistent_unordered_set& rhs)
+      : pRoot(acquire(rhs.pRoot)), numElements(rhs.numElements), hasher(rhs.hasher), equal(rhs.equal) {}
+   persistent_unordered_set(persistent_unordered_set&& rhs) : persistent_unordered_set()
+   {
+      swap(rhs);
+   }
+   persistent_unordered_set(const std::initializer_list<T>& il) : persistent_unordered_set(il.begin(), il.end()) {}
+   template <class Iterator>
+   persistent_unordered_set(Iterator first, Iterator last) : persistent_unordered_set()
+   {
+      for (; first != last; ++first)
+         *this = insert(*first);
+   }
+   ~persistent_unordered_set() { release(pRoot); }
+
+   //
+   // Assign - only which version this is changes, never a version
+   //
+   persistent_unordered_set& operator = (const persistent_unordered_set& rhs)
+   {
+      persistent_unordered_set copy(rhs);
+      swap(copy);
+      return *this;
+   }
+   persistent_unordered_set& operator = (persistent_unordered_set&& rhs)
+   {
+      persistent_unordered_set moved(std::move(rhs));
+      swap(moved);
+      return *this;
+   }
+   void swap(persistent_unordered_set& rhs)
+   {
+      std::swap(pRoot, rhs.pRoot);
+      std::swap(numElements, rhs.numElements);
+      std::swap(hasher, rhs.hasher);
+      std::swap(equal, rhs.equal);
+   }
+
+   //
+   // Iterator - valid as long as some version holds its nodes
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const { return find(t) != end(); }
+   size_t count(const T& t) const  { return contains(t) ? 1 : 0; }
+
+   //
+   // New versions - each leaves this one as it was, and is this one
+   // again when t changes nothing
+   //
+   persistent_unordered_set insert(const T& t) const;
+   persistent_unordered_set erase(const T& t) const;
+
+   //
+   // Status
+   //
+   size_t size() const { return numElements; }
+   bool empty() const  { return numElements == 0; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const unsigned BITS = 5;                    // of the hash per level
+   static const size_t MASK = (1 << BITS) - 1;
+   static const size_t MAX_DEPTH = (sizeof(size_t) * 8 + BITS - 1) / BITS;
+
+   enum Kind { BRANCH, LEAF, COLLISION };
+
+   // what every node starts with: how many versions and branches
+   // link to it, and which of the three it is
+   struct Node
+   {
+      Node(Kind kind) : refs(1), kind(kind) {}
+      std::atomic<size_t> refs;
+      const Kind kind;
+   };
+
+   // one element and its hash
+   struct Leaf : Node
+   {
+      Leaf(size_t hash, const T& data) : Node(LEAF), hash(hash), data(data) {}
+      const size_t hash;
+      const T data;
+   };
+
+   // two or more elements whose hashes are the same in every bit
+   struct Collision : Node
+   {
+      Collision(size_t hash, const persistent_list<T>& items) : Node(COLLISION), hash(hash), items(items) {}
+      const size_t hash;
+      const persistent_list<T> items;
+   };
+
+   // bit i of bitmap says whether child i is here. The children
+   // follow the branch in the same block, in order, with none
+   // stored for the ones that are not
+   struct Branch : Node
+   {
+      Branch(uint32_t bitmap) : Node(BRANCH), bitmap(bitmap) {}
+      const uint32_t bitmap;
+      size_t size() const            { return popcount(bitmap); }
+      Node** children()              { return reinterpret_cast<Node**>(this + 1); }
+      Node* const* children() const  { return reinterpret_cast<Node* const*>(this + 1); }
+      size_t position(uint32_t bit) const { return popcount(bitmap & (bit - 1)); }
+   };
+
+   // takes over one reference to pRoot
+   persistent_unordered_set(Node* pRoot, size_t numElements, const H& h, const E& e)
+      : pRoot(pRoot), numElements(numElements), hasher(h), equal(e) {}
+
+   // the child a hash picks at the level that starts at shift
+   static uint32_t bit(size_t hash, unsigned shift) { return (uint32_t)1 << ((hash >> shift) & MASK); }
+   static size_t hashOf(const Node* p)
+   {
+      return p->kind == LEAF ? static_cast<const Leaf*>(p)->hash : static_cast<const Collision*>(p)->hash;
+   }
+
+   static Node* acquire(Node* p);
+   static void release(Node* p);
+   static Branch* allocate(uint32_t bitmap);
+   static Node* merge(Node* pA, Node* pB, unsigned shift);
+   static Node* replace(const Branch* p, uint32_t bit, Node* pChild);
+   static Node* add(const Branch* p, uint32_t bit, Node* pChild);
+   static Node* remove(const Branch* p, uint32_t bit);
+
+   Node* insert(Node* p, const T& t, size_t hash, unsigned shift) const;
+   Node* erase(Node* p, const T& t, size_t hash, unsigned shift, bool& found) const;
+   bool holds(const Collision* p, const T& t) const;
+
+   Node* pRoot;          // null when empty
+   size_t numElements;
+   H hasher;
+   E equal;
+};
+
+/************************************************
+ * PERSISTENT UNORDERED SET ITERATOR
+ * The branches from the root down to a leaf or collision node, with
+ * the child taken at each, and a place in the collision's list
+ ************************************************/
+template <typename T, typename H, typename E>
+class persistent_unordered_set <T, H, E> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : depth(0), pCurrent(nullptr) {}
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return pCurrent == rhs.pCurrent && itItem == rhs.itItem;
+   }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access
+   //
+   const T& operator * () const
+   {
+      return pCurrent->kind == LEAF ? static_cast<const Leaf*>(pCurrent)->data : *itItem;
+   }
+
+   //
+   // Increment
+   //
+   iterator& operator ++ ();
+   iterator operator ++ (int postfix)
+   {
+      iterator it(*this);
+      ++(*this);
+      return it;
+   }
+
+   friend class persistent_unordered_set <T, H, E>;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   // the first element at or below p
+   void descend(const Node* p);
+
+   const Branch* apPath[MAX_DEPTH];      // the branches above pCurrent
+   size_t aiChild[MAX_DEPTH];            // and which child of each it is under
+   size_t depth;
+   const Node* pCurrent;                 // a leaf or collision, null at the end
+   typename persistent_list<T>::iterator itItem;   // in a collision
+};
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: ACQUIRE
+ * One more version or branch links to p
+ *     COST   : O(1)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::acquire(Node* p)
+{
+   if (p)
+      p->refs.fetch_add(1, std::memory_order_relaxed);
+   return p;
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: RELEASE
+ * One fewer links to p. The last one out frees it and lets go of
+ * its children; the trie is at most MAX_DEPTH deep, so the
+ * recursion is too
+ *     COST   : O(1), or O(k) to free the k nodes no one else reaches
+ ****************************************/
+template <typename T, typename H, typename E>
+void persistent_unordered_set <T, H, E> ::release(Node* p)
+{
+   if (p == nullptr || p->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+
+   switch (p->kind)
+   {
+   case BRANCH:
+   {
+      Branch* pBranch = static_cast<Branch*>(p);
+      for (size_t i = 0; i < pBranch->size(); i++)
+         release(pBranch->children()[i]);
+      pBranch->~Branch();
+      ::operator delete(pBranch);
+      break;
+   }
+   case LEAF:
+      delete static_cast<Leaf*>(p);
+      break;
+   case COLLISION:
+      delete static_cast<Collision*>(p);
+      break;
+   }
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: ALLOCATE
+ * One block holds the branch and a child for each bit in the map.
+ * The caller fills in the children
+ *     COST   : O(1)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Branch* persistent_unordered_set <T, H, E> ::allocate(uint32_t bitmap)
+{
+   void* pBlock = ::operator new(sizeof(Branch) + popcount(bitmap) * sizeof(Node*));
+   return new (pBlock) Branch(bitmap);
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: MERGE
+ * A trie from the level at shift down holding two leaf or collision
+ * nodes with different hashes: a branch for each level where the
+ * hashes still agree, then one that splits them. Takes over one
+ * reference to each, and lets go of both if it cannot finish
+ *     COST   : O(levels the hashes share)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::merge(Node* pA, Node* pB, unsigned shift)
+{
+   size_t hashA = hashOf(pA);
+   size_t hashB = hashOf(pB);
+   unsigned shiftSplit = shift;
+   while (bit(hashA, shiftSplit) == bit(hashB, shiftSplit))
+      shiftSplit += BITS;
+
+   // the bottom branch, with the two in the order of their bits
+   Node* p;
+   try
+   {
+      Branch* pBranch = allocate(bit(hashA, shiftSplit) | bit(hashB, shiftSplit));
+      bool aFirst = bit(hashA, shiftSplit) < bit(hashB, shiftSplit);
+      pBranch->children()[0] = aFirst ? pA : pB;
+      pBranch->children()[1] = aFirst ? pB : pA;
+      p = pBranch;
+   }
+   catch (...)
+   {
+      release(pA);
+      release(pB);
+      throw;
+   }
+
+   // and a one child branch above it for each level they share
+   while (shiftSplit > shift)
+   {
+      shiftSplit -= BITS;
+      Branch* pBranch;
+      try
+      {
+         pBranch = allocate(bit(hashA, shiftSplit));
+      }
+      catch (...)
+      {
+         release(p);
+         throw;
+      }
+      pBranch->children()[0] = p;
+      p = pBranch;
+   }
+   return p;
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: REPLACE / ADD / REMOVE
+ * A copy of a branch with one child swapped, added or taken out.
+ * Every other child is shared. Takes over the reference to pChild
+ *     COST   : O(children)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::replace(const Branch* p, uint32_t bit, Node* pChild)
+{
+   Branch* pCopy;
+   try
+   {
+      pCopy = allocate(p->bitmap);
+   }
+   catch (...)
+   {
+      release(pChild);
+      throw;
+   }
+   size_t iChild = p->position(bit);
+   for (size_t i = 0; i < p->size(); i++)
+      pCopy->children()[i] = i == iChild ? pChild : acquire(p->children()[i]);
+   return pCopy;
+}
+
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::add(const Branch* p, uint32_t bit, Node* pChild)
+{
+   Branch* pCopy;
+   try
+   {
+      pCopy = allocate(p->bitmap | bit);
+   }
+   catch (...)
+   {
+      release(pChild);
+      throw;
+   }
+   size_t iChild = p->position(bit);
+   for (size_t i = 0; i < iChild; i++)
+      pCopy->children()[i] = acquire(p->children()[i]);
+   pCopy->children()[iChild] = pChild;
+   for (size_t i = iChild; i < p->size(); i++)
+      pCopy->children()[i + 1] = acquire(p->children()[i]);
+   return pCopy;
+}
+
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::remove(const Branch* p, uint32_t bit)
+{
+   Branch* pCopy = allocate(p->bitmap & ~bit);
+   size_t iChild = p->position(bit);
+   for (size_t i = 0, iCopy = 0; i < p->size(); i++)
+      if (i != iChild)
+         pCopy->children()[iCopy++] = acquire(p->children()[i]);
+   return pCopy;
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: HOLDS
+ * Whether a collision node has an element equal to t
+ *     COST   : O(elements in it)
+ ****************************************/
+template <typename T, typename H, typename E>
+bool persistent_unordered_set <T, H, E> ::holds(const Collision* p, const T& t) const
+{
+   for (auto it = p->items.begin(); it != p->items.end(); ++it)
+      if (equal(*it, t))
+         return true;
+   return false;
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: INSERT
+ * A new version with t in it. Only the branches from the root down
+ * to where t goes are new
+ *     COST   : O(depth) nodes, each O(32) to copy
+ ****************************************/
+template <typename T, typename H, typename E>
+persistent_unordered_set <T, H, E> persistent_unordered_set <T, H, E> ::insert(const T& t) const
+{
+   Node* pNew = insert(pRoot, t, hasher(t), 0);
+   if (pNew == nullptr)
+      return *this;
+   return persistent_unordered_set(pNew, numElements + 1, hasher, equal);
+}
+
+// the new node in place of p, or null if t is already under p
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::insert(Node* p, const T& t, size_t hash, unsigned shift) const
+{
+   if (p == nullptr)
+      return new Leaf(hash, t);
+
+   switch (p->kind)
+   {
+   case BRANCH:
+   {
+      const Branch* pBranch = static_cast<const Branch*>(p);
+      uint32_t b = bit(hash, shift);
+      if (!(pBranch->bitmap & b))
+         return add(pBranch, b, new Leaf(hash, t));
+      Node* pChild = insert(pBranch->children()[pBranch->position(b)], t, hash, shift + BITS);
+      return pChild ? replace(pBranch, b, pChild) : nullptr;
+   }
+   case LEAF:
+   {
+      const Leaf* pLeaf = static_cast<const Leaf*>(p);
+      if (pLeaf->hash == hash && equal(pLeaf->data, t))
+         return nullptr;
+      if (pLeaf->hash == hash)
+         return new Collision(hash, persistent_list<T>{ pLeaf->data, t });
+      break;
+   }
+   case COLLISION:
+   {
+      const Collision* pCollision = static_cast<const Collision*>(p);
+      if (pCollision->hash == hash && holds(pCollision, t))
+         return nullptr;
+      if (pCollision->hash == hash)
+         return new Collision(hash, pCollision->items.push_front(t));
+      break;
+   }
+   }
+
+   // a leaf or collision with another hash: both go under new branches.
+   // The leaf comes first, so a throwing copy of t leaves p unacquired
+   Node* pLeaf = new Leaf(hash, t);
+   return merge(acquire(p), pLeaf, shift);
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: ERASE
+ * A new version without t. Only the branches from the root down to
+ * t are new, and a branch left with one leaf is folded into its
+ * parent so the trie stays as shallow as its hashes allow
+ *     COST   : O(depth) nodes, each O(32) to copy
+ ****************************************/
+template <typename T, typename H, typename E>
+persistent_unordered_set <T, H, E> persistent_unordered_set <T, H, E> ::erase(const T& t) const
+{
+   bool found = false;
+   Node* pNew = erase(pRoot, t, hasher(t), 0, found);
+   if (!found)
+      return *this;
+   return persistent_unordered_set(pNew, numElements - 1, hasher, equal);
+}
+
+// the new node in place of p, which is null if nothing is left
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::Node* persistent_unordered_set <T, H, E> ::erase(Node* p, const T& t, size_t hash, unsigned shift, bool& found) const
+{
+   if (p == nullptr)
+      return nullptr;
+
+   switch (p->kind)
+   {
+   case LEAF:
+   {
+      const Leaf* pLeaf = static_cast<const Leaf*>(p);
+      found = pLeaf->hash == hash && equal(pLeaf->data, t);
+      return nullptr;
+   }
+   case COLLISION:
+   {
+      const Collision* pCollision = static_cast<const Collision*>(p);
+      found = pCollision->hash == hash && holds(pCollision, t);
+      if (!found)
+         return nullptr;
+      persistent_list<T> rest;
+      for (auto it = pCollision->items.begin(); it != pCollision->items.end(); ++it)
+         if (!equal(*it, t))
+            rest = rest.push_front(*it);
+      if (rest.size() == 1)
+         return new Leaf(hash, rest.front());
+      return new Collision(hash, rest);
+   }
+   case BRANCH:
+      break;
+   }
+
+   const Branch* pBranch = static_cast<const Branch*>(p);
+   uint32_t b = bit(hash, shift);
+   if (!(pBranch->bitmap & b))
+      return nullptr;
+   Node* pChild = erase(pBranch->children()[pBranch->position(b)], t, hash, shift + BITS, found);
+   if (!found)
+      return nullptr;
+
+   // the child is gone: take it out, or the branch too if it was all.
+   // A branch down to one leaf becomes that leaf
+   if (pChild == nullptr)
+   {
+      if (pBranch->size() == 1)
+         return nullptr;
+      if (pBranch->size() == 2)
+      {
+         Node* pOther = pBranch->children()[pBranch->position(b) == 0 ? 1 : 0];
+         if (pOther->kind != BRANCH)
+            return acquire(pOther);
+      }
+      return remove(pBranch, b);
+   }
+
+   // the child is now a leaf and it was the only one: it moves up
+   if (pChild->kind != BRANCH && pBranch->size() == 1)
+      return pChild;
+   return replace(pBranch, b, pChild);
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: FIND
+ * Follow the hash down, keeping the path for the iterator
+ *     COST   : O(depth)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::iterator persistent_unordered_set <T, H, E> ::find(const T& t) const
+{
+   size_t hash = hasher(t);
+   iterator it;
+   const Node* p = pRoot;
+   for (unsigned shift = 0; p && p->kind == BRANCH; shift += BITS)
+   {
+      const Branch* pBranch = static_cast<const Branch*>(p);
+      uint32_t b = bit(hash, shift);
+      if (!(pBranch->bitmap & b))
+         return end();
+      it.apPath[it.depth] = pBranch;
+      it.aiChild[it.depth++] = pBranch->position(b);
+      p = pBranch->children()[pBranch->position(b)];
+   }
+   if (p == nullptr || hashOf(p) != hash)
+      return end();
+
+   it.pCurrent = p;
+   if (p->kind == LEAF)
+      return equal(static_cast<const Leaf*>(p)->data, t) ? it : end();
+
+   const Collision* pCollision = static_cast<const Collision*>(p);
+   for (it.itItem = pCollision->items.begin(); it.itItem != pCollision->items.end(); ++it.itItem)
+      if (equal(*it.itItem, t))
+         return it;
+   return end();
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET :: BEGIN / END
+ *     COST   : O(depth)
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::iterator persistent_unordered_set <T, H, E> ::begin() const
+{
+   iterator it;
+   if (pRoot)
+      it.descend(pRoot);
+   return it;
+}
+
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::iterator persistent_unordered_set <T, H, E> ::end() const
+{
+   return iterator();
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET ITERATOR :: DESCEND
+ * Take the first child of each branch down to a leaf or collision
+ *     COST   : O(depth)
+ ****************************************/
+template <typename T, typename H, typename E>
+void persistent_unordered_set <T, H, E> ::iterator::descend(const Node* p)
+{
+   while (p->kind == BRANCH)
+   {
+      const Branch* pBranch = static_cast<const Branch*>(p);
+      apPath[depth] = pBranch;
+      aiChild[depth++] = 0;
+      p = pBranch->children()[0];
+   }
+   pCurrent = p;
+   itItem = p->kind == COLLISION ? static_cast<const Collision*>(p)->items.begin()
+                                 : typename persistent_list<T>::iterator();
+}
+
+/*****************************************
+ * PERSISTENT UNORDERED SET ITERATOR :: INCREMENT
+ * The next element in a collision, or else back up to the nearest
+ * branch with a child left and down to its first element
+ *     COST   : O(1) amortized
+ ****************************************/
+template <typename T, typename H, typename E>
+typename persistent_unordered_set <T, H, E> ::iterator& persistent_unordered_set <T, H, E> ::iterator::operator ++ ()
+{
+   if (pCurrent->kind == COLLISION && ++itItem != static_cast<const Collision*>(pCurrent)->items.end())
+      return *this;
+
+   while (depth > 0)
+   {
+      const Branch* pBranch = apPath[depth - 1];
+      if (++aiChild[depth - 1] < pBranch->size())
+      {
+         descend(pBranch->children()[aiChild[depth - 1]]);
+         return *this;
+      }
+      depth--;
+   }
+   pCurrent = nullptr;
+   itItem = typename persistent_list<T>::iterator();
+   return *this;
+}
+
+} // namespace custom
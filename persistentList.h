@@ -0,0 +1,308 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT LIST
+ * Summary:
+ *    An immutable singly linked list. Nothing about a version ever
+ *    changes once it is made: push_front() returns a new version whose
+ *    head links to the old one, and pop_front() returns the old one's
+ *    tail, so any number of versions share their common tails and a
+ *    new version costs only the nodes it does not share with an old
+ *    one. Nodes are reference counted and freed with the last version
+ *    that reaches them.
+ *
+ *    Since no node is ever written after it is built, threads may read
+ *    their own versions with no lock at all. Only the reference counts
+ *    are shared, and they are atomic
+ *
+ *    This will contain the class definition of:
+ *        persistent_list           : An immutable list with shared tails
+ *        persistent_list::iterator : An iterator through one version
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include <atomic>           // for std::atomic
+#include <cstddef>          // for size_t
+#include <initializer_list> // for std::initializer_list
+#include <utility>          // for std::swap
+
+namespace custom
+{
+    /**************************************************
+     * PERSISTENT LIST
+     * One version of the list. Copying a version is O(1): the copy
+     * shares every node. A version object itself, like any other
+     * object, must not be assigned on one thread while another
+     * reads it
+     **************************************************/
+    template <typename T>
+    class persistent_list
+    {
+    public:
+        //
+        // Construct
+        //
+
+        persistent_list() : pHead(nullptr), numElements(0) {}
+        persistent_list(const persistent_list& rhs) : pHead(acquire(rhs.pHead)), numElements(rhs.numElements) {}
+        persistent_list(persistent_list&& rhs) : persistent_list()
+        {
+            swap(rhs);
+        }
+        persistent_list(const std::initializer_list<T>& il) : persistent_list(il.begin(), il.end()) {}
+        template <class Iterator>
+        persistent_list(Iterator first, Iterator last);
+        ~persistent_list() { release(pHead); }
+
+        //
+        // Assign - only which version this is changes, never a version
+        //
+
+        persistent_list& operator = (const persistent_list& rhs)
+        {
+            persistent_list copy(rhs);
+            swap(copy);
+            return *this;
+        }
+        persistent_list& operator = (persistent_list&& rhs)
+        {
+            persistent_list moved(std::move(rhs));
+            swap(moved);
+            return *this;
+        }
+        void swap(persistent_list& rhs)
+        {
+            std::swap(pHead, rhs.pHead);
+            std::swap(numElements, rhs.numElements);
+        }
+
+        //
+        // Iterator - elements cannot change in place
+        //
+
+        class iterator;
+        iterator begin() const { return iterator(pHead); }
+        iterator end()   const { return iterator(nullptr); }
+
+        //
+        // Access
+        //
+
+        const T& front() const { return pHead->data; }
+        iterator find(const T& t) const;
+        bool contains(const T& t) const { return find(t) != end(); }
+
+        //
+        // New versions - each leaves this one as it was
+        //
+
+        persistent_list push_front(const T& t) const;
+        persistent_list pop_front() const;
+        persistent_list remove(const T& t) const;
+
+        //
+        // Status
+        //
+
+        bool empty()  const { return numElements == 0; }
+        size_t size() const { return numElements; }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        // built once and never written again, but for the count of
+        // the versions and nodes that link to it
+        struct Node
+        {
+            Node(const T& data, Node* pNext) : data(data), pNext(pNext), refs(1) {}
+
+            const T data;
+            Node* pNext;                    // set once, as the node is built
+            std::atomic<size_t> refs;
+        };
+
+        // takes over one reference to pHead
+        persistent_list(Node* pHead, size_t numElements) : pHead(pHead), numElements(numElements) {}
+
+        static Node* acquire(Node* p);
+        static void release(Node* p);
+
+        Node* pHead;
+        size_t numElements;
+    };
+
+    /*************************************************
+     * PERSISTENT LIST ITERATOR
+     * Walks one version from its head
+     *************************************************/
+    template <typename T>
+    class persistent_list <T> ::iterator
+    {
+    public:
+        iterator() : p(nullptr) {}
+        explicit iterator(const Node* p) : p(p) {}
+
+        bool operator != (const iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const iterator& rhs) const { return rhs.p == p; }
+
+        const T& operator * () const { return p->data; }
+
+        iterator& operator ++ ()
+        {
+            p = p->pNext;
+            return *this;
+        }
+        iterator operator ++ (int postfix)
+        {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        friend class persistent_list <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        const Node* p;   // null at the end
+    };
+
+    /*****************************************
+     * PERSISTENT LIST :: RANGE CONSTRUCTOR
+     * The nodes are new and ours alone, so they can be linked front
+     * to back as they are made. Should copying an element throw, the
+     * nodes made so far are freed before the exception goes on
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T>
+    template <class Iterator>
+    persistent_list <T> ::persistent_list(Iterator first, Iterator last) : pHead(nullptr), numElements(0)
+    {
+        Node** ppLast = &pHead;
+        try
+        {
+            for (; first != last; ++first, numElements++)
+            {
+                *ppLast = new Node(*first, nullptr);
+                ppLast = &(*ppLast)->pNext;
+            }
+        }
+        catch (...)
+        {
+            release(pHead);
+            throw;
+        }
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: ACQUIRE
+     * One more version or node links to p
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T>
+    typename persistent_list <T> ::Node* persistent_list <T> ::acquire(Node* p)
+    {
+        if (p)
+            p->refs.fetch_add(1, std::memory_order_relaxed);
+        return p;
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: RELEASE
+     * One fewer links to p. The last one out frees it and lets go of
+     * its tail in turn, in a loop rather than by recursion so a long
+     * list cannot run out of stack
+     *     COST   : O(1), or O(k) to free the k nodes no one else reaches
+     ****************************************/
+    template <typename T>
+    void persistent_list <T> ::release(Node* p)
+    {
+        while (p && p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            Node* pNext = p->pNext;
+            delete p;
+            p = pNext;
+        }
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: FIND
+     * The first element equal to t
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T>
+    typename persistent_list <T> ::iterator persistent_list <T> ::find(const T& t) const
+    {
+        for (const Node* p = pHead; p; p = p->pNext)
+            if (p->data == t)
+                return iterator(p);
+        return end();
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: PUSH FRONT
+     * A new version with t in front of all of this one
+     *     COST   : O(1), one node
+     ****************************************/
+    template <typename T>
+    persistent_list <T> persistent_list <T> ::push_front(const T& t) const
+    {
+        // the node first, so a throwing copy of t leaves pHead unacquired
+        Node* pNew = new Node(t, nullptr);
+        pNew->pNext = acquire(pHead);
+        return persistent_list(pNew, numElements + 1);
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: POP FRONT
+     * The version without the first element: this one's tail
+     *     COST   : O(1), no node at all
+     ****************************************/
+    template <typename T>
+    persistent_list <T> persistent_list <T> ::pop_front() const
+    {
+        if (pHead == nullptr)
+            return persistent_list();
+        return persistent_list(acquire(pHead->pNext), numElements - 1);
+    }
+
+    /*****************************************
+     * PERSISTENT LIST :: REMOVE
+     * The version without the first element equal to t. The nodes
+     * in front of it are copied; everything after it is shared. If
+     * t is not here, the new version is this one. Should copying an
+     * element throw, the copies made so far are freed
+     *     COST   : O(n) to find t, and a node for each one before it
+     ****************************************/
+    template <typename T>
+    persistent_list <T> persistent_list <T> ::remove(const T& t) const
+    {
+        iterator it = find(t);
+        if (it == end())
+            return *this;
+
+        Node* pFirst = nullptr;
+        Node** ppLast = &pFirst;
+        try
+        {
+            for (Node* p = pHead; p != it.p; p = p->pNext)
+            {
+                *ppLast = new Node(p->data, nullptr);
+                ppLast = &(*ppLast)->pNext;
+            }
+        }
+        catch (...)
+        {
+            release(pFirst);
+            throw;
+        }
+        *ppLast = acquire(it.p->pNext);
+        return persistent_list(pFirst, numElements - 1);
+    }
+
+} // namespace custom
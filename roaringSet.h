@@ -0,0 +1,831 @@
+/***********************************************************************
+ * Header:
+ *    ROARING SET
+ * Summary:
+ *    A compressed set of integers of up to 32 bits. Keys are split by
+ *    their high 16 bits into containers of 65536, and each container
+ *    holds its low 16 bits in whichever form is smallest:
+ *        array  : a sorted array of two-byte values, up to 4096 of them
+ *        bitmap : 65536 bits, once there are more than 4096
+ *        run    : sorted [start, last] intervals, after optimize()
+ *    So a key costs at most two bytes, rather than the key, two links
+ *    and the allocator's header of a list node. Union, intersection and
+ *    difference work a container at a time and a word at a time
+ *
+ *    This will contain the class definition of:
+ *        roaring_set           : A compressed integer set
+ *        roaring_set::iterator : An iterator through it, in key order
+ *    and the functions:
+ *        set_union, set_intersection, set_difference
+ *                              : Set algebra, container against container
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "bits.h"        // for popcount and lowest_bit
+#include <algorithm>     // for std::lower_bound, std::sort and std::set_union
+#include <climits>       // for CHAR_BIT
+#include <cstddef>       // for std::ptrdiff_t
+#include <cstdint>       // for uint16_t, uint32_t and uint64_t
+#include <iterator>      // for std::forward_iterator_tag and std::back_inserter
+#include <type_traits>   // for std::is_integral and std::make_unsigned
+#include <utility>       // for std::swap
+#include <vector>        // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * ROARING SET
+ * Sorted containers, one per distinct high 16 bits
+ ************************************************/
+template <typename T = uint32_t>
+class roaring_set
+{
+   static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "roaring_set holds integers of 32 bits or fewer");
+
+public:
+   //
+   // Construct
+   //
+   roaring_set() : numElements(0) {}
+   roaring_set(const roaring_set& rhs) = default;
+   roaring_set(roaring_set&& rhs) : roaring_set()
+   {
+      swap(rhs);
+   }
+   // from any range of integers, such as an unordered_set<int>
+   template <class Iterator>
+   roaring_set(Iterator first, Iterator last) : roaring_set()
+   {
+      build(first, last);
+   }
+   roaring_set(const std::initializer_list<T>& il) : roaring_set(il.begin(), il.end()) {}
+
+   //
+   // Assign
+   //
+   roaring_set& operator = (const roaring_set& rhs) = default;
+   roaring_set& operator = (roaring_set&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   roaring_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      build(il.begin(), il.end());
+      return *this;
+   }
+   void swap(roaring_set& rhs)
+   {
+      std::swap(highs, rhs.highs);
+      std::swap(containers, rhs.containers);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const;
+
+   //
+   // Access
+   //
+   bool contains(const T& t) const
+   {
+      uint32_t k = key(t);
+      size_t i = position((uint16_t)(k >> 16));
+      return i < highs.size() && highs[i] == (k >> 16) && containers[i].contains((uint16_t)k);
+   }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   bool insert(const T& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (const T& t : il)
+         insert(t);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      highs.clear();
+      containers.clear();
+      numElements = 0;
+   }
+   size_t erase(const T& t);
+
+   //
+   // Compress - turn containers that are mostly long runs into run
+   // containers. Returns how many containers are runs afterwards
+   //
+   size_t optimize();
+
+   //
+   // Status
+   //
+   size_t size() const { return numElements; }
+   bool empty() const  { return numElements == 0; }
+   size_t container_count() const { return containers.size(); }
+   size_t bytes() const;   // what the containers take, roughly
+
+   //
+   // Set algebra
+   //
+   template <typename U>
+   friend roaring_set<U> set_union(const roaring_set<U>& lhs, const roaring_set<U>& rhs);
+   template <typename U>
+   friend roaring_set<U> set_intersection(const roaring_set<U>& lhs, const roaring_set<U>& rhs);
+   template <typename U>
+   friend roaring_set<U> set_difference(const roaring_set<U>& lhs, const roaring_set<U>& rhs);
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   static const uint32_t ARRAY_MAX = 4096;      // above this a bitmap is smaller
+   static const size_t   BITMAP_WORDS = 1024;   // 65536 bits
+   static const uint32_t SIGN = std::is_signed<T>::value ? (uint32_t)1 << (sizeof(T) * CHAR_BIT - 1) : 0;
+
+   enum Kind { ARRAY, BITMAP, RUN };
+
+   // an interval of low bits, both ends included
+   struct Run
+   {
+      uint16_t start;
+      uint16_t last;
+   };
+
+   /************************************************
+    * CONTAINER
+    * The low 16 bits of every key that shares one high 16 bits.
+    * Never empty: the set drops a container when its last key goes
+    ************************************************/
+   struct Container
+   {
+      Container() : kind(ARRAY), cardinality(0) {}
+
+      bool contains(uint16_t low) const
+      {
+         switch (kind)
+         {
+         case ARRAY:
+            return std::binary_search(values.begin(), values.end(), low);
+         case BITMAP:
+            return (bits[low >> 6] >> (low & 63)) & 1;
+         default:
+         {
+            auto it = std::upper_bound(runs.begin(), runs.end(), low,
+                                       [](uint16_t v, const Run& run) { return v < run.start; });
+            return it != runs.begin() && low <= (it - 1)->last;
+         }
+         }
+      }
+
+      bool insert(uint16_t low)
+      {
+         if (kind == RUN)
+            expand();
+         if (kind == ARRAY)
+         {
+            auto it = std::lower_bound(values.begin(), values.end(), low);
+            if (it != values.end() && *it == low)
+               return false;
+            if (cardinality < ARRAY_MAX)
+            {
+               values.insert(it, low);
+               cardinality++;
+               return true;
+            }
+            toBitmap();
+         }
+         uint64_t bit = (uint64_t)1 << (low & 63);
+         if (bits[low >> 6] & bit)
+            return false;
+         bits[low >> 6] |= bit;
+         cardinality++;
+         return true;
+      }
+
+      bool erase(uint16_t low)
+      {
+         if (!contains(low))
+            return false;
+         if (kind == RUN)
+            expand();
+         if (kind == ARRAY)
+            values.erase(std::lower_bound(values.begin(), values.end(), low));
+         else
+            bits[low >> 6] &= ~((uint64_t)1 << (low & 63));
+         cardinality--;
+         if (kind == BITMAP && cardinality <= ARRAY_MAX)
+            toArray();
+         return true;
+      }
+
+      // an array or a bitmap, whichever suits the cardinality
+      void expand()
+      {
+         std::vector<uint16_t> all;
+         all.reserve(cardinality);
+         for (const Run& run : runs)
+            for (uint32_t v = run.start; v <= run.last; v++)
+               all.push_back((uint16_t)v);
+         std::vector<Run>().swap(runs);
+         kind = ARRAY;
+         values.swap(all);
+         if (cardinality > ARRAY_MAX)
+            toBitmap();
+      }
+      void toBitmap()
+      {
+         bits.assign(BITMAP_WORDS, 0);
+         for (uint16_t v : values)
+            bits[v >> 6] |= (uint64_t)1 << (v & 63);
+         std::vector<uint16_t>().swap(values);
+         kind = BITMAP;
+      }
+      void toArray()
+      {
+         values.reserve(cardinality);
+         for (size_t w = 0; w < BITMAP_WORDS; w++)
+            for (uint64_t word = bits[w]; word; word &= word - 1)
+               values.push_back((uint16_t)(w * 64 + lowest_bit(word)));
+         std::vector<uint64_t>().swap(bits);
+         kind = ARRAY;
+      }
+      // an array or a bitmap again, after the bits were set directly
+      void recount()
+      {
+         cardinality = 0;
+         for (uint64_t word : bits)
+            cardinality += (uint32_t)popcount(word);
+         if (cardinality <= ARRAY_MAX)
+            toArray();
+      }
+
+      size_t bytes() const
+      {
+         return kind == ARRAY ? values.size() * sizeof(uint16_t) :
+                kind == BITMAP ? BITMAP_WORDS * sizeof(uint64_t) : runs.size() * sizeof(Run);
+      }
+
+      // iteration: index is into values or runs, low is the key
+      void first(size_t& index, uint32_t& low) const
+      {
+         index = 0;
+         low = kind == ARRAY ? values[0] : kind == RUN ? runs[0].start : nextBit(0);
+      }
+      bool next(size_t& index, uint32_t& low) const
+      {
+         switch (kind)
+         {
+         case ARRAY:
+            if (++index == values.size())
+               return false;
+            low = values[index];
+            return true;
+         case BITMAP:
+            low = nextBit(low + 1);
+            return low < 65536;
+         default:
+            if (low < runs[index].last)
+            {
+               low++;
+               return true;
+            }
+            if (++index == runs.size())
+               return false;
+            low = runs[index].start;
+            return true;
+         }
+      }
+      // the first set bit at or after from, 65536 if none
+      uint32_t nextBit(uint32_t from) const
+      {
+         if (from >= 65536)
+            return 65536;
+         size_t w = from >> 6;
+         uint64_t word = bits[w] & (~(uint64_t)0 << (from & 63));
+         while (!word && ++w < BITMAP_WORDS)
+            word = bits[w];
+         return word ? (uint32_t)(w * 64 + lowest_bit(word)) : 65536;
+      }
+
+      Kind kind;
+      uint32_t cardinality;           // 1 to 65536
+      std::vector<uint16_t> values;   // ARRAY: ascending
+      std::vector<uint64_t> bits;     // BITMAP: BITMAP_WORDS words
+      std::vector<Run> runs;          // RUN: ascending, never touching
+   };
+
+   // keys as unsigned offsets, with the sign bit flipped so that
+   // negative numbers sort below positive ones
+   static uint32_t key(T t)
+   {
+      return (uint32_t)(typename std::make_unsigned<T>::type)t ^ SIGN;
+   }
+   static T value(uint32_t k)
+   {
+      return (T)(typename std::make_unsigned<T>::type)(k ^ SIGN);
+   }
+
+   // where the container for high is, or would go
+   size_t position(uint16_t high) const
+   {
+      return std::lower_bound(highs.begin(), highs.end(), high) - highs.begin();
+   }
+
+   template <class Iterator>
+   void build(Iterator first, Iterator last);
+   static Container unite(const Container& lhs, const Container& rhs);
+   static Container intersect(const Container& lhs, const Container& rhs);
+   static Container subtract(const Container& lhs, const Container& rhs);
+   static const Container& plain(const Container& c, Container& scratch);
+
+   std::vector<uint16_t> highs;          // the high 16 bits of each container, ascending
+   std::vector<Container> containers;    // containers[i] holds the keys under highs[i]
+   size_t numElements;
+};
+
+/************************************************
+ * ROARING SET ITERATOR
+ * Container by container, ascending within each
+ ************************************************/
+template <typename T>
+class roaring_set <T> ::iterator
+{
+public:
+   // so that unordered_set can be built from a roaring_set
+   typedef std::forward_iterator_tag iterator_category;
+   typedef T                         value_type;
+   typedef std::ptrdiff_t            difference_type;
+   typedef const T*                  pointer;
+   typedef T                         reference;
+
+   //
+   // Construct
+   //
+   iterator() : pSet(nullptr), iContainer(0), index(0), low(0) {}
+   iterator(const roaring_set* pSet, size_t iContainer) : pSet(pSet), iContainer(iContainer), index(0), low(0)
+   {
+      if (iContainer < pSet->containers.size())
+         pSet->containers[iContainer].first(index, low);
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return iContainer == rhs.iContainer && index == rhs.index && low == rhs.low;
+   }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access - the key is rebuilt from its two halves
+   //
+   T operator * () const { return value((uint32_t)pSet->highs[iContainer] << 16 | low); }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (!pSet->containers[iContainer].next(index, low))
+         *this = iterator(pSet, iContainer + 1);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   const roaring_set* pSet;
+   size_t iContainer;
+   size_t index;
+   uint32_t low;
+};
+
+/*****************************************
+ * ROARING SET :: BEGIN / END
+ ****************************************/
+template <typename T>
+typename roaring_set <T> ::iterator roaring_set <T> ::begin() const
+{
+   return iterator(this, 0);
+}
+
+template <typename T>
+typename roaring_set <T> ::iterator roaring_set <T> ::end() const
+{
+   return iterator(this, containers.size());
+}
+
+/*****************************************
+ * ROARING SET :: INSERT
+ * Add t's low bits to the container for its high bits, making that
+ * container if need be
+ *     COST   : O(log containers) plus O(4096) into an array
+ ****************************************/
+template <typename T>
+bool roaring_set <T> ::insert(const T& t)
+{
+   uint32_t k = key(t);
+   uint16_t high = (uint16_t)(k >> 16);
+   size_t i = position(high);
+   if (i == highs.size() || highs[i] != high)
+   {
+      highs.insert(highs.begin() + i, high);
+      containers.insert(containers.begin() + i, Container());
+   }
+   if (!containers[i].insert((uint16_t)k))
+      return false;
+   numElements++;
+   return true;
+}
+
+/*****************************************
+ * ROARING SET :: ERASE
+ * Remove t, and its container if that was the last key in it
+ *     COST   : O(log containers) plus O(4096) from an array
+ ****************************************/
+template <typename T>
+size_t roaring_set <T> ::erase(const T& t)
+{
+   uint32_t k = key(t);
+   size_t i = position((uint16_t)(k >> 16));
+   if (i == highs.size() || highs[i] != (k >> 16) || !containers[i].erase((uint16_t)k))
+      return 0;
+   if (containers[i].cardinality == 0)
+   {
+      highs.erase(highs.begin() + i);
+      containers.erase(containers.begin() + i);
+   }
+   numElements--;
+   return 1;
+}
+
+/*****************************************
+ * ROARING SET :: OPTIMIZE
+ * Count each container's runs, and store it as runs when four bytes
+ * a run is smaller than it is now
+ *     COST   : O(n)
+ ****************************************/
+template <typename T>
+size_t roaring_set <T> ::optimize()
+{
+   size_t numRun = 0;
+   for (Container& c : containers)
+   {
+      if (c.kind == RUN)
+      {
+         numRun++;
+         continue;
+      }
+
+      std::vector<Run> runs;
+      size_t index;
+      uint32_t low;
+      c.first(index, low);
+      runs.push_back(Run{ (uint16_t)low, (uint16_t)low });
+      while (c.next(index, low))
+         if (low == (uint32_t)runs.back().last + 1)
+            runs.back().last = (uint16_t)low;
+         else
+            runs.push_back(Run{ (uint16_t)low, (uint16_t)low });
+
+      if (runs.size() * sizeof(Run) < c.bytes())
+      {
+         c.runs.swap(runs);
+         std::vector<uint16_t>().swap(c.values);
+         std::vector<uint64_t>().swap(c.bits);
+         c.kind = RUN;
+         numRun++;
+      }
+   }
+   return numRun;
+}
+
+/*****************************************
+ * ROARING SET :: BYTES
+ * The keys as the containers hold them, plus the directory
+ ****************************************/
+template <typename T>
+size_t roaring_set <T> ::bytes() const
+{
+   size_t num = highs.size() * (sizeof(uint16_t) + sizeof(Container));
+   for (const Container& c : containers)
+      num += c.bytes();
+   return num;
+}
+
+/*****************************************
+ * ROARING SET :: BUILD
+ * Fill an empty set from a range: sort the keys once, then cut the
+ * sorted run into containers, each made in its final form
+ *     COST   : O(n log n)
+ ****************************************/
+template <typename T>
+template <class Iterator>
+void roaring_set <T> ::build(Iterator first, Iterator last)
+{
+   std::vector<uint32_t> ks;
+   for (auto it = first; it != last; ++it)
+      ks.push_back(key(*it));
+   std::sort(ks.begin(), ks.end());
+   ks.erase(std::unique(ks.begin(), ks.end()), ks.end());
+
+   for (size_t i = 0; i < ks.size(); )
+   {
+      uint16_t high = (uint16_t)(ks[i] >> 16);
+      size_t j = i;
+      while (j < ks.size() && (ks[j] >> 16) == high)
+         j++;
+
+      Container c;
+      c.cardinality = (uint32_t)(j - i);
+      c.values.reserve(j - i);
+      for (size_t k = i; k < j; k++)
+         c.values.push_back((uint16_t)ks[k]);
+      if (c.cardinality > ARRAY_MAX)
+         c.toBitmap();
+
+      highs.push_back(high);
+      containers.push_back(std::move(c));
+      i = j;
+   }
+   numElements += ks.size();
+}
+
+/*****************************************
+ * ROARING SET :: PLAIN
+ * A run container as an array or a bitmap, so the set algebra
+ * only ever sees those two. Only a run is expanded, into scratch;
+ * anything else comes back as itself, not a copy
+ ****************************************/
+template <typename T>
+const typename roaring_set <T> ::Container& roaring_set <T> ::plain(const Container& c, Container& scratch)
+{
+   if (c.kind != RUN)
+      return c;
+   scratch = c;
+   scratch.expand();
+   return scratch;
+}
+
+/*****************************************
+ * ROARING SET :: UNITE
+ * Two arrays merge; anything with a bitmap ORs a word at a time
+ ****************************************/
+template <typename T>
+typename roaring_set <T> ::Container roaring_set <T> ::unite(const Container& lhs, const Container& rhs)
+{
+   Container scratchA;
+   Container scratchB;
+   const Container* pA = &plain(lhs, scratchA);
+   const Container* pB = &plain(rhs, scratchB);
+   Container out;
+   if (pA->kind == ARRAY && pB->kind == ARRAY)
+   {
+      out.values.reserve(pA->values.size() + pB->values.size());
+      std::set_union(pA->values.begin(), pA->values.end(), pB->values.begin(), pB->values.end(),
+                     std::back_inserter(out.values));
+      out.cardinality = (uint32_t)out.values.size();
+      if (out.cardinality > ARRAY_MAX)
+         out.toBitmap();
+      return out;
+   }
+
+   if (pA->kind == ARRAY)
+      std::swap(pA, pB);
+   out.kind = BITMAP;
+   if (pB->kind == BITMAP)
+   {
+      out.bits.resize(BITMAP_WORDS);
+      for (size_t w = 0; w < BITMAP_WORDS; w++)
+         out.bits[w] = pA->bits[w] | pB->bits[w];
+   }
+   else
+   {
+      out.bits = pA->bits;
+      for (uint16_t v : pB->values)
+         out.bits[v >> 6] |= (uint64_t)1 << (v & 63);
+   }
+   out.recount();
+   return out;
+}
+
+/*****************************************
+ * ROARING SET :: INTERSECT
+ * Two arrays merge, or gallop when one is much the smaller. An array
+ * and a bitmap test bits. Two bitmaps AND a word at a time
+ ****************************************/
+template <typename T>
+typename roaring_set <T> ::Container roaring_set <T> ::intersect(const Container& lhs, const Container& rhs)
+{
+   Container scratchA;
+   Container scratchB;
+   const Container* pA = &plain(lhs, scratchA);
+   const Container* pB = &plain(rhs, scratchB);
+   if (pA->kind == BITMAP && pB->kind == ARRAY)
+      std::swap(pA, pB);
+   Container out;
+
+   if (pA->kind == ARRAY && pB->kind == ARRAY)
+   {
+      if (pA->values.size() > pB->values.size())
+         std::swap(pA, pB);
+      if (pA->values.size() * 64 < pB->values.size())
+      {
+         auto itB = pB->values.begin();
+         for (uint16_t v : pA->values)
+         {
+            itB = std::lower_bound(itB, pB->values.end(), v);
+            if (itB == pB->values.end())
+               break;
+            if (*itB == v)
+               out.values.push_back(v);
+         }
+      }
+      else
+         std::set_intersection(pA->values.begin(), pA->values.end(), pB->values.begin(), pB->values.end(),
+                               std::back_inserter(out.values));
+   }
+   else if (pA->kind == ARRAY)
+   {
+      for (uint16_t v : pA->values)
+         if ((pB->bits[v >> 6] >> (v & 63)) & 1)
+            out.values.push_back(v);
+   }
+   else
+   {
+      out.kind = BITMAP;
+      out.bits.resize(BITMAP_WORDS);
+      for (size_t w = 0; w < BITMAP_WORDS; w++)
+         out.bits[w] = pA->bits[w] & pB->bits[w];
+      out.recount();
+      return out;
+   }
+   out.cardinality = (uint32_t)out.values.size();
+   return out;
+}
+
+/*****************************************
+ * ROARING SET :: SUBTRACT
+ * What lhs has that rhs does not
+ ****************************************/
+template <typename T>
+typename roaring_set <T> ::Container roaring_set <T> ::subtract(const Container& lhs, const Container& rhs)
+{
+   Container scratchA;
+   Container scratchB;
+   const Container& a = plain(lhs, scratchA);
+   const Container& b = plain(rhs, scratchB);
+   Container out;
+
+   if (a.kind == ARRAY)
+   {
+      if (b.kind == ARRAY)
+         std::set_difference(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                             std::back_inserter(out.values));
+      else
+         for (uint16_t v : a.values)
+            if (!((b.bits[v >> 6] >> (v & 63)) & 1))
+               out.values.push_back(v);
+      out.cardinality = (uint32_t)out.values.size();
+      return out;
+   }
+
+   out.kind = BITMAP;
+   if (b.kind == BITMAP)
+   {
+      out.bits.resize(BITMAP_WORDS);
+      for (size_t w = 0; w < BITMAP_WORDS; w++)
+         out.bits[w] = a.bits[w] & ~b.bits[w];
+   }
+   else
+   {
+      out.bits = a.bits;
+      for (uint16_t v : b.values)
+         out.bits[v >> 6] &= ~((uint64_t)1 << (v & 63));
+   }
+   out.recount();
+   return out;
+}
+
+/*****************************************
+ * SET UNION
+ * Merge the directories; matching containers unite
+ ****************************************/
+template <typename T>
+roaring_set<T> set_union(const roaring_set<T>& lhs, const roaring_set<T>& rhs)
+{
+   roaring_set<T> out;
+   size_t i = 0;
+   size_t j = 0;
+   while (i < lhs.highs.size() || j < rhs.highs.size())
+   {
+      if (j == rhs.highs.size() || (i < lhs.highs.size() && lhs.highs[i] < rhs.highs[j]))
+      {
+         out.highs.push_back(lhs.highs[i]);
+         out.containers.push_back(lhs.containers[i++]);
+      }
+      else if (i == lhs.highs.size() || rhs.highs[j] < lhs.highs[i])
+      {
+         out.highs.push_back(rhs.highs[j]);
+         out.containers.push_back(rhs.containers[j++]);
+      }
+      else
+      {
+         out.highs.push_back(lhs.highs[i]);
+         out.containers.push_back(roaring_set<T>::unite(lhs.containers[i++], rhs.containers[j++]));
+      }
+      out.numElements += out.containers.back().cardinality;
+   }
+   return out;
+}
+
+/*****************************************
+ * SET INTERSECTION
+ * Only containers both sides have can share keys
+ ****************************************/
+template <typename T>
+roaring_set<T> set_intersection(const roaring_set<T>& lhs, const roaring_set<T>& rhs)
+{
+   roaring_set<T> out;
+   size_t i = 0;
+   size_t j = 0;
+   while (i < lhs.highs.size() && j < rhs.highs.size())
+   {
+      if (lhs.highs[i] < rhs.highs[j])
+         i++;
+      else if (rhs.highs[j] < lhs.highs[i])
+         j++;
+      else
+      {
+         auto c = roaring_set<T>::intersect(lhs.containers[i], rhs.containers[j]);
+         if (c.cardinality)
+         {
+            out.highs.push_back(lhs.highs[i]);
+            out.numElements += c.cardinality;
+            out.containers.push_back(std::move(c));
+         }
+         i++;
+         j++;
+      }
+   }
+   return out;
+}
+
+/*****************************************
+ * SET DIFFERENCE
+ * lhs's containers, less what rhs has under the same high bits
+ ****************************************/
+template <typename T>
+roaring_set<T> set_difference(const roaring_set<T>& lhs, const roaring_set<T>& rhs)
+{
+   roaring_set<T> out;
+   size_t j = 0;
+   for (size_t i = 0; i < lhs.highs.size(); i++)
+   {
+      while (j < rhs.highs.size() && rhs.highs[j] < lhs.highs[i])
+         j++;
+      if (j == rhs.highs.size() || rhs.highs[j] != lhs.highs[i])
+      {
+         out.highs.push_back(lhs.highs[i]);
+         out.containers.push_back(lhs.containers[i]);
+         out.numElements += lhs.containers[i].cardinality;
+         continue;
+      }
+      auto c = roaring_set<T>::subtract(lhs.containers[i], rhs.containers[j]);
+      if (c.cardinality)
+      {
+         out.highs.push_back(lhs.highs[i]);
+         out.numElements += c.cardinality;
+         out.containers.push_back(std::move(c));
+      }
+   }
+   return out;
+}
+
+} // namespace custom
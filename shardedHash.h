@@ -0,0 +1,302 @@
+/***********************************************************************
+ * Header:
+ *    SHARDED HASH
+ * Summary:
+ *    A set for high-rate dedup from many threads. Each thread inserts
+ *    into a private unordered_set shard with no synchronization at all.
+ *    When the inserting is done, the shards are folded together by
+ *    relinking their bucket nodes, never by copying them
+ *
+ *    This will contain the class definition of:
+ *        sharded_unordered_set : One unordered_set per inserting thread
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "hash.h"     // because each shard is an unordered_set
+#include "parallel.h" // for parallel_for
+#include <atomic>     // for std::atomic
+#include <algorithm>  // for std::remove_if
+#include <cstdint>    // for uint64_t
+#include <mutex>      // for std::mutex
+#include <stdexcept>  // for std::length_error
+#include <thread>     // for std::thread::hardware_concurrency
+#include <unordered_set> // for std::unordered_set
+#include <vector>     // for std::vector
+
+namespace custom
+{
+
+/************************************************
+ * SHARDED UNORDERED SET
+ * insert() may be called from up to num_shards() threads at once;
+ * each thread is handed a free shard of its own the first time it
+ * inserts, and gives it back when it exits, so a pool that starts
+ * threads again and again needs only as many shards as it has
+ * threads alive. Everything else - contains(), size(), merge(),
+ * snapshot() - reads every shard, so call it only while nobody is
+ * inserting
+ ************************************************/
+template <typename T>
+class sharded_unordered_set
+{
+public:
+   //
+   // Construct
+   //
+   explicit sharded_unordered_set(size_t numShards = 0)
+      : shards(numShards ? numShards :
+               (std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1)),
+        serial(enroll()) {}
+   ~sharded_unordered_set();
+   sharded_unordered_set(const sharded_unordered_set&) = delete;
+   sharded_unordered_set& operator = (const sharded_unordered_set&) = delete;
+
+   //
+   // Insert - no locks
+   //
+   bool insert(const T& t) { return local().insert(t).second; }
+   unordered_set<T>& local();
+
+   //
+   // Access
+   //
+   bool contains(const T& t) const
+   {
+      for (auto& shard : shards)
+         if (shard.set.contains(t))
+            return true;
+      return false;
+   }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Combine
+   //
+   unordered_set<T> merge();
+   const unordered_set<T>& snapshot();
+
+   //
+   // Status
+   //
+   size_t num_shards() const { return shards.size(); }
+
+   // an upper bound: a key in two shards is counted twice until merged
+   size_t size() const
+   {
+      size_t num = 0;
+      for (auto& shard : shards)
+         num += shard.set.size();
+      return num;
+   }
+   bool empty() const { return size() == 0; }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   // padded so two inserting threads never write to the same cache line
+   struct Shard
+   {
+      unordered_set<T> set;
+      std::atomic<bool> owned{ false };   // a live thread inserts here
+      char padding[64];
+   };
+
+   // each set gets a serial number so a thread can remember its shard
+   // in every set without confusing one set with another at the same
+   // address. The registry knows which serials are still alive
+   struct Registry
+   {
+      std::mutex lock;
+      uint64_t nextSerial = 1;
+      std::unordered_set<uint64_t> live;
+      std::atomic<uint64_t> numDestroyed{ 0 };
+   };
+   static Registry& registry()
+   {
+      static Registry r;
+      return r;
+   }
+   static uint64_t enroll();
+
+   // a shard this thread holds
+   struct Claim
+   {
+      uint64_t serial;
+      sharded_unordered_set* pSet;
+      size_t iShard;
+   };
+
+   // the shards this thread holds, and how many sets had been
+   // destroyed when it last forgot the dead ones. As the thread
+   // exits it gives back its shards in the sets still alive
+   struct Claims
+   {
+      std::vector<Claim> shards;
+      uint64_t numDestroyed = 0;
+      ~Claims();
+   };
+
+   void fold(unordered_set<T>& dest, size_t iFirst, size_t iLast);
+
+   std::vector<Shard> shards;
+   uint64_t serial;
+
+   static thread_local Claims claimed;
+};
+
+template <typename T>
+thread_local typename sharded_unordered_set <T> ::Claims sharded_unordered_set <T> ::claimed;
+
+/*****************************************
+ * SHARDED UNORDERED SET :: ENROLL
+ * A serial number for a new set, which is alive until destroyed
+ ****************************************/
+template <typename T>
+uint64_t sharded_unordered_set <T> ::enroll()
+{
+   Registry& r = registry();
+   std::lock_guard<std::mutex> guard(r.lock);
+   r.live.insert(r.nextSerial);
+   return r.nextSerial++;
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: DESTRUCTOR
+ * Let the threads that held a shard of this set forget it. Each
+ * does so itself, the next time it claims a shard
+ ****************************************/
+template <typename T>
+sharded_unordered_set <T> ::~sharded_unordered_set()
+{
+   Registry& r = registry();
+   std::lock_guard<std::mutex> guard(r.lock);
+   r.live.erase(serial);
+   r.numDestroyed++;
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: CLAIMS :: DESTRUCTOR
+ * The thread is going away: free its shard in every set still
+ * alive. The registry's lock keeps a set from being destroyed
+ * while we do, and whoever claims the shard next sees everything
+ * this thread put there
+ ****************************************/
+template <typename T>
+sharded_unordered_set <T> ::Claims::~Claims()
+{
+   if (shards.empty())
+      return;
+   Registry& r = registry();
+   std::lock_guard<std::mutex> guard(r.lock);
+   for (auto& claim : shards)
+      if (r.live.count(claim.serial))
+         claim.pSet->shards[claim.iShard].owned.store(false, std::memory_order_release);
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: LOCAL
+ * This thread's shard. The first call from a thread claims a
+ * shard no live thread owns, and first drops the claims on sets
+ * destroyed since, so a thread holds claims only on sets still
+ * alive; after that it is a short thread-local lookup
+ ****************************************/
+template <typename T>
+unordered_set<T>& sharded_unordered_set <T> ::local()
+{
+   for (auto& claim : claimed.shards)
+      if (claim.serial == serial)
+         return shards[claim.iShard].set;
+
+   Registry& r = registry();
+   if (claimed.numDestroyed != r.numDestroyed)
+   {
+      std::lock_guard<std::mutex> guard(r.lock);
+      claimed.numDestroyed = r.numDestroyed;
+      claimed.shards.erase(std::remove_if(claimed.shards.begin(), claimed.shards.end(),
+         [&r](const Claim& claim) { return r.live.count(claim.serial) == 0; }),
+         claimed.shards.end());
+   }
+
+   for (size_t i = 0; i < shards.size(); i++)
+   {
+      bool expected = false;
+      if (!shards[i].owned.load() && shards[i].owned.compare_exchange_strong(expected, true, std::memory_order_acquire))
+      {
+         claimed.shards.push_back(Claim{ serial, this, i });
+         return shards[i].set;
+      }
+   }
+   throw std::length_error("sharded_unordered_set: more inserting threads than shards");
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: FOLD
+ * Move every node of the shards [iFirst, iLast) into dest, bucket by
+ * bucket across the cores. A shard never holds a key twice, so its
+ * bucket only needs checking against what dest already has, which a
+ * bucket_index remembers; the keys dest lacks are spliced over in one
+ * step and the rest destroyed. A node keeps its address as it is
+ * spliced, so the index stays good for the next shard
+ *     COST   : O(n), no allocation of nodes
+ ****************************************/
+template <typename T>
+void sharded_unordered_set <T> ::fold(unordered_set<T>& dest, size_t iFirst, size_t iLast)
+{
+   parallel_for(dest.range(), [&](const bucket_range<custom::list<T>>& r)
+   {
+      for (custom::list<T>* pBucket = r.begin(); pBucket != r.end(); ++pBucket)
+      {
+         size_t i = pBucket - dest.buckets;
+         size_t num = pBucket->size();
+         for (size_t iShard = iFirst; iShard < iLast; iShard++)
+            num += shards[iShard].set.buckets[i].size();
+
+         bucket_index<T> kept(num, dest.bucket_count());
+         for (auto it = pBucket->begin(); it != pBucket->end(); ++it)
+            kept.insert(&*it);
+         for (size_t iShard = iFirst; iShard < iLast; iShard++)
+         {
+            custom::list<T>& from = shards[iShard].set.buckets[i];
+            from.remove_if([&kept](const T& t) { return !kept.insert(&t); });
+            pBucket->splice(pBucket->end(), from);
+         }
+      }
+   });
+
+   dest.numElements = 0;
+   for (size_t i = 0; i < dest.bucket_count(); i++)
+      dest.numElements += (int)dest.buckets[i].size();
+   for (size_t iShard = iFirst; iShard < iLast; iShard++)
+      shards[iShard].set.numElements = 0;
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: MERGE
+ * Take every key out of the shards as one set
+ ****************************************/
+template <typename T>
+unordered_set<T> sharded_unordered_set <T> ::merge()
+{
+   unordered_set<T> out;
+   fold(out, 0, shards.size());
+   return out;
+}
+
+/*****************************************
+ * SHARDED UNORDERED SET :: SNAPSHOT
+ * Fold every shard into the first one and return it. The
+ * threads keep their shards, so inserting can carry on afterwards
+ ****************************************/
+template <typename T>
+const unordered_set<T>& sharded_unordered_set <T> ::snapshot()
+{
+   fold(shards[0].set, 1, shards.size());
+   return shards[0].set;
+}
+
+} // namespace custom
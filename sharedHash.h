@@ -0,0 +1,348 @@
+/***********************************************************************
+ * Header:
+ *    SHARED HASH
+ * Summary:
+ *    A copy-on-write unordered_set. Copying one is O(1): the copies
+ *    share the same table of buckets under a reference count. A write
+ *    copies the table of bucket pointers and clones only the bucket it
+ *    touches, then publishes the new table in one atomic step, so a
+ *    reader holding a snapshot never sees half of an update, and a
+ *    writer never waits for a reader to finish walking one.
+ *
+ *    That step is not lock-free. The std::atomic_load family on a
+ *    shared_ptr takes a lock, one of a small pool of mutexes in
+ *    libstdc++ and one spin lock in MSVC, held only for the pointer
+ *    and count swap, so readers and writers do briefly serialize
+ *    there. Those functions are deprecated in C++20 in favour
+ *    of std::atomic<std::shared_ptr>, which is not lock-free either.
+ *    Readers that must never block want the epochs of epochHash.h
+ *
+ *    The table has a fixed ten buckets, so the bucket a write clones
+ *    holds about a tenth of the set: each insert or erase is O(n/10).
+ *    This suits sets that are read far more often than written.
+ *
+ *    This will contain the class definition of:
+ *        shared_unordered_set           : A hash that shares its buckets
+ *        shared_unordered_set::iterator : A read-only iterator through it
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#include "list.h"     // because each bucket is a list
+#include <atomic>     // for std::atomic_load and friends on shared_ptr
+#include <memory>     // for std::shared_ptr
+
+namespace custom
+{
+
+/************************************************
+ * SHARED UNORDERED SET
+ * The buckets are immutable once published. Every member may be
+ * called from any thread on the same object at the same time; the
+ * only shared state is the table pointer, and it is always read and
+ * replaced atomically. Writers that race retry against the newer table
+ ************************************************/
+template <typename T>
+class shared_unordered_set
+{
+public:
+   //
+   // Construct
+   //
+   shared_unordered_set() : pTable(std::make_shared<const Table>()) {}
+   shared_unordered_set(const shared_unordered_set& rhs)
+      : pTable(std::atomic_load(&rhs.pTable)) {}
+   template <class Iterator>
+   shared_unordered_set(Iterator first, Iterator last)
+      : pTable(std::make_shared<const Table>())
+   {
+      for (auto it = first; it != last; ++it)
+         insert(*it);
+   }
+   shared_unordered_set(const std::initializer_list<T>& il)
+      : shared_unordered_set(il.begin(), il.end()) {}
+
+   //
+   // Assign
+   //
+   shared_unordered_set& operator = (const shared_unordered_set& rhs)
+   {
+      std::atomic_store(&pTable, std::atomic_load(&rhs.pTable));
+      return *this;
+   }
+
+   // a copy that later writes to this set will not disturb
+   shared_unordered_set snapshot() const { return *this; }
+
+   //
+   // Hash
+   //
+   size_t bucket_count() const { return NUM_BUCKETS; }
+   size_t bucket(const T& t) const { return t % bucket_count(); }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const { return iterator(); }
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const;
+   bool contains(const T& t) const
+   {
+      std::shared_ptr<const Table> p = std::atomic_load(&pTable);
+      const custom::list<T>* pBucket = p->buckets[bucket(t)].get();
+      return pBucket && pBucket->find(t) != pBucket->end();
+   }
+   size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+   //
+   // Insert
+   //
+   bool insert(const T& t);
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t);
+   void clear() { std::atomic_store(&pTable, std::make_shared<const Table>()); }
+
+   //
+   // Status
+   //
+   size_t size()  const { return std::atomic_load(&pTable)->numElements; }
+   bool   empty() const { return size() == 0; }
+   size_t bucket_size(size_t i) const
+   {
+      std::shared_ptr<const Table> p = std::atomic_load(&pTable);
+      return p->buckets[i] ? p->buckets[i]->size() : 0;
+   }
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   // fixed, so a write copies ten pointers and a tenth of the set
+   static const size_t NUM_BUCKETS = 10;
+
+   // one published version of the set. An empty bucket is nullptr
+   struct Table
+   {
+      Table() : numElements(0) {}
+      std::shared_ptr<const custom::list<T>> buckets[NUM_BUCKETS];
+      size_t numElements;
+   };
+
+   template <class Edit>
+   bool update(size_t iBucket, Edit edit);
+
+   std::shared_ptr<const Table> pTable;   // only touched through atomic_load/store
+};
+
+/************************************************
+ * SHARED UNORDERED SET ITERATOR
+ * Walks the table that was current when it was made. The iterator
+ * holds that table, so later writes to the set cannot pull the
+ * elements out from under it
+ ************************************************/
+template <typename T>
+class shared_unordered_set <T> ::iterator
+{
+public:
+   //
+   // Construct
+   //
+   iterator() : iBucket(NUM_BUCKETS), itList(nullptr) {}
+   iterator(const std::shared_ptr<const Table>& pTable, size_t iBucket,
+            typename custom::list<T>::const_iterator itList)
+      : pTable(pTable), iBucket(iBucket), itList(itList) {}
+
+   //
+   // Compare - the table is not part of it, so any end() matches
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return iBucket == rhs.iBucket && itList == rhs.itList;
+   }
+   bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+   //
+   // Access
+   //
+   const T& operator * () const { return *itList; }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ();
+   iterator operator ++ (int)
+   {
+      iterator itReturn(*this);
+      ++(*this);
+      return itReturn;
+   }
+
+   // begin() needs settle()
+   friend class shared_unordered_set <T>;
+
+#ifdef DEBUG // make this visible to the unit tests
+public:
+#else
+private:
+#endif
+   // the first element at or after bucket i, or end()
+   iterator& settle();
+
+   std::shared_ptr<const Table> pTable;
+   size_t iBucket;
+   typename custom::list<T>::const_iterator itList;
+};
+
+/*****************************************
+ * SHARED UNORDERED SET :: ITERATOR :: SETTLE
+ * Skip forward past the empty buckets
+ ****************************************/
+template <typename T>
+typename shared_unordered_set <T> ::iterator& shared_unordered_set <T> ::iterator::settle()
+{
+   for (; iBucket < NUM_BUCKETS; iBucket++)
+   {
+      const custom::list<T>* pBucket = pTable->buckets[iBucket].get();
+      if (pBucket && !pBucket->empty())
+      {
+         itList = pBucket->begin();
+         return *this;
+      }
+   }
+   pTable.reset();
+   itList = typename custom::list<T>::const_iterator(nullptr);
+   return *this;
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: ITERATOR :: INCREMENT
+ * Advance by one element, moving to the next
+ * non-empty bucket when this one runs out
+ ****************************************/
+template <typename T>
+typename shared_unordered_set <T> ::iterator& shared_unordered_set <T> ::iterator::operator ++ ()
+{
+   if (iBucket == NUM_BUCKETS)
+      return *this;
+   if (++itList != pTable->buckets[iBucket]->end())
+      return *this;
+   iBucket++;
+   return settle();
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: BEGIN
+ * The first element of the current table
+ ****************************************/
+template <typename T>
+typename shared_unordered_set <T> ::iterator shared_unordered_set <T> ::begin() const
+{
+   iterator it(std::atomic_load(&pTable), 0, typename custom::list<T>::const_iterator(nullptr));
+   return it.settle();
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: FIND
+ * Look in the one bucket t could be in
+ ****************************************/
+template <typename T>
+typename shared_unordered_set <T> ::iterator shared_unordered_set <T> ::find(const T& t) const
+{
+   std::shared_ptr<const Table> p = std::atomic_load(&pTable);
+   size_t iBucket = bucket(t);
+   const custom::list<T>* pBucket = p->buckets[iBucket].get();
+   if (pBucket == nullptr)
+      return end();
+   auto itList = pBucket->find(t);
+   if (itList == pBucket->end())
+      return end();
+   return iterator(p, iBucket, itList);
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: UPDATE
+ * Clone bucket iBucket, let edit(bucket) change the clone and tell
+ * us by how much the size moved, then publish a new table that
+ * shares every other bucket with the old one. If another writer
+ * published first, start over from its table. Returns false and
+ * publishes nothing when edit reports no change
+ *     COST   : O(n/10), cloning one of the ten buckets
+ ****************************************/
+template <typename T>
+template <class Edit>
+bool shared_unordered_set <T> ::update(size_t iBucket, Edit edit)
+{
+   std::shared_ptr<const Table> pOld = std::atomic_load(&pTable);
+   for (;;)
+   {
+      const custom::list<T>* pBucketOld = pOld->buckets[iBucket].get();
+      std::shared_ptr<custom::list<T>> pBucket = pBucketOld ?
+         std::make_shared<custom::list<T>>(*pBucketOld) :
+         std::make_shared<custom::list<T>>();
+
+      int delta = edit(*pBucket);
+      if (delta == 0)
+         return false;
+
+      std::shared_ptr<Table> pNew = std::make_shared<Table>(*pOld);
+      if (pBucket->empty())
+         pNew->buckets[iBucket].reset();
+      else
+         pNew->buckets[iBucket] = pBucket;
+      pNew->numElements += delta;
+
+      std::shared_ptr<const Table> pPublish(pNew);
+      if (std::atomic_compare_exchange_strong(&pTable, &pOld, pPublish))
+         return true;
+   }
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: INSERT
+ * Add t if it is not already there
+ ****************************************/
+template <typename T>
+bool shared_unordered_set <T> ::insert(const T& t)
+{
+   if (contains(t))
+      return false;
+   return update(bucket(t), [&t](custom::list<T>& bucket)
+   {
+      if (bucket.find(t) != bucket.end())
+         return 0;
+      bucket.push_back(t);
+      return 1;
+   });
+}
+
+/*****************************************
+ * SHARED UNORDERED SET :: ERASE
+ * Remove t, returning how many were removed
+ ****************************************/
+template <typename T>
+size_t shared_unordered_set <T> ::erase(const T& t)
+{
+   if (!contains(t))
+      return 0;
+   return update(bucket(t), [&t](custom::list<T>& bucket)
+   {
+      auto it = bucket.find(t);
+      if (it == bucket.end())
+         return 0;
+      bucket.erase(it);
+      return -1;
+   }) ? 1 : 0;
+}
+
+} // namespace custom
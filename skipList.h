@@ -0,0 +1,474 @@
+/***********************************************************************
+ * Header:
+ *    SKIP LIST
+ * Summary:
+ *    A sorted doubly linked list with express lanes. Every node is on
+ *    level 0, the ordinary list; a quarter of them are also on level 1,
+ *    a sixteenth on level 2, and so on, each level linking only its own
+ *    nodes. A search runs along the top level until the next step would
+ *    overshoot, drops a level, and repeats, so lower_bound, find, insert
+ *    and erase all take O(log n) on average where list::find takes O(n).
+ *    The level-0 list is doubly linked, so iteration runs in order in
+ *    both directions just as it does through list
+ *
+ *    This will contain the class definition of:
+ *        skip_list           : A sorted list with O(log n) search
+ *        skip_list::iterator : An iterator through it, in order
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include "pair.h"       // because insert() returns a pair
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <functional>   // for std::less
+#include <new>          // for placement new
+#include <utility>      // for std::swap
+
+namespace custom
+{
+    /**************************************************
+     * SKIP LIST
+     * A set kept in the order of C. Two elements are the same
+     * when neither comes before the other
+     **************************************************/
+    template <typename T, typename C = std::less<T>>
+    class skip_list
+    {
+    public:
+        //
+        // Construct
+        //
+
+        explicit skip_list(const C& c = C()) : compare(c), numElements(0), level(1), pTail(nullptr), seed(SEED)
+        {
+            for (size_t i = 0; i < MAX_LEVEL; i++)
+                head[i] = nullptr;
+        }
+        skip_list(const skip_list& rhs) : skip_list(rhs.compare)
+        {
+            appendSorted(rhs.begin(), rhs.end());
+        }
+        skip_list(skip_list&& rhs) : skip_list(rhs.compare)
+        {
+            swap(rhs);
+        }
+        skip_list(const std::initializer_list<T>& il) : skip_list(il.begin(), il.end()) {}
+        template <class Iterator>
+        skip_list(Iterator first, Iterator last, const C& c = C()) : skip_list(c)
+        {
+            for (auto it = first; it != last; ++it)
+                insert(*it);
+        }
+        ~skip_list() { clear(); }
+
+        //
+        // Assign
+        //
+
+        skip_list& operator = (const skip_list& rhs)
+        {
+            if (this != &rhs)
+            {
+                skip_list copy(rhs);
+                swap(copy);
+            }
+            return *this;
+        }
+        skip_list& operator = (skip_list&& rhs)
+        {
+            clear();
+            swap(rhs);
+            return *this;
+        }
+        skip_list& operator = (const std::initializer_list<T>& il)
+        {
+            clear();
+            for (const T& t : il)
+                insert(t);
+            return *this;
+        }
+        void swap(skip_list& rhs)
+        {
+            std::swap(compare, rhs.compare);
+            std::swap(numElements, rhs.numElements);
+            std::swap(level, rhs.level);
+            std::swap(head, rhs.head);
+            std::swap(pTail, rhs.pTail);
+            std::swap(seed, rhs.seed);
+        }
+
+        //
+        // Iterator - elements cannot change in place, they decide
+        // their order
+        //
+
+        class iterator;
+        iterator begin()  const { return iterator(head[0]); }
+        iterator rbegin() const { return iterator(pTail); }
+        iterator end()    const { return iterator(nullptr); }
+
+        //
+        // Access
+        //
+
+        iterator lower_bound(const T& t) const;
+        iterator upper_bound(const T& t) const;
+        iterator find(const T& t) const;
+        bool contains(const T& t) const { return find(t) != end(); }
+        size_t count(const T& t) const { return contains(t) ? 1 : 0; }
+
+        //
+        // Insert
+        //
+
+        custom::pair<iterator, bool> insert(const T& t);
+
+        //
+        // Remove
+        //
+
+        void clear();
+        iterator erase(const iterator& it);
+        size_t erase(const T& t);
+
+        //
+        // Status
+        //
+
+        bool empty()  const { return numElements == 0; }
+        size_t size() const { return numElements; }
+        size_t height() const { return level; }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        static const size_t MAX_LEVEL = 32;   // enough for 4^32 elements
+        static const uint64_t SEED = 0x9E3779B97F4A7C15ull;
+
+        // the element, its level-0 predecessor, and one successor per
+        // level it is on. The successors sit in the same allocation,
+        // just past the node
+        struct Node
+        {
+            Node(const T& data, size_t height) : data(data), pPrev(nullptr), height(height)
+            {
+                for (size_t i = 0; i < height; i++)
+                    pNext()[i] = nullptr;
+            }
+            Node** pNext() { return reinterpret_cast<Node**>(this + 1); }
+            Node* const* pNext() const { return reinterpret_cast<Node* const*>(this + 1); }
+
+            T data;
+            Node* pPrev;
+            size_t height;
+        };
+
+        static Node* allocate(const T& data, size_t height);
+        static void deallocate(Node* p);
+        size_t randomHeight();
+        template <class Iterator>
+        void appendSorted(Iterator first, Iterator last);
+
+        // the last link on each level that comes before t. With
+        // strict, before means less than; otherwise not greater
+        void predecessors(const T& t, bool strict, Node** update[]) const;
+
+        C compare;
+        size_t numElements;
+        size_t level;               // how many levels are in use
+        Node* head[MAX_LEVEL];      // the first node on each level
+        Node* pTail;                // the last node on level 0
+        uint64_t seed;              // for randomHeight()
+    };
+
+    /*************************************************
+     * SKIP LIST ITERATOR
+     * Walks level 0, which is an ordinary doubly linked list
+     *************************************************/
+    template <typename T, typename C>
+    class skip_list <T, C> ::iterator
+    {
+    public:
+        iterator() : p(nullptr) {}
+        explicit iterator(const Node* p) : p(p) {}
+
+        bool operator != (const iterator& rhs) const { return rhs.p != p; }
+        bool operator == (const iterator& rhs) const { return rhs.p == p; }
+
+        const T& operator * () const { return p->data; }
+
+        iterator& operator ++ ()
+        {
+            p = p->pNext()[0];
+            return *this;
+        }
+        iterator operator ++ (int postfix)
+        {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        // prefix decrement: stays put at the front, as list's does
+        iterator& operator -- ()
+        {
+            if (p->pPrev)
+                p = p->pPrev;
+            return *this;
+        }
+        iterator operator -- (int postfix)
+        {
+            iterator it(*this);
+            --(*this);
+            return it;
+        }
+
+        friend class skip_list <T, C>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        const Node* p;   // null at the end
+    };
+
+    /*****************************************
+     * SKIP LIST :: PREDECESSORS
+     * Run along each level, from the top down, as far as the
+     * elements stay before t, and remember where each level stopped
+     *     INPUT  : what to look for, and where to write the links
+     *     OUTPUT : update[i] is the link on level i that points at
+     *              the first node not before t
+     *     COST   : O(log n) on average
+     ****************************************/
+    template <typename T, typename C>
+    void skip_list <T, C> ::predecessors(const T& t, bool strict, Node** update[]) const
+    {
+        Node** pLinks = const_cast<Node**>(head);
+        for (size_t i = level; i-- > 0; )
+        {
+            while (pLinks[i] && (strict ? compare(pLinks[i]->data, t) : !compare(t, pLinks[i]->data)))
+                pLinks = pLinks[i]->pNext();
+            update[i] = pLinks + i;
+        }
+    }
+
+    /*****************************************
+     * SKIP LIST :: LOWER BOUND / UPPER BOUND
+     * The first element not before t, or the first after it
+     *     COST   : O(log n) on average
+     ****************************************/
+    template <typename T, typename C>
+    typename skip_list <T, C> ::iterator skip_list <T, C> ::lower_bound(const T& t) const
+    {
+        Node** update[MAX_LEVEL];
+        predecessors(t, true /*strict*/, update);
+        return iterator(*update[0]);
+    }
+
+    template <typename T, typename C>
+    typename skip_list <T, C> ::iterator skip_list <T, C> ::upper_bound(const T& t) const
+    {
+        Node** update[MAX_LEVEL];
+        predecessors(t, false /*strict*/, update);
+        return iterator(*update[0]);
+    }
+
+    /*****************************************
+     * SKIP LIST :: FIND
+     * The lower bound, if it is t
+     *     COST   : O(log n) on average
+     ****************************************/
+    template <typename T, typename C>
+    typename skip_list <T, C> ::iterator skip_list <T, C> ::find(const T& t) const
+    {
+        iterator it = lower_bound(t);
+        if (it.p && !compare(t, it.p->data))
+            return it;
+        return end();
+    }
+
+    /*****************************************
+     * SKIP LIST :: INSERT
+     * Find where t goes, pick how many levels it will be on, and
+     * link it in on each of them
+     *     INPUT  : the element to add
+     *     OUTPUT : where it is, and whether it is new
+     *     COST   : O(log n) on average
+     ****************************************/
+    template <typename T, typename C>
+    custom::pair<typename skip_list <T, C> ::iterator, bool> skip_list <T, C> ::insert(const T& t)
+    {
+        Node** update[MAX_LEVEL];
+        predecessors(t, true /*strict*/, update);
+        Node* pNext = *update[0];
+        if (pNext && !compare(t, pNext->data))
+            return custom::pair<iterator, bool>(iterator(pNext), false);
+
+        size_t height = randomHeight();
+        for (; level < height; level++)
+            update[level] = head + level;
+
+        Node* pNew = allocate(t, height);
+        for (size_t i = 0; i < height; i++)
+        {
+            pNew->pNext()[i] = *update[i];
+            *update[i] = pNew;
+        }
+
+        // level 0 also links backwards
+        pNew->pPrev = pNext ? pNext->pPrev : pTail;
+        if (pNext)
+            pNext->pPrev = pNew;
+        else
+            pTail = pNew;
+
+        numElements++;
+        return custom::pair<iterator, bool>(iterator(pNew), true);
+    }
+
+    /*****************************************
+     * SKIP LIST :: ERASE
+     * Unlink the node from every level it is on
+     *     INPUT  : the element, or an iterator to it
+     *     OUTPUT : the element after it, or how many went
+     *     COST   : O(log n) on average
+     ****************************************/
+    template <typename T, typename C>
+    size_t skip_list <T, C> ::erase(const T& t)
+    {
+        Node** update[MAX_LEVEL];
+        predecessors(t, true /*strict*/, update);
+        Node* p = *update[0];
+        if (!p || compare(t, p->data))
+            return 0;
+
+        for (size_t i = 0; i < p->height; i++)
+            *update[i] = p->pNext()[i];
+        if (p->pNext()[0])
+            p->pNext()[0]->pPrev = p->pPrev;
+        else
+            pTail = p->pPrev;
+        deallocate(p);
+
+        while (level > 1 && head[level - 1] == nullptr)
+            level--;
+        numElements--;
+        return 1;
+    }
+
+    template <typename T, typename C>
+    typename skip_list <T, C> ::iterator skip_list <T, C> ::erase(const iterator& it)
+    {
+        if (!it.p)
+            return end();
+        iterator itNext(it.p->pNext()[0]);
+        erase(it.p->data);
+        return itNext;
+    }
+
+    /*****************************************
+     * SKIP LIST :: CLEAR
+     * Free every node by walking level 0
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T, typename C>
+    void skip_list <T, C> ::clear()
+    {
+        Node* p = head[0];
+        while (p)
+        {
+            Node* pNext = p->pNext()[0];
+            deallocate(p);
+            p = pNext;
+        }
+        for (size_t i = 0; i < MAX_LEVEL; i++)
+            head[i] = nullptr;
+        pTail = nullptr;
+        level = 1;
+        numElements = 0;
+    }
+
+    /*****************************************
+     * SKIP LIST :: ALLOCATE / DEALLOCATE
+     * One block holds the node and its height successors
+     ****************************************/
+    template <typename T, typename C>
+    typename skip_list <T, C> ::Node* skip_list <T, C> ::allocate(const T& data, size_t height)
+    {
+        void* pBlock = ::operator new(sizeof(Node) + height * sizeof(Node*));
+        try
+        {
+            return new (pBlock) Node(data, height);
+        }
+        catch (...)
+        {
+            ::operator delete(pBlock);
+            throw;
+        }
+    }
+
+    template <typename T, typename C>
+    void skip_list <T, C> ::deallocate(Node* p)
+    {
+        p->~Node();
+        ::operator delete(p);
+    }
+
+    /*****************************************
+     * SKIP LIST :: RANDOM HEIGHT
+     * One level, plus one more for each time two random bits come
+     * up zero: a node is on level i with probability 4^-i
+     *     COST   : O(1)
+     ****************************************/
+    template <typename T, typename C>
+    size_t skip_list <T, C> ::randomHeight()
+    {
+        // xorshift64
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        size_t height = 1;
+        for (uint64_t bits = seed; height < MAX_LEVEL && (bits & 3) == 0; bits >>= 2)
+            height++;
+        return height;
+    }
+
+    /*****************************************
+     * SKIP LIST :: APPEND SORTED
+     * Build an empty list from a range already in order by keeping
+     * the last link of each level, so there is no searching
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T, typename C>
+    template <class Iterator>
+    void skip_list <T, C> ::appendSorted(Iterator first, Iterator last)
+    {
+        Node** pLast[MAX_LEVEL];
+        for (size_t i = 0; i < MAX_LEVEL; i++)
+            pLast[i] = head + i;
+
+        for (auto it = first; it != last; ++it)
+        {
+            size_t height = randomHeight();
+            Node* pNew = allocate(*it, height);
+            for (size_t i = 0; i < height; i++)
+            {
+                *pLast[i] = pNew;
+                pLast[i] = pNew->pNext() + i;
+            }
+            if (height > level)
+                level = height;
+            pNew->pPrev = pTail;
+            pTail = pNew;
+            numElements++;
+        }
+    }
+
+} // namespace custom
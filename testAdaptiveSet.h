@@ -0,0 +1,215 @@
+/***********************************************************************
+ * Header:
+ *    TEST ADAPTIVE SET
+ * Summary:
+ *    Unit tests for the set that switches between an array and a hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "adaptiveSet.h"
+#include "unitTest.h"
+
+#include <functional>
+#include <vector>
+
+class TestAdaptiveSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructIterator_small();
+      test_constructIterator_large();
+
+      // Insert
+      test_insert_sorted();
+      test_insert_duplicate();
+      test_insert_compare();
+      test_insert_migrates();
+
+      // Remove
+      test_erase_small();
+      test_erase_staysHashed();
+      test_erase_migratesBack();
+      test_clear();
+
+      report("AdaptiveSet");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty array
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::adaptive_set<int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.is_small());
+      assertUnit(s.max_small() == 64);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // a short range is sorted once
+   void test_constructIterator_small()
+   {  // setup
+      std::vector<int> values = { 31, 7, 19, 7 };
+      // exercise
+      custom::adaptive_set<int> s(values.begin(), values.end());
+      // verify
+      assertUnit(s.is_small());
+      assertUnit(s.sorted == std::vector<int>({ 7, 19, 31 }));
+   }  // teardown
+
+   // a long range goes straight to the hash
+   void test_constructIterator_large()
+   {  // setup
+      std::vector<int> values;
+      for (int i = 0; i < 100; i++)
+         values.push_back(i);
+      // exercise
+      custom::adaptive_set<int> s(values.begin(), values.end(), 10);
+      // verify
+      assertUnit(!s.is_small());
+      assertUnit(s.sorted.empty());
+      assertUnit(s.size() == 100);
+      assertUnit(s.contains(99));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the array stays in order
+   void test_insert_sorted()
+   {  // setup
+      custom::adaptive_set<int> s;
+      // exercise
+      auto result = s.insert(19);
+      s.insert(31);
+      s.insert(7);
+      // verify
+      assertUnit(result.second);
+      assertUnit(s.sorted == std::vector<int>({ 7, 19, 31 }));
+      assertUnit(s.contains(31));
+      assertUnit(!s.contains(8));
+   }  // teardown
+
+   // a duplicate points at the original
+   void test_insert_duplicate()
+   {  // setup
+      custom::adaptive_set<int> s{ 7, 19 };
+      // exercise
+      auto result = s.insert(19);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 19);
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   // the array follows the comparison it was given
+   void test_insert_compare()
+   {  // setup
+      custom::adaptive_set<int, std::greater<int>> s;
+      // exercise
+      s.insert(7);
+      s.insert(31);
+      s.insert(19);
+      // verify
+      assertUnit(s.sorted == std::vector<int>({ 31, 19, 7 }));
+      assertUnit(s.contains(19));
+   }  // teardown
+
+   // one past the threshold moves everything to the hash
+   void test_insert_migrates()
+   {  // setup
+      custom::adaptive_set<int> s(4);
+      s = { 1, 2, 3, 4 };
+      assertUnit(s.is_small());
+      // exercise
+      auto result = s.insert(5);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 5);
+      assertUnit(!s.is_small());
+      assertUnit(s.sorted.empty());
+      assertUnit(s.size() == 5);
+      assertUnit(s.contains(1));
+      assertUnit(s.contains(5));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase from the array returns the next element
+   void test_erase_small()
+   {  // setup
+      custom::adaptive_set<int> s{ 7, 19, 31 };
+      // exercise
+      auto it = s.erase(19);
+      // verify
+      assertUnit(*it == 31);
+      assertUnit(s.size() == 2);
+      assertUnit(s.erase(8) == s.end());
+   }  // teardown
+
+   // above half the threshold the hash stays
+   void test_erase_staysHashed()
+   {  // setup
+      custom::adaptive_set<int> s(8);
+      for (int i = 0; i < 10; i++)
+         s.insert(i);
+      // exercise
+      s.erase(0);
+      s.erase(1);
+      s.erase(2);
+      s.erase(3);
+      s.erase(4);
+      // verify
+      assertUnit(!s.is_small());
+      assertUnit(s.size() == 5);
+   }  // teardown
+
+   // at half the threshold it is an array again
+   void test_erase_migratesBack()
+   {  // setup
+      custom::adaptive_set<int> s(8);
+      for (int i = 0; i < 10; i++)
+         s.insert(i);
+      // exercise
+      for (int i = 0; i < 10; i += 2)
+         s.erase(i);
+      s.erase(9);
+      // verify
+      assertUnit(s.is_small());
+      assertUnit(s.hashed.empty());
+      assertUnit(s.sorted == std::vector<int>({ 1, 3, 5, 7 }));
+   }  // teardown
+
+   // clear starts over as an array
+   void test_clear()
+   {  // setup
+      custom::adaptive_set<int> s(2);
+      s = { 1, 2, 3 };
+      assertUnit(!s.is_small());
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.is_small());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+};
+
+#endif // DEBUG
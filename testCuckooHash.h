@@ -0,0 +1,277 @@
+/***********************************************************************
+ * Header:
+ *    TEST CUCKOO HASH
+ * Summary:
+ *    Unit tests for the bucketized cuckoo hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "cuckooHash.h"
+#include "unitTest.h"
+
+#include <vector>
+
+class TestCuckooHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_roundsUp();
+      test_constructIterator();
+      test_constructCopy();
+
+      // Insert
+      test_insert_firstBucket();
+      test_insert_duplicate();
+      test_insert_evicts();
+      test_insert_rehashes();
+
+      // Access
+      test_find_twoBuckets();
+      test_iterate_everything();
+
+      // Remove
+      test_erase_present();
+      test_erase_missing();
+      test_clear();
+
+      report("CuckooHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // eight empty buckets
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::cuckoo_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.size() == 0);
+      assertUnit(us.empty());
+      assertUnit(us.bucket_count() == 8);
+      assertUnit(us.begin() == us.end());
+   }  // teardown
+
+   // the bucket count is a power of two
+   void test_construct_roundsUp()
+   {  // setup
+      // exercise
+      custom::cuckoo_unordered_set<std::size_t> us(20);
+      // verify
+      assertUnit(us.bucket_count() == 32);
+   }  // teardown
+
+   // fill from a range
+   void test_constructIterator()
+   {  // setup
+      std::size_t values[] = { 31, 49, 67, 59, 31 };
+      // exercise
+      custom::cuckoo_unordered_set<std::size_t> us(values, values + 5);
+      // verify
+      assertUnit(us.size() == 4);
+      assertUnit(us.contains(31));
+      assertUnit(us.contains(59));
+   }  // teardown
+
+   // a copy has its own buckets
+   void test_constructCopy()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> usSrc{ 31, 49, 67, 59 };
+      // exercise
+      custom::cuckoo_unordered_set<std::size_t> usDes(usSrc);
+      usSrc.erase(31);
+      // verify
+      assertUnit(usDes.size() == 4);
+      assertUnit(usDes.contains(31));
+      assertUnit(!usSrc.contains(31));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // an empty table takes a key in its first bucket
+   void test_insert_firstBucket()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      // exercise
+      auto result = us.insert(31);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 31);
+      assertUnit(us.size() == 1);
+      assertUnit(us.bucket_size(us.bucket1(31)) == 1);
+   }  // teardown
+
+   // a duplicate points at the original
+   void test_insert_duplicate()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      us.insert(31);
+      // exercise
+      auto result = us.insert(31);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 31);
+      assertUnit(us.size() == 1);
+   }  // teardown
+
+   // both buckets full: something moves over to make room
+   void test_insert_evicts()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us(64);
+      std::size_t key = findKey(us, 0);
+      std::vector<std::size_t> blockers;
+      for (std::size_t k = 1; blockers.size() < 8; k++)
+      {
+         size_t b1 = us.bucket1(k), b2 = us.bucket2(k);
+         if (b1 != b2 && (b1 == us.bucket1(key) || b1 == us.bucket2(key)) &&
+             b2 != us.bucket1(key) && b2 != us.bucket2(key))
+         {
+            if (us.bucket_size(b1) < 4)
+            {
+               us.insert(k);
+               blockers.push_back(k);
+            }
+         }
+      }
+      assertUnit(us.bucket_size(us.bucket1(key)) == 4);
+      assertUnit(us.bucket_size(us.bucket2(key)) == 4);
+      // exercise
+      auto result = us.insert(key);
+      // verify
+      assertUnit(result.second);
+      assertUnit(us.bucket_count() == 64);
+      assertUnit(us.size() == 9);
+      assertUnit(us.contains(key));
+      bool all = true;
+      for (std::size_t k : blockers)
+         all = all && us.contains(k);
+      assertUnit(all);
+   }  // teardown
+
+   // a thousand keys outgrow eight buckets
+   void test_insert_rehashes()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+         us.insert(i);
+      // verify
+      assertUnit(us.size() == 1000);
+      assertUnit(us.bucket_count() >= 256);
+      bool all = true;
+      for (std::size_t i = 0; i < 1000; i++)
+         all = all && us.contains(i);
+      assertUnit(all);
+      assertUnit(!us.contains(1000));
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // every key is in one of its two buckets
+   void test_find_twoBuckets()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 500; i++)
+         us.insert(i * 7);
+      // exercise
+      bool home = true;
+      for (std::size_t i = 0; i < 500; i++)
+      {
+         auto it = us.find(i * 7);
+         size_t iBucket = it.pBucket - us.buckets.data();
+         home = home && (iBucket == us.bucket1(i * 7) || iBucket == us.bucket2(i * 7));
+      }
+      // verify
+      assertUnit(home);
+      assertUnit(us.find(3) == us.end());
+   }  // teardown
+
+   // the iterator visits every key once
+   void test_iterate_everything()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      std::vector<int> seen(100, 0);
+      // exercise
+      for (auto it = us.begin(); it != us.end(); ++it)
+         seen[*it]++;
+      // verify
+      bool once = true;
+      for (int n : seen)
+         once = once && n == 1;
+      assertUnit(once);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase frees the slot
+   void test_erase_present()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us{ 31, 49, 67 };
+      size_t iBucket = us.find(49).pBucket - us.buckets.data();
+      size_t numBefore = us.bucket_size(iBucket);
+      // exercise
+      us.erase(49);
+      // verify
+      assertUnit(us.size() == 2);
+      assertUnit(!us.contains(49));
+      assertUnit(us.contains(31));
+      assertUnit(us.bucket_size(iBucket) == numBefore - 1);
+   }  // teardown
+
+   // nothing to erase
+   void test_erase_missing()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us{ 31, 49 };
+      // exercise
+      auto it = us.erase(50);
+      // verify
+      assertUnit(it == us.end());
+      assertUnit(us.size() == 2);
+   }  // teardown
+
+   // clear keeps the buckets
+   void test_clear()
+   {  // setup
+      custom::cuckoo_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      size_t numBuckets = us.bucket_count();
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.empty());
+      assertUnit(us.bucket_count() == numBuckets);
+      assertUnit(us.begin() == us.end());
+      assertUnit(!us.contains(5));
+   }  // teardown
+
+   // a key whose two buckets differ, starting the search at first
+   std::size_t findKey(const custom::cuckoo_unordered_set<std::size_t>& us, std::size_t first)
+   {
+      std::size_t k = first;
+      while (us.bucket1(k) == us.bucket2(k))
+         k++;
+      return k;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,272 @@
+/***********************************************************************
+ * Header:
+ *    TEST DENSE HASH
+ * Summary:
+ *    Unit tests for the bitmap set of integers
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "denseHash.h"
+#include "unitTest.h"
+
+#include <vector>
+
+class TestDenseHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_hint();
+      test_constructIterator_popcount();
+      test_constructIterator_sparse();
+
+      // Insert
+      test_insert_setsBit();
+      test_insert_duplicate();
+      test_insert_growsDown();
+      test_insert_negative();
+      test_insert_goesSparse();
+
+      // Access
+      test_iterate_ascending();
+      test_find_outside();
+
+      // Remove
+      test_erase_returnsNext();
+      test_erase_sparse();
+      test_clear_dense();
+
+      report("DenseHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no bitmap until the first key
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::dense_unordered_set<int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.is_dense());
+      assertUnit(s.words.empty());
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // a hint sizes the bitmap up front
+   void test_construct_hint()
+   {  // setup
+      // exercise
+      custom::dense_unordered_set<unsigned> s(0, 1000000);
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.base == 0);
+      assertUnit(s.words.size() == 1000000 / 64 + 1);
+      s.insert(999999);
+      s.insert(3);
+      assertUnit(s.is_dense());
+      assertUnit(s.words.size() == 1000000 / 64 + 1);
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   // duplicates in a range are counted once
+   void test_constructIterator_popcount()
+   {  // setup
+      std::vector<int> values = { 5, 200, 5, 64, 63, 200 };
+      // exercise
+      custom::dense_unordered_set<int> s(values.begin(), values.end());
+      // verify
+      assertUnit(s.is_dense());
+      assertUnit(s.size() == 4);
+      assertUnit(s.words.size() == 4);
+      assertUnit(s.contains(63));
+      assertUnit(s.contains(64));
+   }  // teardown
+
+   // two keys a trillion apart go straight into the hash
+   void test_constructIterator_sparse()
+   {  // setup
+      std::vector<uint64_t> values = { 7, 1000000000000ULL, 7 };
+      // exercise
+      custom::dense_unordered_set<uint64_t> s(values.begin(), values.end());
+      // verify
+      assertUnit(!s.is_dense());
+      assertUnit(s.words.empty());
+      assertUnit(s.size() == 2);
+      assertUnit(s.contains(1000000000000ULL));
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the first key sets one bit in one word
+   void test_insert_setsBit()
+   {  // setup
+      custom::dense_unordered_set<unsigned> s;
+      // exercise
+      auto result = s.insert(70);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 70);
+      assertUnit(s.base == 64);
+      assertUnit(s.words.size() == 1);
+      assertUnit(s.words[0] == (uint64_t)1 << 6);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // a duplicate points at the original
+   void test_insert_duplicate()
+   {  // setup
+      custom::dense_unordered_set<unsigned> s{ 70 };
+      // exercise
+      auto result = s.insert(70);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 70);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // a smaller key moves the base down
+   void test_insert_growsDown()
+   {  // setup
+      custom::dense_unordered_set<unsigned> s{ 1000 };
+      // exercise
+      s.insert(5);
+      // verify
+      assertUnit(s.is_dense());
+      assertUnit(s.base == 0);
+      assertUnit(s.contains(5));
+      assertUnit(s.contains(1000));
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   // negative keys sit below positive ones
+   void test_insert_negative()
+   {  // setup
+      custom::dense_unordered_set<int> s;
+      // exercise
+      s.insert(2);
+      s.insert(-3);
+      s.insert(0);
+      // verify
+      assertUnit(s.is_dense());
+      std::vector<int> seen;
+      for (int k : s)
+         seen.push_back(k);
+      assertUnit(seen == std::vector<int>({ -3, 0, 2 }));
+   }  // teardown
+
+   // a key far off makes the bitmap too thin
+   void test_insert_goesSparse()
+   {  // setup
+      custom::dense_unordered_set<int> s;
+      for (int i = 0; i < 10; i++)
+         s.insert(i);
+      // exercise
+      auto result = s.insert(1 << 30);
+      // verify
+      assertUnit(result.second);
+      assertUnit(*result.first == 1 << 30);
+      assertUnit(!s.is_dense());
+      assertUnit(s.words.empty());
+      assertUnit(s.size() == 11);
+      bool all = true;
+      for (int i = 0; i < 10; i++)
+         all = all && s.contains(i);
+      assertUnit(all);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // across many words, smallest first, each once
+   void test_iterate_ascending()
+   {  // setup
+      custom::dense_unordered_set<int> s;
+      for (int i = 999; i >= 0; i -= 7)
+         s.insert(i);
+      // exercise
+      std::vector<int> seen;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         seen.push_back(*it);
+      // verify
+      bool ascending = true;
+      for (size_t i = 0; i < seen.size(); i++)
+         ascending = ascending && seen[i] == 999 % 7 + 7 * (int)i;
+      assertUnit(ascending);
+      assertUnit(seen.size() == s.size());
+   }  // teardown
+
+   // keys outside the bitmap are not there
+   void test_find_outside()
+   {  // setup
+      custom::dense_unordered_set<int> s{ 100, 101 };
+      // exercise
+      // verify
+      assertUnit(s.find(5) == s.end());
+      assertUnit(s.find(5000) == s.end());
+      assertUnit(s.find(102) == s.end());
+      assertUnit(*s.find(101) == 101);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase clears the bit and points at the next key
+   void test_erase_returnsNext()
+   {  // setup
+      custom::dense_unordered_set<int> s{ 3, 9, 200 };
+      // exercise
+      auto it = s.erase(9);
+      // verify
+      assertUnit(*it == 200);
+      assertUnit(s.size() == 2);
+      assertUnit(!s.contains(9));
+      assertUnit(s.erase(200) == s.end());
+      assertUnit(s.erase(50) == s.end());
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // a sparse set erases from the hash
+   void test_erase_sparse()
+   {  // setup
+      custom::dense_unordered_set<int> s{ 1, 1 << 30 };
+      // exercise
+      s.erase(1);
+      // verify
+      assertUnit(!s.is_dense());
+      assertUnit(s.size() == 1);
+      assertUnit(!s.contains(1));
+      assertUnit(s.contains(1 << 30));
+   }  // teardown
+
+   // an empty set goes back to being a bitmap
+   void test_clear_dense()
+   {  // setup
+      custom::dense_unordered_set<int> s{ 1, 1 << 30 };
+      // exercise
+      s.clear();
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.is_dense());
+      assertUnit(s.begin() == s.end());
+      s.insert(4);
+      assertUnit(s.words.size() == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,244 @@
+/***********************************************************************
+ * Header:
+ *    TEST EPOCH HASH
+ * Summary:
+ *    Unit tests for epoch reclamation and the lock-free read hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "epochHash.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestEpochHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Epoch
+      test_guard_pinsEpoch();
+      test_guard_nests();
+      test_retire_waitsForGuard();
+      test_retire_freedWhenQuiet();
+
+      // Hash
+      test_construct_default();
+      test_insert_standard();
+      test_insert_duplicate();
+      test_erase_present();
+      test_erase_missing();
+      test_clear_standard();
+      test_readersDuringWrites();
+
+      report("EpochHash");
+   }
+
+   /***************************************
+    * EPOCH
+    ***************************************/
+
+   // a guard announces the epoch and takes it back
+   void test_guard_pinsEpoch()
+   {  // setup
+      custom::epoch_domain& d = custom::epoch_domain::global();
+      size_t iSlot;
+      // exercise
+      {
+         custom::epoch_domain::guard guard;
+         iSlot = custom::epoch_domain::registration().iSlot;
+         // verify
+         assertUnit(d.slots[iSlot].state == d.epoch);
+      }
+      assertUnit(d.slots[iSlot].state == 0);
+      assertUnit(d.slots[iSlot].owned);
+   }  // teardown
+
+   // only the outermost guard unpins
+   void test_guard_nests()
+   {  // setup
+      custom::epoch_domain& d = custom::epoch_domain::global();
+      custom::epoch_domain::guard outer;
+      size_t iSlot = custom::epoch_domain::registration().iSlot;
+      // exercise
+      {
+         custom::epoch_domain::guard inner;
+      }
+      // verify
+      assertUnit(d.slots[iSlot].state != 0);
+      assertUnit(custom::epoch_domain::registration().depth == 1);
+   }  // teardown
+
+   // nothing retired under a guard is freed while the guard lives
+   void test_retire_waitsForGuard()
+   {  // setup
+      custom::epoch_domain& d = custom::epoch_domain::global();
+      freedCount() = 0;
+      // exercise
+      {
+         custom::epoch_domain::guard guard;
+         d.retire(nullptr, &countFree);
+         for (int i = 0; i < 5; i++)
+            d.collect();
+         // verify
+         assertUnit(freedCount() == 0);
+      }
+      for (int i = 0; i < 3; i++)
+         d.collect();
+      assertUnit(freedCount() == 1);
+   }  // teardown
+
+   // with no readers one collection moves the epoch on twice and frees it
+   void test_retire_freedWhenQuiet()
+   {  // setup
+      custom::epoch_domain& d = custom::epoch_domain::global();
+      freedCount() = 0;
+      // exercise
+      d.retire(nullptr, &countFree);
+      d.collect();
+      // verify
+      assertUnit(freedCount() == 1);
+   }  // teardown
+
+   /***************************************
+    * HASH
+    ***************************************/
+
+   // empty buckets
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.size() == 0);
+      assertUnit(us.empty());
+      assertUnit(us.bucket_count() == 10);
+      for (size_t i = 0; i < 10; i++)
+         assertUnit(us.buckets[i].pHead == nullptr);
+   }  // teardown
+
+   // new nodes go on the front of their chain
+   void test_insert_standard()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      // exercise
+      us.insert(31);
+      us.insert(67);
+      us.insert(59);
+      us.insert(49);
+      // verify
+      assertUnit(us.size() == 4);
+      assertUnit(us.contains(31));
+      assertUnit(us.contains(49));
+      assertUnit(!us.contains(39));
+      assertUnit(us.buckets[9].pHead.load()->data == 49);
+      assertUnit(us.buckets[9].pHead.load()->pNext.load()->data == 59);
+   }  // teardown
+
+   // a duplicate changes nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      us.insert(59);
+      // exercise
+      bool inserted = us.insert(59);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.size() == 1);
+      assertUnit(us.buckets[9].pHead.load()->pNext == nullptr);
+   }  // teardown
+
+   // link around the erased node
+   void test_erase_present()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      us.insert(39);
+      us.insert(49);
+      us.insert(59);
+      // exercise
+      size_t removed = us.erase(49);
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(us.size() == 2);
+      assertUnit(!us.contains(49));
+      assertUnit(us.buckets[9].pHead.load()->data == 59);
+      assertUnit(us.buckets[9].pHead.load()->pNext.load()->data == 39);
+   }  // teardown
+
+   // nothing to erase
+   void test_erase_missing()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      us.insert(39);
+      // exercise
+      size_t removed = us.erase(49);
+      // verify
+      assertUnit(removed == 0);
+      assertUnit(us.size() == 1);
+   }  // teardown
+
+   // every chain is cut off
+   void test_clear_standard()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 25; i++)
+         us.insert(i);
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.empty());
+      for (size_t i = 0; i < 10; i++)
+         assertUnit(us.buckets[i].pHead == nullptr);
+      assertUnit(!us.contains(3));
+   }  // teardown
+
+   // readers always find the keys nobody erases
+   void test_readersDuringWrites()
+   {  // setup
+      custom::concurrent_unordered_set<std::size_t> us;
+      for (std::size_t i = 0; i < 100; i++)
+         us.insert(i);
+      std::atomic<bool> done(false);
+      std::atomic<int> missing(0);
+      std::vector<std::thread> readers;
+      for (int r = 0; r < 3; r++)
+         readers.push_back(std::thread([&]()
+         {
+            while (!done)
+               for (std::size_t i = 0; i < 100; i++)
+                  if (!us.contains(i))
+                     missing++;
+         }));
+      // exercise
+      for (std::size_t i = 100; i < 2000; i++)
+      {
+         us.insert(i);
+         us.erase(i);
+      }
+      done = true;
+      for (auto& thread : readers)
+         thread.join();
+      // verify
+      assertUnit(missing == 0);
+      assertUnit(us.size() == 100);
+   }  // teardown
+
+   // how many times the epoch domain has called countFree()
+   static int& freedCount()
+   {
+      static int freed = 0;
+      return freed;
+   }
+   static void countFree(void*) { freedCount()++; }
+};
+
+#endif // DEBUG
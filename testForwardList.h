@@ -0,0 +1,349 @@
+/***********************************************************************
+ * Header:
+ *    TEST FORWARD LIST
+ * Summary:
+ *    Unit tests for the singly linked list
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "forwardList.h"
+#include "pair.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+class TestForwardList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit_links();
+      test_constructCopy();
+      test_constructMove();
+
+      // Access
+      test_find();
+      test_findBefore();
+
+      // Insert
+      test_pushFront();
+      test_insertAfter_beforeBegin();
+      test_insertAfter_range();
+      test_spliceAfter_list();
+      test_spliceAfter_one();
+
+      // Remove
+      test_eraseAfter_middle();
+      test_eraseAfter_range();
+      test_eraseAfter_recycles();
+      test_lifetimes();
+
+      // Reorder
+      test_sort_standard();
+      test_sort_stable();
+      test_sort_throws();
+
+      report("ForwardList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing but one null link
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::forward_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.head.pNext == nullptr);
+      assertUnit(l.begin() == l.end());
+      assertUnit(sizeof(l) == sizeof(void*));
+   }  // teardown
+
+   // one link per node, in order
+   void test_constructInit_links()
+   {  // setup
+      // exercise
+      custom::forward_list<int> l{ 11, 26, 31 };
+      // verify
+      //  head    +----+   +----+   +----+
+      //   --->   | 11 | - | 26 | - | 31 |
+      //          +----+   +----+   +----+
+      auto p = l.head.pNext;
+      assertUnit(*l.begin() == 11);
+      assertUnit(p->pNext != nullptr);
+      assertUnit(p->pNext->pNext != nullptr);
+      assertUnit(p->pNext->pNext->pNext == nullptr);
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(sizeof(custom::forward_list<int>::Node) == 2 * sizeof(void*));
+   }  // teardown
+
+   // a copy has its own nodes
+   void test_constructCopy()
+   {  // setup
+      custom::forward_list<int> lSrc{ 11, 26, 31 };
+      // exercise
+      custom::forward_list<int> lDes(lSrc);
+      // verify
+      assertUnit(contents(lDes) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(lDes.head.pNext != lSrc.head.pNext);
+      lDes.front() = 99;
+      assertUnit(lSrc.front() == 11);
+   }  // teardown
+
+   // a move takes the nodes and leaves the source empty
+   void test_constructMove()
+   {  // setup
+      custom::forward_list<int> lSrc{ 11, 26, 31 };
+      auto pFirst = lSrc.head.pNext;
+      // exercise
+      custom::forward_list<int> lDes(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.empty());
+      assertUnit(lDes.head.pNext == pFirst);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find returns the element, or end
+   void test_find()
+   {  // setup
+      custom::forward_list<int> l{ 11, 26, 31 };
+      // exercise
+      auto it = l.find(26);
+      // verify
+      assertUnit(it != l.end());
+      assertUnit(*it == 26);
+      assertUnit(l.find(99) == l.end());
+   }  // teardown
+
+   // find_before returns the place erase_after needs
+   void test_findBefore()
+   {  // setup
+      custom::forward_list<int> l{ 11, 26, 31 };
+      // exercise
+      auto itFirst = l.find_before(11);
+      auto itLast = l.find_before(31);
+      // verify
+      assertUnit(itFirst == l.before_begin());
+      assertUnit(*itLast == 26);
+      assertUnit(l.find_before(99) == l.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // push_front puts each element before the last
+   void test_pushFront()
+   {  // setup
+      custom::forward_list<int> l;
+      // exercise
+      l.push_front(31);
+      l.push_front(26);
+      l.push_front(11);
+      // verify
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.front() == 11);
+   }  // teardown
+
+   // before_begin lets insert_after change the front
+   void test_insertAfter_beforeBegin()
+   {  // setup
+      custom::forward_list<int> l{ 26, 31 };
+      // exercise
+      auto it = l.insert_after(l.before_begin(), 11);
+      // verify
+      assertUnit(it == l.begin());
+      assertUnit(*it == 11);
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+   }  // teardown
+
+   // a range goes in after the iterator, in order
+   void test_insertAfter_range()
+   {  // setup
+      custom::forward_list<int> l{ 11, 31 };
+      std::vector<int> v{ 20, 26 };
+      // exercise
+      auto it = l.insert_after(l.begin(), v.begin(), v.end());
+      // verify
+      assertUnit(*it == 26);
+      assertUnit(contents(l) == std::vector<int>({ 11, 20, 26, 31 }));
+      assertUnit(l.insert_after(it, v.end(), v.end()) == it);
+   }  // teardown
+
+   // a whole list is relinked in, not copied
+   void test_spliceAfter_list()
+   {  // setup
+      custom::forward_list<int> l{ 11, 31 };
+      custom::forward_list<int> rhs{ 20, 26 };
+      auto pFirst = rhs.head.pNext;
+      // exercise
+      l.splice_after(l.begin(), rhs);
+      // verify
+      assertUnit(rhs.empty());
+      assertUnit(l.head.pNext->pNext == pFirst);
+      assertUnit(contents(l) == std::vector<int>({ 11, 20, 26, 31 }));
+   }  // teardown
+
+   // one node moves from one list to the other
+   void test_spliceAfter_one()
+   {  // setup
+      custom::forward_list<int> l{ 11, 31 };
+      custom::forward_list<int> rhs{ 20, 26 };
+      auto pMoved = rhs.head.pNext->pNext;
+      // exercise
+      l.splice_after(l.begin(), rhs, rhs.begin());
+      // verify
+      assertUnit(contents(rhs) == std::vector<int>({ 20 }));
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.head.pNext->pNext == pMoved);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase_after takes out the next element and returns the one after
+   void test_eraseAfter_middle()
+   {  // setup
+      custom::forward_list<int> l{ 11, 26, 31 };
+      // exercise
+      auto it = l.erase_after(l.begin());
+      // verify
+      assertUnit(*it == 31);
+      assertUnit(contents(l) == std::vector<int>({ 11, 31 }));
+      l.pop_front();
+      assertUnit(contents(l) == std::vector<int>({ 31 }));
+      assertUnit(l.erase_after(l.begin()) == l.end());
+   }  // teardown
+
+   // everything strictly between the two goes
+   void test_eraseAfter_range()
+   {  // setup
+      custom::forward_list<int> l{ 11, 20, 26, 31 };
+      auto itLast = l.find(31);
+      // exercise
+      auto it = l.erase_after(l.begin(), itLast);
+      // verify
+      assertUnit(it == itLast);
+      assertUnit(contents(l) == std::vector<int>({ 11, 31 }));
+   }  // teardown
+
+   // an erased node's storage is the next one handed out
+   void test_eraseAfter_recycles()
+   {  // setup
+      custom::forward_list<int> l{ 11, 26, 31 };
+      auto pFirst = l.head.pNext;
+      // exercise
+      l.pop_front();
+      l.push_front(99);
+      // verify
+      assertUnit(l.head.pNext == pFirst);
+      assertUnit(contents(l) == std::vector<int>({ 99, 26, 31 }));
+   }  // teardown
+
+   // every element built is destroyed
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::forward_list<Spy> l;
+         // exercise
+         for (int i = 0; i < 10; i++)
+            l.push_front(Spy(i));
+         l.erase_after(l.begin());
+         l.pop_front();
+         custom::forward_list<Spy> copy(l);
+         copy.sort();
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * REORDER
+    ***************************************/
+
+   // sort puts the standard fixture in order
+   void test_sort_standard()
+   {  // setup
+      custom::forward_list<int> l{ 31, 11, 26, 7, 19 };
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(contents(l) == std::vector<int>({ 7, 11, 19, 26, 31 }));
+      l.sort([](int lhs, int rhs) { return lhs > rhs; });
+      assertUnit(contents(l) == std::vector<int>({ 31, 26, 19, 11, 7 }));
+   }  // teardown
+
+   // equal keys keep their order
+   void test_sort_stable()
+   {  // setup
+      custom::forward_list<custom::pair<int, int>> l;
+      int keys[] = { 1, 2, 1, 2, 1, 2 };
+      for (int i = 0; i < 6; i++)
+         l.push_front(custom::pair<int, int>(keys[i], i));
+      // exercise
+      l.sort();
+      // verify
+      std::vector<int> seconds;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         seconds.push_back((*it).second);
+      assertUnit(seconds == std::vector<int>({ 4, 2, 0, 5, 3, 1 }));
+   }  // teardown
+
+   // a comparator that throws part way leaves every node in the list
+   void test_sort_throws()
+   {  // setup
+      custom::forward_list<int> l{ 5, 4, 3, 2, 1, 0 };
+      int numCompares = 0;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.sort([&numCompares](int lhs, int rhs)
+         {
+            if (++numCompares == 4)
+               throw std::runtime_error("comparator");
+            return lhs < rhs;
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      std::vector<int> values = contents(l);
+      std::sort(values.begin(), values.end());
+      assertUnit(values == std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+   }  // teardown
+
+   template <class L>
+   std::vector<int> contents(const L& l)
+   {
+      std::vector<int> values;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+};
+
+#endif // DEBUG
@@ -15,6 +15,29 @@
 #include "testPair.h"       // for the pair unit tests
 #include "testHash.h"       // for the hash unit tests
 #include "testList.h"       // for the list unit tests
+#include "testParallel.h"   // for the parallel unit tests
+#include "testSharedHash.h" // for the copy-on-write hash unit tests
+#include "testEpochHash.h"  // for the lock-free read hash unit tests
+#include "testShardedHash.h" // for the sharded hash unit tests
+#include "testIntHash.h"    // for the lock-free integer set unit tests
+#include "testCuckooHash.h" // for the cuckoo hash unit tests
+#include "testDenseHash.h"  // for the bitmap set unit tests
+#include "testRoaringSet.h" // for the compressed set unit tests
+#include "testAdaptiveSet.h" // for the array-or-hash set unit tests
+#include "testUnrolledList.h" // for the unrolled list unit tests
+#include "testSkipList.h"   // for the skip list unit tests
+#include "testIntrusiveList.h" // for the intrusive list unit tests
+#include "testIntrusiveHash.h" // for the intrusive hash unit tests
+#include "testMpscList.h"   // for the multi-producer queue unit tests
+#include "testForwardList.h" // for the singly linked list unit tests
+#include "testPersistentList.h" // for the persistent list unit tests
+#include "testPersistentHash.h" // for the persistent hash unit tests
+#include "benchEpochHash.h" // for the reader-scaling benchmark
+#include "benchCuckooHash.h" // for the tail-latency benchmark
+#include "benchMoveToFront.h" // for the self-organizing find benchmark
+#include "benchMpscList.h"  // for the producer-scaling benchmark
+#include "benchForwardList.h" // for the hash bucket chain benchmark
+#include "benchPersistentHash.h" // for the persistent version benchmark
 int Spy::counters[] = {};
 
 /**********************************************************************
@@ -29,7 +52,34 @@ int main()
    TestPair().run();
    TestList().run();
    TestHash().run();
+   TestParallel().run();
+   TestSharedHash().run();
+   TestEpochHash().run();
+   TestShardedHash().run();
+   TestIntHash().run();
+   TestCuckooHash().run();
+   TestDenseHash().run();
+   TestRoaringSet().run();
+   TestAdaptiveSet().run();
+   TestUnrolledList().run();
+   TestSkipList().run();
+   TestIntrusiveList().run();
+   TestIntrusiveHash().run();
+   TestMpscList().run();
+   TestForwardList().run();
+   TestPersistentList().run();
+   TestPersistentHash().run();
 #endif // DEBUG
+
+#ifdef BENCHMARK
+   // benchmarks
+   BenchEpochHash().run();
+   BenchCuckooHash().run();
+   BenchMoveToFront().run();
+   BenchMpscList().run();
+   BenchForwardList().run();
+   BenchPersistentHash().run();
+#endif // BENCHMARK
    
    // driver
    return 0;
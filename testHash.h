@@ -15,9 +15,11 @@
 #include "unitTest.h"
 
 #include <cassert>
+#include <chrono>
 #include <memory>
 #include <unordered_set>
 #include <functional>
+#include <stdexcept>
 #include <vector>
 
 using std::cout;
@@ -36,6 +38,22 @@ namespace std
    };
 }
 
+// a key whose copy throws on one value, once armed
+struct Brittle
+{
+   Brittle(std::size_t value) : value(value) {}
+   Brittle(const Brittle& rhs) : value(rhs.value)
+   {
+      if (armed && value == 30000)
+         throw std::runtime_error("brittle");
+   }
+   bool operator == (const Brittle& rhs) const { return value == rhs.value; }
+   std::size_t operator % (std::size_t n) const { return value % n; }
+   std::size_t value;
+   static bool armed;
+};
+bool Brittle::armed = false;
+
 class TestHash : public UnitTest
 {
 
@@ -47,8 +65,13 @@ public:
       // Construct
       test_construct_default();
       test_constructIterator_standard();
+      test_constructIterator_parallel();
+      test_constructIterator_parallelThrows();
+      test_constructIterator_list();
+      test_constructIterator_otherSet();
       test_constructCopy_empty();
       test_constructCopy_standard();
+      test_constructCopy_contiguous();
 
       // Assign
       test_assign_emptyEmpty();
@@ -89,6 +112,13 @@ public:
       test_find_standardBack();
       test_find_standardMissingEmptyList();
       test_find_standardMissingFilledList();
+      test_find_constStandard();
+      test_find_moveToFront();
+      test_find_policyAssigned();
+      test_find_policySwapped();
+      test_contains_standard();
+      test_count_standard();
+      test_constIterator_walk();
       
       // Insert
       test_insert_empty0();
@@ -100,12 +130,19 @@ public:
       // Remove
       test_clear_empty();
       test_clear_standard();
+      test_clear_standardReuse();
+      test_clear_constantTime();
       test_erase_empty();
       test_erase_standardMissing();
       test_erase_standardAlone();
       test_erase_standardFront();
       test_erase_standardBack();
       test_erase_standardLast();
+      test_eraseRange_standardAll();
+      test_eraseRange_standardMiddle();
+      test_eraseIf_standard();
+      test_eraseIf_none();
+      test_eraseIf_throws();
       
       // Status
       test_size_empty();
@@ -117,6 +154,16 @@ public:
       test_bucketSize_standardOne();
       test_bucketSize_standardTwo();
 
+      // Set algebra
+      test_union_standardOther();
+      test_intersection_standardOther();
+      test_intersection_standardEmpty();
+      test_difference_standardOther();
+      test_subset_true();
+      test_subset_false();
+      test_algebra_large();
+      test_union_throws();
+
       report("Hash");
    }
 
@@ -169,6 +216,90 @@ public:
       assertStandardFixture(us);
    }  // teardown
 
+   // create an unordered set from a range big enough to build in parallel
+   void test_constructIterator_parallel()
+   {  // setup
+      std::vector<std::size_t> v;
+      for (std::size_t i = 0; i < 40000; i++)
+         v.push_back((i * 7919) % 3001);
+      custom::unordered_set<std::size_t> usSerial;
+      for (std::size_t i = 0; i < v.size(); i++)
+         usSerial.insert(v[i]);
+      // exercise
+      custom::unordered_set<std::size_t> us(v.begin(), v.end(), 4);
+      // verify
+      //      h[i] --> every value in v with value % 10 == i,
+      //               in the order of first appearance
+      assertUnit(us.numElements == 3001);
+      for (int i = 0; i < 10; i++)
+      {
+         assertUnit(us.buckets[i].size() == usSerial.buckets[i].size());
+         auto itSerial = usSerial.buckets[i].begin();
+         auto it = us.buckets[i].begin();
+         while (it != us.buckets[i].end() && itSerial != usSerial.buckets[i].end())
+         {
+            assertUnit(*it == *itSerial);
+            ++it;
+            ++itSerial;
+         }
+      }
+   }  // teardown
+
+   // a copy that throws on a worker comes back out of the constructor
+   void test_constructIterator_parallelThrows()
+   {  // setup
+      std::vector<Brittle> v;
+      for (std::size_t i = 0; i < 40000; i++)
+         v.push_back(Brittle(i));
+      bool thrown = false;
+      // exercise
+      Brittle::armed = true;
+      try
+      {
+         custom::unordered_set<Brittle> us(v.begin(), v.end(), 4);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      Brittle::armed = false;
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   // a list's iterators are bidirectional, so its range is inserted
+   // one element at a time
+   void test_constructIterator_list()
+   {  // setup
+      custom::list<std::size_t> l{ 59, 67, 31, 49, 67 };
+      // exercise
+      custom::unordered_set<std::size_t> us(l.begin(), l.end());
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      assertStandardFixture(us);
+   }  // teardown
+
+   // another set's iterators have no iterator_traits at all
+   void test_constructIterator_otherSet()
+   {  // setup
+      custom::unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      // exercise
+      custom::unordered_set<std::size_t> us(usSrc.begin(), usSrc.end());
+      // verify
+      assertStandardFixture(us);
+      assertStandardFixture(usSrc);
+   }  // teardown
+
    // copy an empty unordered set
    void test_constructCopy_empty()
    {  // setup
@@ -235,6 +366,32 @@ public:
       assertStandardFixture(usDes);
    }  // teardown
 
+   // the copy's nodes sit side by side in bucket order
+   void test_constructCopy_contiguous()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      // exercise
+      custom::unordered_set<std::size_t> usDes(usSrc);
+      // verify
+      assertUnit(usDes.buckets[7].pHead == usDes.buckets[1].pHead + 1);
+      assertUnit(usDes.buckets[9].pHead == usDes.buckets[1].pHead + 2);
+      assertUnit(usDes.buckets[9].pTail == usDes.buckets[1].pHead + 3);
+      assertUnit(usDes.buckets[1].pHead != usSrc.buckets[1].pHead);
+      assertUnit(usDes.maxLoadFactor == usSrc.maxLoadFactor);
+      assertStandardFixture(usDes);
+   }  // teardown
+
    /***************************************
     * ASSIGN
     ***************************************/
@@ -1475,6 +1632,185 @@ public:
       assertStandardFixture(us);
    }
    
+   // find 49 through a const reference
+   void test_find_constStandard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const custom::unordered_set<std::size_t>& cus = us;
+      // exercise
+      custom::unordered_set<std::size_t>::const_iterator it = cus.find(49);
+      // verify
+      assertUnit(it.pBucket == us.buckets + 9);
+      assertUnit(it.pBucketEnd == us.buckets + 10);
+      assertUnit(*it == 49);
+      assertUnit(cus.find(50) == cus.end());
+      assertStandardFixture(us);
+   }  // teardown
+
+   // with move-to-front, finding 49 puts it first in its bucket
+   void test_find_moveToFront()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      us.set_find_policy(custom::find_policy::move_to_front);
+      // exercise
+      custom::unordered_set<std::size_t>::iterator it = us.find(49);
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> [49] 59
+      assertUnit(us.get_find_policy() == custom::find_policy::move_to_front);
+      assertUnit(it.pBucket == us.buckets + 9);
+      assertUnit(it.itList == us.buckets[9].begin());
+      assertUnit(*it == 49);
+      assertUnit(us.buckets[9].front() == 49);
+      assertUnit(us.buckets[9].back() == 59);
+      assertUnit(us.size() == 4);
+   }  // teardown
+
+   // assignment brings the find policy along with the elements
+   void test_find_policyAssigned()
+   {  // setup
+      custom::unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      usSrc.set_find_policy(custom::find_policy::transpose);
+      custom::unordered_set<std::size_t> usCopy;
+      custom::unordered_set<std::size_t> usMove;
+      // exercise
+      usCopy = usSrc;
+      usMove = std::move(usSrc);
+      // verify
+      assertUnit(usCopy.get_find_policy() == custom::find_policy::transpose);
+      assertUnit(usMove.get_find_policy() == custom::find_policy::transpose);
+      assertStandardFixture(usCopy);
+      assertStandardFixture(usMove);
+   }  // teardown
+
+   // swapping trades the find policies along with the elements
+   void test_find_policySwapped()
+   {  // setup
+      custom::unordered_set<std::size_t> us1;
+      custom::unordered_set<std::size_t> us2;
+      us1.set_find_policy(custom::find_policy::move_to_front);
+      // exercise
+      us1.swap(us2);
+      // verify
+      assertUnit(us1.get_find_policy() == custom::find_policy::stay);
+      assertUnit(us2.get_find_policy() == custom::find_policy::move_to_front);
+      // exercise
+      swap(us1, us2);
+      // verify
+      assertUnit(us1.get_find_policy() == custom::find_policy::move_to_front);
+      assertUnit(us2.get_find_policy() == custom::find_policy::stay);
+   }  // teardown
+
+   // contains through a const reference
+   void test_contains_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const custom::unordered_set<std::size_t>& cus = us;
+      // exercise and verify
+      assertUnit(cus.contains(31) == true);
+      assertUnit(cus.contains(59) == true);
+      assertUnit(cus.contains(49) == true);
+      assertUnit(cus.contains(39) == false);
+      assertUnit(cus.contains(0) == false);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // count is one or zero
+   void test_count_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const custom::unordered_set<std::size_t>& cus = us;
+      // exercise and verify
+      assertUnit(cus.count(67) == 1);
+      assertUnit(cus.count(77) == 0);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // walk a const hash from begin() to end()
+   void test_constIterator_walk()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const custom::unordered_set<std::size_t>& cus = us;
+      std::vector<std::size_t> v;
+      // exercise
+      for (custom::unordered_set<std::size_t>::const_iterator it = cus.begin(); it != cus.end(); ++it)
+         v.push_back(*it);
+      // verify
+      assertUnit(v.size() == 4);
+      if (v.size() == 4)
+      {
+         assertUnit(v[0] == 31);
+         assertUnit(v[1] == 67);
+         assertUnit(v[2] == 59);
+         assertUnit(v[3] == 49);
+      }
+      assertStandardFixture(us);
+   }  // teardown
+   
    /***************************************
     * INSERT
     ***************************************/
@@ -1791,7 +2127,74 @@ public:
       assertEmptyFixture(us);
       // teardown
    }
+
+   // clearing keeps the node storage for the next insert
+   void test_clear_standardReuse()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::list<std::size_t>::Node* p59 = us.buckets[9].pHead;
+      us.clear();
+      // exercise
+      us.insert(3);
+      // verify
+      //      h[0] -->
+      //      h[1] -->
+      //      h[2] -->
+      //      h[3] --> 3
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] -->
+      assertUnit(us.numElements == 1);
+      assertUnit(us.buckets[3].size() == 1);
+      assertUnit(us.buckets[3].pHead == p59);
+      if (us.buckets[3].size() == 1)
+         assertUnit(us.buckets[3].front() == 3);
+   }  // teardown
    
+   // a thousand times the elements take no longer to clear: every
+   // bucket hands its chain back whole, however long it is
+   void test_clear_constantTime()
+   {  // setup
+      double small = secondsToClear(1 << 10);
+      // exercise
+      double big = secondsToClear(1 << 20);
+      // verify
+      assertUnit(big < 8.0 * small + 0.001);
+   }  // teardown
+
+   // the quickest of a few clears of a hash with num elements
+   double secondsToClear(std::size_t num)
+   {
+      double best = 1.0e9;
+      for (int round = 0; round < 5; round++)
+      {
+         custom::unordered_set<std::size_t> us;
+         for (std::size_t i = 0; i < num; i++)
+            us.buckets[i % 10].push_back(i);
+         us.numElements = (int)num;
+         auto start = std::chrono::steady_clock::now();
+         us.clear();
+         std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+         if (elapsed.count() < best)
+            best = elapsed.count();
+      }
+      return best;
+   }
+
    // erase an empty hash
    void test_erase_empty()
    {  // setup
@@ -2054,6 +2457,176 @@ public:
       assertUnit(it.itList == us.buckets[0].end());
    }
    
+   // erase everything from begin() to end()
+   void test_eraseRange_standardAll()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      custom::unordered_set<std::size_t>::iterator it = us.erase(us.begin(), us.end());
+      // verify
+      assertUnit(it.pBucket == us.buckets + 10);
+      assertEmptyFixture(us);
+   }  // teardown
+
+   // erase from 67 up to 49
+   void test_eraseRange_standardMiddle()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::unordered_set<std::size_t>::iterator itFirst(us.buckets + 7, us.buckets + 10, us.buckets[7].begin());
+      custom::unordered_set<std::size_t>::iterator itLast(us.buckets + 9, us.buckets + 10, us.buckets[9].rbegin());
+      // exercise
+      custom::unordered_set<std::size_t>::iterator it = us.erase(itFirst, itLast);
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] --> 49
+      assertUnit(us.numElements == 2);
+      assertUnit(us.buckets[1].size() == 1);
+      assertUnit(us.buckets[7].size() == 0);
+      assertUnit(us.buckets[9].size() == 1);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 49);
+      assertUnit(it.pBucket == us.buckets + 9);
+      assertUnit(it.itList == us.buckets[9].begin());
+   }  // teardown
+
+   // erase every odd element
+   void test_eraseIf_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      size_t num = custom::erase_if(us, [](std::size_t value) { return value > 50; });
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] --> 49
+      assertUnit(num == 2);
+      assertUnit(us.numElements == 2);
+      assertUnit(us.buckets[1].size() == 1);
+      assertUnit(us.buckets[7].size() == 0);
+      assertUnit(us.buckets[9].size() == 1);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 49);
+   }  // teardown
+
+   // erase nothing
+   void test_eraseIf_none()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      size_t num = custom::erase_if(us, [](std::size_t value) { return value == 99; });
+      // verify
+      assertUnit(num == 0);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a predicate that throws part way keeps what it already removed
+   void test_eraseIf_throws()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::erase_if(us, [](std::size_t value)
+         {
+            if (value == 49)
+               throw std::runtime_error("predicate");
+            return value > 50;
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] --> 49
+      assertUnit(thrown);
+      assertUnit(us.numElements == 2);
+      assertUnit(us.buckets[7].size() == 0);
+      assertUnit(us.buckets[9].size() == 1);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 49);
+   }  // teardown
+
    /***************************************
     * SIZE EMPTY 
     ***************************************/
@@ -2298,6 +2871,256 @@ public:
    }
 
 
+   /***************************************
+    * SET ALGEBRA
+    ***************************************/
+
+   // union of the standard hash and another
+   void test_union_standardOther()
+   {  // setup
+      //      h[0] -->                    h[0] -->
+      //      h[1] --> 31                 h[1] --> 31
+      //      h[2] -->                    h[2] -->
+      //      h[3] -->                    h[3] --> 3
+      //      h[4] -->                    h[4] -->
+      //      h[5] -->              U     h[5] -->
+      //      h[6] -->                    h[6] -->
+      //      h[7] --> 67                 h[7] --> 77
+      //      h[8] -->                    h[8] -->
+      //      h[9] --> 59 49              h[9] --> 49
+      custom::unordered_set<std::size_t> usLHS;
+      setupStandardFixture(usLHS);
+      custom::unordered_set<std::size_t> usRHS;
+      setupOtherFixture(usRHS);
+      // exercise
+      custom::unordered_set<std::size_t> us = custom::set_union(usLHS, usRHS);
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] --> 3
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67 77
+      //      h[8] -->
+      //      h[9] --> 59 49
+      assertUnit(us.numElements == 6);
+      assertUnit(us.buckets[1].size() == 1);
+      assertUnit(us.buckets[3].size() == 1);
+      assertUnit(us.buckets[7].size() == 2);
+      assertUnit(us.buckets[9].size() == 2);
+      if (us.buckets[7].size() == 2)
+      {
+         assertUnit(us.buckets[7].front() == 67);
+         assertUnit(us.buckets[7].back() == 77);
+      }
+      if (us.buckets[9].size() == 2)
+      {
+         assertUnit(us.buckets[9].front() == 59);
+         assertUnit(us.buckets[9].back() == 49);
+      }
+      assertStandardFixture(usLHS);
+   }  // teardown
+
+   // intersection of the standard hash and another
+   void test_intersection_standardOther()
+   {  // setup
+      //      h[0] -->                    h[0] -->
+      //      h[1] --> 31                 h[1] --> 31
+      //      h[2] -->                    h[2] -->
+      //      h[3] -->                    h[3] --> 3
+      //      h[4] -->                    h[4] -->
+      //      h[5] -->              n     h[5] -->
+      //      h[6] -->                    h[6] -->
+      //      h[7] --> 67                 h[7] --> 77
+      //      h[8] -->                    h[8] -->
+      //      h[9] --> 59 49              h[9] --> 49
+      custom::unordered_set<std::size_t> usLHS;
+      setupStandardFixture(usLHS);
+      custom::unordered_set<std::size_t> usRHS;
+      setupOtherFixture(usRHS);
+      // exercise
+      custom::unordered_set<std::size_t> us = custom::set_intersection(usLHS, usRHS);
+      // verify
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] -->
+      //      h[8] -->
+      //      h[9] --> 49
+      assertUnit(us.numElements == 2);
+      assertUnit(us.buckets[1].size() == 1);
+      assertUnit(us.buckets[3].size() == 0);
+      assertUnit(us.buckets[7].size() == 0);
+      assertUnit(us.buckets[9].size() == 1);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 49);
+      assertStandardFixture(usLHS);
+   }  // teardown
+
+   // intersection with an empty hash is empty
+   void test_intersection_standardEmpty()
+   {  // setup
+      custom::unordered_set<std::size_t> usLHS;
+      setupStandardFixture(usLHS);
+      custom::unordered_set<std::size_t> usRHS;
+      // exercise
+      custom::unordered_set<std::size_t> us = custom::set_intersection(usLHS, usRHS);
+      // verify
+      assertEmptyFixture(us);
+      assertStandardFixture(usLHS);
+   }  // teardown
+
+   // difference of the standard hash and another
+   void test_difference_standardOther()
+   {  // setup
+      //      h[0] -->                    h[0] -->
+      //      h[1] --> 31                 h[1] --> 31
+      //      h[2] -->                    h[2] -->
+      //      h[3] -->                    h[3] --> 3
+      //      h[4] -->                    h[4] -->
+      //      h[5] -->              -     h[5] -->
+      //      h[6] -->                    h[6] -->
+      //      h[7] --> 67                 h[7] --> 77
+      //      h[8] -->                    h[8] -->
+      //      h[9] --> 59 49              h[9] --> 49
+      custom::unordered_set<std::size_t> usLHS;
+      setupStandardFixture(usLHS);
+      custom::unordered_set<std::size_t> usRHS;
+      setupOtherFixture(usRHS);
+      // exercise
+      custom::unordered_set<std::size_t> us = custom::set_difference(usLHS, usRHS);
+      // verify
+      //      h[0] -->
+      //      h[1] -->
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59
+      assertUnit(us.numElements == 2);
+      assertUnit(us.buckets[1].size() == 0);
+      assertUnit(us.buckets[7].size() == 1);
+      assertUnit(us.buckets[9].size() == 1);
+      if (us.buckets[9].size() == 1)
+         assertUnit(us.buckets[9].front() == 59);
+      assertStandardFixture(usLHS);
+   }  // teardown
+
+   // {31, 49} is a subset of the standard hash
+   void test_subset_true()
+   {  // setup
+      custom::unordered_set<std::size_t> usLHS;
+      usLHS.buckets[1].push_back(31);
+      usLHS.buckets[9].push_back(49);
+      usLHS.numElements = 2;
+      custom::unordered_set<std::size_t> usRHS;
+      setupStandardFixture(usRHS);
+      // exercise
+      bool subset = custom::is_subset(usLHS, usRHS);
+      // verify
+      assertUnit(subset == true);
+      assertStandardFixture(usRHS);
+   }  // teardown
+
+   // the other hash is not a subset of the standard hash
+   void test_subset_false()
+   {  // setup
+      custom::unordered_set<std::size_t> usLHS;
+      setupOtherFixture(usLHS);
+      custom::unordered_set<std::size_t> usRHS;
+      setupStandardFixture(usRHS);
+      // exercise
+      bool subset = custom::is_subset(usLHS, usRHS);
+      // verify
+      assertUnit(subset == false);
+      assertStandardFixture(usRHS);
+   }  // teardown
+
+   // sets big enough to be zipped on every core, with thousands of
+   // elements to a bucket: [0, 10000) against [5000, 15000)
+   void test_algebra_large()
+   {  // setup
+      custom::unordered_set<std::size_t> usLHS;
+      custom::unordered_set<std::size_t> usRHS;
+      for (std::size_t i = 0; i < 10000; i++)
+      {
+         usLHS.buckets[i % 10].push_back(i);
+         usRHS.buckets[(i + 5000) % 10].push_back(i + 5000);
+      }
+      usLHS.numElements = usRHS.numElements = 10000;
+      // exercise
+      custom::unordered_set<std::size_t> usUnion = custom::set_union(usLHS, usRHS);
+      custom::unordered_set<std::size_t> usBoth = custom::set_intersection(usLHS, usRHS);
+      custom::unordered_set<std::size_t> usLeft = custom::set_difference(usLHS, usRHS);
+      // verify
+      assertUnit(usUnion.size() == 15000);
+      assertUnit(usBoth.size() == 5000);
+      assertUnit(usLeft.size() == 5000);
+      assertUnit(usBoth.contains(5000) && usBoth.contains(9999) && !usBoth.contains(4999));
+      assertUnit(usLeft.contains(0) && usLeft.contains(4999) && !usLeft.contains(5000));
+      assertUnit(custom::is_subset(usBoth, usLHS));
+      assertUnit(custom::is_subset(usBoth, usRHS));
+      assertUnit(!custom::is_subset(usLeft, usRHS));
+   }  // teardown
+
+   // a copy that throws comes back out, not through std::terminate
+   void test_union_throws()
+   {  // setup
+      custom::unordered_set<Brittle> usLHS;
+      custom::unordered_set<Brittle> usRHS;
+      for (std::size_t i = 0; i < 5000; i++)
+      {
+         usLHS.insert(Brittle(i * 10));
+         usRHS.insert(Brittle(i * 10 + 1));
+      }
+      bool thrown = false;
+      // exercise
+      Brittle::armed = true;
+      try
+      {
+         custom::set_union(usLHS, usRHS);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      Brittle::armed = false;
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+
+   /*************************************************************
+    * SETUP OTHER FIXTURE
+    *      h[0] -->
+    *      h[1] --> 31
+    *      h[2] -->
+    *      h[3] --> 3
+    *      h[4] -->
+    *      h[5] -->
+    *      h[6] -->
+    *      h[7] --> 77
+    *      h[8] -->
+    *      h[9] --> 49
+    *************************************************************/
+   void setupOtherFixture(custom::unordered_set<std::size_t>& us)
+   {
+      us.buckets[1].push_back(31);
+      us.buckets[3].push_back(3);
+      us.buckets[7].push_back(77);
+      us.buckets[9].push_back(49);
+      us.numElements = 4;
+   }
+
    /*************************************************************
     * SETUP STANDARD FIXTURE
     *      h[0] -->  
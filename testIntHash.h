@@ -0,0 +1,398 @@
+/***********************************************************************
+ * Header:
+ *    TEST INT HASH
+ * Summary:
+ *    Unit tests for the lock-free open-addressing integer set
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intHash.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TestIntHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_roundsUp();
+
+      // Insert
+      test_insert_home();
+      test_insert_probes();
+      test_insert_duplicate();
+      test_insert_reserved();
+
+      // Remove
+      test_erase_keepsSlot();
+      test_erase_missing();
+      test_erase_probesPastErased();
+
+      // Grow
+      test_grow_doubles();
+      test_grow_dropsErased();
+      test_grow_findsPastMoved();
+      test_grow_stalledHelper();
+      test_grow_freesOldArrays();
+
+      // Threads
+      test_concurrentInserts();
+      test_readersDuringGrowth();
+      test_collidingDuringGrowth();
+
+      report("IntHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // sixteen empty slots
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::concurrent_int_set<uint64_t> s;
+      // verify
+      assertUnit(s.size() == 0);
+      assertUnit(s.empty());
+      assertUnit(s.capacity() == 16);
+      bool allEmpty = true;
+      for (size_t i = 0; i < 16; i++)
+         allEmpty = allEmpty && s.pTable.load()->slots[i] == s.EMPTY;
+      assertUnit(allEmpty);
+   }  // teardown
+
+   // capacity is always a power of two
+   void test_construct_roundsUp()
+   {  // setup
+      // exercise
+      custom::concurrent_int_set<uint64_t> s(100);
+      // verify
+      assertUnit(s.capacity() == 128);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a key goes in its home slot
+   void test_insert_home()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      // exercise
+      bool inserted = s.insert(35);
+      // verify
+      assertUnit(inserted);
+      assertUnit(s.size() == 1);
+      assertUnit(s.contains(35));
+      assertUnit(s.pTable.load()->slots[3] == 35);
+      assertUnit(s.pTable.load()->used == 1);
+   }  // teardown
+
+   // a collision takes the next slot
+   void test_insert_probes()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(3);
+      // exercise
+      s.insert(19);
+      // verify
+      assertUnit(s.pTable.load()->slots[3] == 3);
+      assertUnit(s.pTable.load()->slots[4] == 19);
+      assertUnit(s.contains(19));
+      assertUnit(!s.contains(35));
+   }  // teardown
+
+   // a duplicate changes nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(3);
+      s.insert(19);
+      // exercise
+      bool inserted = s.insert(19);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(s.size() == 2);
+      assertUnit(s.pTable.load()->used == 2);
+   }  // teardown
+
+   // the marker values cannot be stored
+   void test_insert_reserved()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         s.insert(UINT64_MAX);
+      }
+      catch (const std::invalid_argument&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(s.empty());
+      assertUnit(s.insert(s.MAX_KEY));
+      assertUnit(!s.contains(s.MAX_KEY + 1));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase flags the key but leaves it in its slot
+   void test_erase_keepsSlot()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(3);
+      // exercise
+      size_t removed = s.erase(3);
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(s.size() == 0);
+      assertUnit(!s.contains(3));
+      assertUnit(s.pTable.load()->slots[3] == (3 | s.DEAD));
+   }  // teardown
+
+   // nothing to erase
+   void test_erase_missing()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(3);
+      // exercise
+      size_t removed = s.erase(19);
+      // verify
+      assertUnit(removed == 0);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // a key past an erased one is still found, and an erased key
+   // comes back to its own slot
+   void test_erase_probesPastErased()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(3);
+      s.insert(19);
+      // exercise
+      s.erase(3);
+      // verify
+      assertUnit(s.contains(19));
+      assertUnit(s.erase(19) == 1);
+      assertUnit(s.insert(19));
+      assertUnit(s.pTable.load()->slots[4] == 19);
+      assertUnit(s.pTable.load()->used == 2);
+   }  // teardown
+
+   /***************************************
+    * GROW
+    ***************************************/
+
+   // filling past three quarters doubles the array
+   void test_grow_doubles()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      // exercise
+      for (uint64_t i = 0; i < 13; i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.capacity() == 32);
+      assertUnit(s.size() == 13);
+      assertUnit(s.pTable.load()->pNext == nullptr);
+      bool all = true;
+      for (uint64_t i = 0; i < 13; i++)
+         all = all && s.contains(i);
+      assertUnit(all);
+   }  // teardown
+
+   // mostly erased keys: migrate to the same size
+   void test_grow_dropsErased()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      for (uint64_t i = 0; i < 12; i++)
+      {
+         s.insert(i);
+         if (i != 0)
+            s.erase(i);
+      }
+      // exercise
+      s.insert(100);
+      // verify
+      assertUnit(s.capacity() == 16);
+      assertUnit(s.size() == 2);
+      assertUnit(s.pTable.load()->used == 2);
+      assertUnit(s.contains(0));
+      assertUnit(s.contains(100));
+      assertUnit(!s.contains(5));
+   }  // teardown
+
+   // 0, 16 and 32 share a home. With only slot 0 moved, 32 is
+   // still in the old array, past a MOVED slot
+   //   old: [0 MOVED][16][32]     new: [0]
+   void test_grow_findsPastMoved()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(0);
+      s.insert(16);
+      s.insert(32);
+      auto pOld = s.pTable.load();
+      s.grow(pOld);
+      // exercise
+      s.migrate(pOld, 0);
+      // verify
+      assertUnit(pOld->slots[0] == (0 | s.MOVED));
+      assertUnit(pOld->pNext.load()->slots[0] == 0);
+      assertUnit(s.contains(0));
+      assertUnit(s.contains(16));
+      assertUnit(s.contains(32));
+      assertUnit(!s.contains(48));
+   }  // teardown
+
+   // a helper took every chunk and never finished: writers still get
+   // through, to the new array, and readers find both old and new
+   void test_grow_stalledHelper()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      s.insert(0);
+      s.insert(16);
+      auto pOld = s.pTable.load();
+      s.grow(pOld);
+      pOld->claimed = pOld->capacity;
+      // exercise
+      bool inserted = s.insert(32);
+      size_t erased = s.erase(16);
+      // verify
+      assertUnit(inserted);
+      assertUnit(erased == 1);
+      assertUnit(s.pTable.load() == pOld);
+      assertUnit(pOld->slots[0] == 0);
+      assertUnit(pOld->slots[1] == (16 | s.MOVED));
+      assertUnit(s.contains(0));
+      assertUnit(!s.contains(16));
+      assertUnit(s.contains(32));
+      assertUnit(s.size() == 2);
+      assertUnit(!s.insert(0));
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   // with nobody else reading, every array migrated out of is freed
+   // by the writer that saw it go, not left for a later collection
+   void test_grow_freesOldArrays()
+   {  // setup
+      typedef custom::concurrent_int_set<uint64_t> Set;
+      Set s;
+      // exercise
+      for (uint64_t i = 0; i < (1 << 16); i++)
+         s.insert(i);
+      // verify
+      assertUnit(s.capacity() == (1 << 17));
+      assertUnit(s.numRetired == 13);
+      size_t numPending = 0;
+      for (auto& r : custom::epoch_domain::global().retired)
+         numPending += r.deleter == &Set::deleteTable ? 1 : 0;
+      assertUnit(numPending == 0);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // four writers through several migrations lose nothing
+   void test_concurrentInserts()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      std::vector<std::thread> threads;
+      // exercise
+      for (uint64_t t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, t]()
+         {
+            for (uint64_t i = t; i < 4000; i += 4)
+               s.insert(i);
+            for (uint64_t i = t; i < 4000; i += 8)
+               s.erase(i);
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      // verify
+      assertUnit(s.size() == 2000);
+      bool right = true;
+      for (uint64_t i = 0; i < 4000; i++)
+         right = right && s.contains(i) == ((i % 8) >= 4);
+      assertUnit(right);
+   }  // teardown
+
+   // readers keep finding the early keys while the array grows
+   void test_readersDuringGrowth()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      for (uint64_t i = 0; i < 10; i++)
+         s.insert(i);
+      std::atomic<bool> done(false);
+      std::atomic<int> missing(0);
+      std::vector<std::thread> readers;
+      for (int r = 0; r < 3; r++)
+         readers.push_back(std::thread([&]()
+         {
+            while (!done)
+               for (uint64_t i = 0; i < 10; i++)
+                  if (!s.contains(i))
+                     missing++;
+         }));
+      // exercise
+      for (uint64_t i = 10; i < 5000; i++)
+         s.insert(i);
+      done = true;
+      for (auto& thread : readers)
+         thread.join();
+      // verify
+      assertUnit(missing == 0);
+      assertUnit(s.size() == 5000);
+   }  // teardown
+
+   // writers pile keys with one home into the array while it migrates
+   // again and again, and each checks the keys it has already put in
+   void test_collidingDuringGrowth()
+   {  // setup
+      custom::concurrent_int_set<uint64_t> s;
+      std::atomic<int> missing(0);
+      std::vector<std::thread> threads;
+      // exercise
+      for (uint64_t t = 0; t < 4; t++)
+         threads.push_back(std::thread([&s, &missing, t]()
+         {
+            for (uint64_t i = t; i < 800; i += 4)
+            {
+               s.insert(i << 12);
+               for (uint64_t j = t; j <= i; j += 4)
+                  if (!s.contains(j << 12))
+                     missing++;
+            }
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      // verify
+      assertUnit(missing == 0);
+      assertUnit(s.size() == 800);
+      bool all = true;
+      for (uint64_t i = 0; i < 800; i++)
+         all = all && s.contains(i << 12);
+      assertUnit(all);
+   }  // teardown
+};
+
+#endif // DEBUG
@@ -0,0 +1,247 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE HASH
+ * Summary:
+ *    Unit tests for the hash of objects that carry their own links
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusiveHash.h"
+#include "unitTest.h"
+
+#include <vector>
+
+class TestIntrusiveHash : public UnitTest
+{
+public:
+   // an object indexed two ways: by id, and by name
+   struct Account
+   {
+      Account(int id = 0, int name = 0) : id(id), name(name) {}
+
+      int id;
+      int name;
+      custom::list_hook<Account> byId;
+      custom::list_hook<Account> byName;
+   };
+   struct HashId    { size_t operator()(const Account& a) const { return (size_t)a.id; } };
+   struct EqualId   { bool operator()(const Account& lhs, const Account& rhs) const { return lhs.id == rhs.id; } };
+   struct HashName  { size_t operator()(const Account& a) const { return (size_t)a.name * 7; } };
+   struct EqualName { bool operator()(const Account& lhs, const Account& rhs) const { return lhs.name == rhs.name; } };
+   typedef custom::intrusive_unordered_set<Account, &Account::byId, HashId, EqualId> ById;
+   typedef custom::intrusive_unordered_set<Account, &Account::byName, HashName, EqualName> ByName;
+
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_construct_rounds();
+
+      // Insert
+      test_insert_links();
+      test_insert_duplicate();
+      test_insert_rehashes();
+
+      // Access
+      test_find_byKey();
+      test_iterator_visitsAll();
+
+      // Remove
+      test_erase_byValue();
+      test_erase_iterator();
+      test_twoSets();
+
+      report("IntrusiveHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // eight empty buckets
+   void test_construct_default()
+   {  // setup
+      // exercise
+      ById s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.bucket_count() == 8);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // the bucket count is a power of two
+   void test_construct_rounds()
+   {  // setup
+      // exercise
+      ById s(100);
+      // verify
+      assertUnit(s.bucket_count() == 128);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the object goes on its bucket's chain through its own hook
+   void test_insert_links()
+   {  // setup
+      Account a(3);
+      Account b(11);
+      ById s;
+      // exercise
+      auto result = s.insert(a);
+      s.insert(b);
+      // verify
+      //      h[3] --> 11 3
+      assertUnit(result.second);
+      assertUnit(&*result.first == &a);
+      assertUnit(s.size() == 2);
+      assertUnit(s.bucket_size(3) == 2);
+      assertUnit(s.buckets[3].pHead == &b);
+      assertUnit(b.byId.pNext == &a);
+      assertUnit(a.byId.pPrev == &b);
+   }  // teardown
+
+   // an equal key is not linked
+   void test_insert_duplicate()
+   {  // setup
+      Account a(3, 1);
+      Account twin(3, 2);
+      ById s;
+      s.insert(a);
+      // exercise
+      auto result = s.insert(twin);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(&*result.first == &a);
+      assertUnit(s.size() == 1);
+      assertUnit(twin.byId.pNext == nullptr && twin.byId.pPrev == nullptr);
+   }  // teardown
+
+   // past one object per bucket the chains are relinked, the objects stay
+   void test_insert_rehashes()
+   {  // setup
+      std::vector<Account> accounts;
+      for (int i = 0; i < 9; i++)
+         accounts.push_back(Account(i * 8));
+      ById s;
+      for (int i = 0; i < 8; i++)
+         s.insert(accounts[i]);
+      assertUnit(s.bucket_size(0) == 8);
+      // exercise
+      s.insert(accounts[8]);
+      // verify
+      assertUnit(s.bucket_count() == 16);
+      assertUnit(s.bucket_size(0) == 5);
+      assertUnit(s.bucket_size(8) == 4);
+      for (Account& account : accounts)
+         assertUnit(&*s.find(account) == &account);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a probe with the same key finds the object in the set
+   void test_find_byKey()
+   {  // setup
+      Account a(5, 50);
+      ById s;
+      s.insert(a);
+      // exercise
+      auto it = s.find(Account(5));
+      // verify
+      assertUnit(&*it == &a);
+      assertUnit(it->name == 50);
+      assertUnit(s.find(Account(6)) == s.end());
+      assertUnit(s.count(Account(5)) == 1);
+   }  // teardown
+
+   // iteration visits every object once
+   void test_iterator_visitsAll()
+   {  // setup
+      std::vector<Account> accounts;
+      for (int i = 0; i < 20; i++)
+         accounts.push_back(Account(i * 3));
+      ById s;
+      for (Account& account : accounts)
+         s.insert(account);
+      // exercise
+      int sum = 0;
+      size_t num = 0;
+      for (auto it = s.begin(); it != s.end(); ++it, num++)
+         sum += it->id;
+      // verify
+      assertUnit(num == 20);
+      assertUnit(sum == 3 * 190);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase by key unlinks the object in the set
+   void test_erase_byValue()
+   {  // setup
+      Account a(3);
+      Account b(11);
+      ById s;
+      s.insert(a);
+      s.insert(b);
+      // exercise
+      size_t removed = s.erase(Account(11));
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(s.erase(Account(11)) == 0);
+      assertUnit(s.size() == 1);
+      assertUnit(b.byId.pNext == nullptr);
+      assertUnit(s.buckets[3].pHead == &a);
+      assertUnit(a.byId.pPrev == nullptr);
+   }  // teardown
+
+   // erase by iterator returns the next object
+   void test_erase_iterator()
+   {  // setup
+      Account a(1);
+      Account b(2);
+      ById s;
+      s.insert(a);
+      s.insert(b);
+      // exercise
+      auto it = s.erase(s.begin());
+      // verify
+      assertUnit(&*it == &b);
+      assertUnit(s.erase(it) == s.end());
+      assertUnit(s.empty());
+   }  // teardown
+
+   // one object, two sets, two keys
+   void test_twoSets()
+   {  // setup
+      Account a(1, 100);
+      Account b(2, 200);
+      ById byId;
+      ByName byName;
+      // exercise
+      byId.insert(a);
+      byId.insert(b);
+      byName.insert(a);
+      byName.insert(b);
+      byName.erase(a);
+      // verify
+      assertUnit(&*byId.find(Account(1)) == &a);
+      assertUnit(byName.find(Account(0, 100)) == byName.end());
+      assertUnit(&*byName.find(Account(0, 200)) == &b);
+      assertUnit(byId.size() == 2);
+      assertUnit(byName.size() == 1);
+   }  // teardown
+};
+
+#endif // DEBUG
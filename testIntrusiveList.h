@@ -0,0 +1,268 @@
+/***********************************************************************
+ * Header:
+ *    TEST INTRUSIVE LIST
+ * Summary:
+ *    Unit tests for the list of objects that carry their own links
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "intrusiveList.h"
+#include "unitTest.h"
+
+#include <vector>
+
+class TestIntrusiveList : public UnitTest
+{
+public:
+   // an object that can be on two lists at once
+   struct Item
+   {
+      Item(int value = 0) : value(value) {}
+      bool operator == (const Item& rhs) const { return value == rhs.value; }
+
+      int value;
+      custom::list_hook<Item> hookA;
+      custom::list_hook<Item> hookB;
+   };
+   typedef custom::intrusive_list<Item, &Item::hookA> ListA;
+   typedef custom::intrusive_list<Item, &Item::hookB> ListB;
+
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructMove();
+
+      // Insert
+      test_pushBack_links();
+      test_pushFront_links();
+      test_insert_middle();
+
+      // Access
+      test_find();
+      test_iterator_decrement();
+
+      // Remove
+      test_erase_middle();
+      test_remove_byReference();
+      test_clear_unlinks();
+      test_twoLists();
+
+      report("IntrusiveList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing linked
+   void test_construct_default()
+   {  // setup
+      // exercise
+      ListA l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.pTail == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // a move takes the links and leaves the source empty
+   void test_constructMove()
+   {  // setup
+      Item items[2] = { 1, 2 };
+      ListA lSrc;
+      lSrc.push_back(items[0]);
+      lSrc.push_back(items[1]);
+      // exercise
+      ListA lDes(std::move(lSrc));
+      // verify
+      assertUnit(lSrc.empty());
+      assertUnit(lDes.size() == 2);
+      assertUnit(lDes.pHead == &items[0]);
+      assertUnit(lDes.pTail == &items[1]);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the objects themselves are linked, in place
+   void test_pushBack_links()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      // exercise
+      for (Item& item : items)
+         l.push_back(item);
+      // verify
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertUnit(l.size() == 3);
+      assertUnit(l.pHead == &items[0]);
+      assertUnit(l.pTail == &items[2]);
+      assertUnit(items[0].hookA.pPrev == nullptr);
+      assertUnit(items[0].hookA.pNext == &items[1]);
+      assertUnit(items[1].hookA.pPrev == &items[0]);
+      assertUnit(items[1].hookA.pNext == &items[2]);
+      assertUnit(items[2].hookA.pPrev == &items[1]);
+      assertUnit(items[2].hookA.pNext == nullptr);
+      assertUnit(items[0].hookB.pNext == nullptr);
+   }  // teardown
+
+   // push_front puts each object before the last
+   void test_pushFront_links()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      // exercise
+      for (Item& item : items)
+         l.push_front(item);
+      // verify
+      assertUnit(contents(l) == std::vector<int>({ 31, 26, 11 }));
+      assertUnit(&l.front() == &items[2]);
+      assertUnit(&l.back() == &items[0]);
+   }  // teardown
+
+   // insert goes before the iterator
+   void test_insert_middle()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      l.push_back(items[0]);
+      l.push_back(items[2]);
+      // exercise
+      auto it = l.insert(ListA::iterator_to(items[2]), items[1]);
+      // verify
+      assertUnit(&*it == &items[1]);
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(items[2].hookA.pPrev == &items[1]);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find compares the objects
+   void test_find()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      for (Item& item : items)
+         l.push_back(item);
+      // exercise
+      auto it = l.find(Item(26));
+      // verify
+      assertUnit(&*it == &items[1]);
+      assertUnit(it->value == 26);
+      assertUnit(l.find(Item(99)) == l.end());
+   }  // teardown
+
+   // -- walks back, and stays put at the front
+   void test_iterator_decrement()
+   {  // setup
+      Item items[2] = { 11, 26 };
+      ListA l;
+      l.push_back(items[0]);
+      l.push_back(items[1]);
+      auto it = l.rbegin();
+      // exercise
+      --it;
+      // verify
+      assertUnit(&*it == &items[0]);
+      --it;
+      assertUnit(&*it == &items[0]);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase unlinks the object and returns the next
+   void test_erase_middle()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      for (Item& item : items)
+         l.push_back(item);
+      // exercise
+      auto it = l.erase(ListA::iterator_to(items[1]));
+      // verify
+      assertUnit(&*it == &items[2]);
+      assertUnit(contents(l) == std::vector<int>({ 11, 31 }));
+      assertUnit(items[1].hookA.pNext == nullptr);
+      assertUnit(items[1].hookA.pPrev == nullptr);
+      assertUnit(items[2].hookA.pPrev == &items[0]);
+   }  // teardown
+
+   // an object can take itself off in O(1)
+   void test_remove_byReference()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      for (Item& item : items)
+         l.push_back(item);
+      // exercise
+      l.remove(items[2]);
+      l.remove(items[0]);
+      // verify
+      assertUnit(l.size() == 1);
+      assertUnit(l.pHead == &items[1]);
+      assertUnit(l.pTail == &items[1]);
+      assertUnit(items[1].hookA.pNext == nullptr);
+   }  // teardown
+
+   // clear leaves every hook empty, so the objects can go on again
+   void test_clear_unlinks()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA l;
+      for (Item& item : items)
+         l.push_back(item);
+      // exercise
+      l.clear();
+      // verify
+      assertUnit(l.empty());
+      for (Item& item : items)
+         assertUnit(item.hookA.pNext == nullptr && item.hookA.pPrev == nullptr);
+      l.push_back(items[1]);
+      assertUnit(l.size() == 1);
+   }  // teardown
+
+   // two hooks, two lists, two orders
+   void test_twoLists()
+   {  // setup
+      Item items[3] = { 11, 26, 31 };
+      ListA la;
+      ListB lb;
+      // exercise
+      for (Item& item : items)
+      {
+         la.push_back(item);
+         lb.push_front(item);
+      }
+      la.remove(items[1]);
+      // verify
+      assertUnit(contents(la) == std::vector<int>({ 11, 31 }));
+      assertUnit(contents(lb) == std::vector<int>({ 31, 26, 11 }));
+   }  // teardown
+
+   template <class L>
+   std::vector<int> contents(const L& l)
+   {
+      std::vector<int> values;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         values.push_back(it->value);
+      return values;
+   }
+};
+
+#endif // DEBUG
@@ -14,10 +14,17 @@
 #include "list.h"
 #include <list>
 #include "unitTest.h"
+#include "pair.h"
+#include "spy.h"
 
 #include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <iterator>
 #include <cassert>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <iostream>
 
 class TestList : public UnitTest
@@ -53,6 +60,9 @@ public:
       test_assignInit_sameSize();
       test_assignInit_rightBigger();
       test_assignInit_leftBigger();
+      test_assignCount_grow();
+      test_assignCount_shrink();
+      test_assignRange_toEmpty();
 
       // Iterator
       test_iterator_begin_empty();
@@ -61,6 +71,12 @@ public:
       test_iterator_increment_standardMiddle();
       test_iterator_dereference_read();
       test_iterator_dereference_update();
+      test_constIterator_walk();
+      test_find_constFound();
+      test_find_constMissing();
+      test_find_moveToFront();
+      test_find_transpose();
+      test_find_policyMissing();
 
       // Access
       test_front_empty();
@@ -86,10 +102,17 @@ public:
       test_insertMove_empty();
       test_insertMove_standardFront();
       test_insertMove_standardMiddle();
+      test_insertRange_middle();
+      test_insertRange_empty();
+      test_insertRange_input();
+      test_insertRange_throws();
+      test_insertCount_end();
 
       // Remove
       test_clear_empty();
       test_clear_standard();
+      test_clear_standardRecycle();
+      test_pool_crossThread();
       test_popback_empty();
       test_popback_standard();
       test_popfront_empty();
@@ -98,6 +121,22 @@ public:
       test_erase_standardFront();
       test_erase_standardMiddle();
       test_erase_standardEnd();
+      test_eraseRange_standardFront();
+      test_eraseRange_standardAll();
+      test_removeIf_standard();
+      test_removeIf_none();
+      test_removeIf_throws();
+      test_remove_standard();
+      test_unique_standard();
+
+      // Reorder
+      test_sort_standard();
+      test_sort_stable();
+      test_sort_noCopies();
+      test_sort_throws();
+      test_merge_standard();
+      test_merge_throws();
+      test_reverse_standard();
 
       // Status
       test_size_empty();
@@ -105,6 +144,17 @@ public:
       test_empty_empty();
       test_empty_three();
 
+      // Checkpoints
+      test_checkpoint_off();
+      test_checkpoint_lay();
+      test_checkpoint_pushBack();
+      test_checkpoint_eraseMoves();
+      test_checkpoint_eraseDrops();
+      test_checkpoint_driftRelays();
+      test_checkpoint_sortRelays();
+      test_checkpoint_indexFollows();
+      test_checkpoint_copy();
+
       report("List");
    }
 
@@ -427,6 +477,201 @@ public:
    }
 
 
+   /***************************************
+    * CHECKPOINTS
+    ***************************************/
+
+   // without checkpoints the list is one segment
+   void test_checkpoint_off()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      size_t num = l.num_segments();
+      // verify
+      assertUnit(num == 1);
+      assertUnit(l.checkpoint_interval() == 0);
+      assertUnit(l.pCheckpoints == nullptr);
+      assertUnit(l.segment(0) == l.begin());
+      assertUnit(l.segment(1) == l.end());
+      teardownStandardFixture(l);
+   }  // teardown
+
+   // a mark on every third node
+   void test_checkpoint_lay()
+   {  // setup
+      custom::list<int> l;
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      // exercise
+      l.set_checkpoint_interval(3);
+      // verify
+      //  segment  0           1           2           3
+      //         +---+---+---+---+---+---+---+---+---+---+
+      //         | 0 | 1 | 2 | 3 | 4 | 5 | 6 | 7 | 8 | 9 |
+      //         +---+---+---+---+---+---+---+---+---+---+
+      assertUnit(l.num_segments() == 4);
+      assertUnit(*l.segment(1) == 3);
+      assertUnit(*l.segment(2) == 6);
+      assertUnit(*l.segment(3) == 9);
+      assertUnit(l.segment(4) == l.end());
+      assertUnit(l.pCheckpoints->numLast == 1);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 3, 3, 3, 1 }));
+   }  // teardown
+
+   // push_back starts a new segment when the last one is full
+   void test_checkpoint_pushBack()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(2);
+      // exercise
+      for (int i = 0; i < 5; i++)
+         l.push_back(i);
+      // verify
+      assertUnit(l.pCheckpoints->marks.size() == 2);
+      assertUnit(l.pCheckpoints->numDrift == 0);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 2, 2, 1 }));
+      l.insert(l.end(), 3, 7);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 2, 2, 2, 2 }));
+   }  // teardown
+
+   // erasing a mark moves it to the node after
+   void test_checkpoint_eraseMoves()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(3);
+      for (int i = 0; i < 9; i++)
+         l.push_back(i);
+      // exercise
+      l.erase(l.segment(1));
+      // verify
+      assertUnit(l.num_segments() == 3);
+      assertUnit(*l.segment(1) == 4);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 3, 2, 3 }));
+      assertUnit(l.pCheckpoints->find(l.segment(1).p) == 0);
+      assertUnit(l.pCheckpoints->find(l.segment(2).p) == 1);
+   }  // teardown
+
+   // a segment that would be left empty goes, mark and all
+   void test_checkpoint_eraseDrops()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(1);
+      for (int i = 0; i < 4; i++)
+         l.push_back(i);
+      // exercise
+      l.erase(l.segment(2));
+      l.pop_back();
+      // verify
+      assertUnit(l.num_segments() == 2);
+      assertUnit(*l.segment(1) == 1);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 1, 1 }));
+      l.pop_front();
+      l.pop_front();
+      assertUnit(l.empty());
+      assertUnit(l.pCheckpoints->marks.empty());
+      assertUnit(indexed(l) == 0);
+   }  // teardown
+
+   // the insert that drifts more than half the list lays the marks again
+   void test_checkpoint_driftRelays()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(4);
+      for (int i = 0; i < 8; i++)
+         l.push_back(i);
+      for (int i = 0; i < 8; i++)
+         l.push_front(-i);
+      assertUnit(l.pCheckpoints->numDrift == 8);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 12, 4 }));
+      // exercise
+      l.push_front(-8);
+      // verify
+      assertUnit(l.pCheckpoints->numDrift == 0);
+      assertUnit(l.num_segments() == 5);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 4, 4, 4, 4, 1 }));
+   }  // teardown
+
+   // a sort lays the marks again before it returns
+   void test_checkpoint_sortRelays()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(2);
+      for (int i = 0; i < 6; i++)
+         l.push_back(5 - i);
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(*l.segment(1) == 2);
+      assertUnit(*l.segment(2) == 4);
+      assertUnit(l.pCheckpoints->numDrift == 0);
+      assertUnit(segmentSizes(l) == std::vector<size_t>({ 2, 2, 2 }));
+   }  // teardown
+
+   // marks moved and dropped one at a time are each still found
+   // where they are in marks, and nothing else is
+   void test_checkpoint_indexFollows()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(2);
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      // exercise
+      for (auto it = l.begin(); it != l.end(); )
+         it = *it % 3 == 0 ? l.erase(it) : ++it;
+      // verify
+      size_t numMissed = 0;
+      for (size_t i = 0; i < l.pCheckpoints->marks.size(); i++)
+         numMissed += l.pCheckpoints->find(l.pCheckpoints->marks[i]) == i ? 0 : 1;
+      assertUnit(numMissed == 0);
+      assertUnit(indexed(l) == l.pCheckpoints->marks.size());
+      assertUnit(l.pCheckpoints->find(l.end().p) == custom::list<int>::Checkpoints::NONE);
+      assertUnit(l.size() == 66);
+   }  // teardown
+
+   // how many slots of the index are in use
+   size_t indexed(const custom::list<int>& l)
+   {
+      size_t num = 0;
+      for (size_t slot : l.pCheckpoints->index)
+         num += slot == custom::list<int>::Checkpoints::NONE ? 0 : 1;
+      return num;
+   }
+
+   // a copy keeps its own marks, at the same interval
+   void test_checkpoint_copy()
+   {  // setup
+      custom::list<int> lSrc;
+      lSrc.set_checkpoint_interval(2);
+      for (int i = 0; i < 5; i++)
+         lSrc.push_back(i);
+      // exercise
+      custom::list<int> lDes(lSrc);
+      // verify
+      assertUnit(lDes.checkpoint_interval() == 2);
+      assertUnit(lDes.pCheckpoints != lSrc.pCheckpoints);
+      assertUnit(segmentSizes(lDes) == std::vector<size_t>({ 2, 2, 1 }));
+      assertUnit(lDes.segment(1) != lSrc.segment(1));
+      lDes.set_checkpoint_interval(0);
+      assertUnit(lDes.pCheckpoints == nullptr);
+      assertUnit(lDes.num_segments() == 1);
+   }  // teardown
+
+   // how many nodes are in each segment, walking from one to the next
+   std::vector<size_t> segmentSizes(const custom::list<int>& l)
+   {
+      std::vector<size_t> sizes;
+      size_t num = l.num_segments();
+      for (size_t i = 0; i < num; i++)
+      {
+         size_t size = 0;
+         for (auto it = l.segment(i); it != l.segment(i + 1) && it != l.end(); ++it)
+            size++;
+         sizes.push_back(size);
+      }
+      return sizes;
+   }
+
    /***************************************
     * ASSIGN
     ***************************************/
@@ -689,6 +934,51 @@ public:
    }
 
 
+   // assign a count to a shorter list: the old nodes are written over
+   void test_assignCount_grow()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* pHead = l.pHead;
+      // exercise
+      l.assign(5, 7);
+      // verify
+      assertUnit(l.numElements == 5);
+      assertUnit(l.pHead == pHead);
+      assertUnit(l.pHead->data == 7);
+      assertUnit(l.pTail->data == 7);
+      assertUnit(l.pTail->pPrev->pNext == l.pTail);
+      assertUnit(l.pTail->pNext == nullptr);
+   }  // teardown
+
+   // assign a count to a longer list: what is left over is freed
+   void test_assignCount_shrink()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      l.assign(1, 7);
+      // verify
+      assertUnit(l.numElements == 1);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pHead->data == 7);
+      assertUnit(l.pHead->pNext == nullptr);
+      l.assign(0, 7);
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // assign an empty range to the standard fixture
+   void test_assignRange_toEmpty()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      std::vector<int> v;
+      // exercise
+      l.assign(v.begin(), v.end());
+      // verify
+      assertEmptyFixture(l);
+   }  // teardown
+
    /***************************************
     * CLEAR
     ***************************************/
@@ -717,6 +1007,72 @@ public:
       assertEmptyFixture(l);
    }  // teardown
 
+   void test_clear_standardRecycle()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p11 = l.pHead;
+      custom::list<int>::Node* p26 = l.pHead->pNext;
+      l.clear();
+      // exercise
+      l.push_back(99);
+      l.push_back(88);
+      // verify
+      //        pHead    pTail
+      //       +----+   +----+
+      //       | 99 | - | 88 |
+      //       +----+   +----+
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead == p11);
+      assertUnit(l.pTail == p26);
+      if (l.pHead && l.pTail)
+      {
+         assertUnit(l.pHead->data == 99);
+         assertUnit(l.pTail->data == 88);
+      }
+   }  // teardown
+
+   // nodes made on one thread and freed on another find their way
+   // back, so a queue between two threads does not grow the pool
+   void test_pool_crossThread()
+   {  // setup
+      typedef custom::node_pool<custom::list<int>::Node> Pool;
+      const int NUM = 200000;
+      custom::list<int> l;
+      std::mutex lock;
+      size_t numBefore = Pool::numChunks;
+      size_t numPeak = 0;
+      // exercise
+      std::thread producer([&l, &lock, NUM]()
+      {
+         for (int i = 0; i < NUM; )
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            if (l.size() < 1000)
+               l.push_back(i++);
+         }
+      });
+      for (int numPopped = 0; numPopped < NUM; )
+      {
+         std::lock_guard<std::mutex> guard(lock);
+         if (!l.empty())
+         {
+            l.pop_front();
+            numPopped++;
+         }
+         if (Pool::numChunks > numPeak)
+            numPeak = Pool::numChunks;
+      }
+      producer.join();
+      // verify
+      assertUnit(l.empty());
+      assertUnit(numPeak - numBefore < 64);
+   }  // teardown
+
 
    /***************************************
     * PUSH BACK
@@ -1578,6 +1934,113 @@ public:
    }
 
 
+   // a range goes in front of the iterator, its nodes side by side
+   void test_insertRange_middle()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //                  it
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::iterator it;
+      it.p = l.pHead->pNext;
+      std::vector<int> v{ 97, 98, 99 };
+      // exercise
+      auto itReturn = l.insert(it, v.begin(), v.end());
+      // verify
+      //       +----+   +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 97 | - | 98 | - | 99 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+   +----+
+      //               itReturn                     it
+      custom::list<int>::Node* p = itReturn.p;
+      assertUnit(p == l.pHead->pNext);
+      assertUnit(p->pPrev == l.pHead);
+      assertUnit(p->data == 97);
+      assertUnit(p->pNext == p + 1);
+      assertUnit(p[1].data == 98);
+      assertUnit(p[1].pPrev == p);
+      assertUnit(p[1].pNext == p + 2);
+      assertUnit(p[2].data == 99);
+      assertUnit(p[2].pNext == it.p);
+      assertUnit(it.p->pPrev == p + 2);
+      assertUnit(l.numElements == 6);
+      assertUnit(l.pTail->data == 31);
+   }  // teardown
+
+   // nothing to insert returns the iterator and leaves the list alone
+   void test_insertRange_empty()
+   {  // setup
+      custom::list<int> l;
+      setupStandardFixture(l);
+      std::vector<int> v;
+      // exercise
+      auto itReturn = l.insert(l.begin(), v.begin(), v.end());
+      // verify
+      assertUnit(itReturn == l.begin());
+      assertStandardFixture(l);
+      teardownStandardFixture(l);
+   }  // teardown
+
+   // a range that can only be walked once is still inserted, in order
+   void test_insertRange_input()
+   {  // setup
+      custom::list<int> l;
+      std::istringstream in("11 26 31");
+      // exercise
+      auto itReturn = l.insert(l.end(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+      // verify
+      assertUnit(itReturn.p == l.pHead);
+      assertStandardFixture(l);
+      teardownStandardFixture(l);
+   }  // teardown
+
+   // a copy that throws leaves the list as it was, and nothing leaks
+   void test_insertRange_throws()
+   {  // setup
+      custom::list<Fragile> l;
+      l.push_back(Fragile(1));
+      Fragile v[] = { 2, 3, -1, 4 };
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.insert(l.end(), v, v + 4);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.numElements == 1);
+      assertUnit(l.pHead == l.pTail);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertUnit(l.pHead->data.value == 1);
+   }  // teardown
+
+   // num copies at the end, carved from one block
+   void test_insertCount_end()
+   {  // setup
+      custom::list<int> l;
+      l.push_back(11);
+      // exercise
+      auto itReturn = l.insert(l.end(), 3, 7);
+      // verify
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - |  7 | - |  7 | - |  7 |
+      //       +----+   +----+   +----+   +----+
+      //               itReturn
+      assertUnit(itReturn.p == l.pHead->pNext);
+      assertUnit(l.pTail == itReturn.p + 2);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertUnit(l.numElements == 4);
+      int sum = 0;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         sum += *it;
+      assertUnit(sum == 32);
+   }  // teardown
+
    /***************************************
     * ERASE
     ***************************************/
@@ -1733,6 +2196,382 @@ public:
       teardownStandardFixture(l);
    }
 
+   // erase the first two items with one call
+   void test_eraseRange_standardFront()
+   {  // setup
+      custom::list<int>::iterator itFirst;
+      custom::list<int>::iterator itLast;
+      custom::list<int>::iterator itReturn;
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      //       itFirst           itLast
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p3 = l.pTail;
+      itFirst.p = l.pHead;
+      itLast.p = p3;
+      // exercise
+      itReturn = l.erase(itFirst, itLast);
+      // verify
+      //        pHead
+      //        pTail
+      //       +----+
+      //       | 31 |
+      //       +----+
+      assertUnit(itReturn.p == p3);
+      assertUnit(l.pHead == p3);
+      assertUnit(l.pTail == p3);
+      assertUnit(l.numElements == 1);
+      assertUnit(p3->pPrev == nullptr);
+      assertUnit(p3->data == int(31));
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // erase from begin() to end()
+   void test_eraseRange_standardAll()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      custom::list<int>::iterator itReturn = l.erase(l.begin(), l.end());
+      // verify
+      assertUnit(itReturn == l.end());
+      assertEmptyFixture(l);
+   }  // teardown
+
+   // remove the even items
+   void test_removeIf_standard()
+   {  // setup
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p1 = l.pHead;
+      custom::list<int>::Node* p3 = l.pTail;
+      // exercise
+      size_t num = l.remove_if([](int value) { return value % 2 == 0; });
+      // verify
+      //        pHead    pTail
+      //       +----+   +----+
+      //       | 11 | - | 31 |
+      //       +----+   +----+
+      assertUnit(num == 1);
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead == p1);
+      assertUnit(l.pTail == p3);
+      assertUnit(p1->pNext == p3);
+      assertUnit(p3->pPrev == p1);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // nothing matches, nothing changes
+   void test_removeIf_none()
+   {  // setup
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      size_t num = l.remove_if([](int value) { return value > 99; });
+      // verify
+      assertUnit(num == 0);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // a predicate that throws part way keeps what it already removed
+   void test_removeIf_throws()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i = 1; i <= 5; i++)
+         l.push_back(Spy(i));
+      Spy::reset();
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.remove_if([](const Spy& value)
+         {
+            if (value.get() == 5)
+               throw std::runtime_error("predicate");
+            return value.get() % 2 == 0;
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      //       +---+   +---+   +---+
+      //       | 1 | - | 3 | - | 5 |
+      //       +---+   +---+   +---+
+      assertUnit(thrown);
+      assertUnit(Spy::numDestructor() == 2);
+      assertUnit(l.numElements == 3);
+      assertUnit(l.pHead->data.get() == 1);
+      assertUnit(l.pHead->pNext->data.get() == 3);
+      assertUnit(l.pTail->data.get() == 5);
+      assertUnit(l.pTail->pPrev == l.pHead->pNext);
+      assertUnit(l.pHead->pNext->pPrev == l.pHead);
+   }  // teardown
+
+   // remove every 26
+   void test_remove_standard()
+   {  // setup
+      //       +----+   +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 | - | 26 |
+      //       +----+   +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      l.push_back(26);
+      // exercise
+      size_t num = l.remove(26);
+      // verify
+      //       +----+   +----+
+      //       | 11 | - | 31 |
+      //       +----+   +----+
+      assertUnit(num == 2);
+      assertUnit(l.numElements == 2);
+      assertUnit(l.pHead->data == 11);
+      assertUnit(l.pTail->data == 31);
+      assertUnit(l.pTail->pNext == nullptr);
+      assertUnit(l.pTail->pPrev == l.pHead);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // drop the repeats from a sorted list
+   void test_unique_standard()
+   {  // setup
+      //       +----+   +----+   +----+   +----+   +----+
+      //       | 11 | - | 11 | - | 26 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+   +----+   +----+
+      custom::list<int> l{ 11, 11, 26, 26, 31 };
+      // exercise
+      size_t num = l.unique();
+      // verify
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertUnit(num == 2);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   /***************************************
+    * REORDER
+    ***************************************/
+
+   // sort relinks the same three nodes
+   void test_sort_standard()
+   {  // setup
+      //         p3       p1       p2
+      //       +----+   +----+   +----+
+      //       | 31 | - | 11 | - | 26 |
+      //       +----+   +----+   +----+
+      custom::list<int> l{ 31, 11, 26 };
+      custom::list<int>::Node* p3 = l.pHead;
+      custom::list<int>::Node* p1 = p3->pNext;
+      custom::list<int>::Node* p2 = l.pTail;
+      // exercise
+      l.sort();
+      // verify
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertUnit(l.pHead == p1);
+      assertUnit(p1->pNext == p2);
+      assertUnit(p2->pNext == p3);
+      assertUnit(l.pTail == p3);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // equal keys keep their order
+   void test_sort_stable()
+   {  // setup
+      custom::list<custom::pair<int, int>> l;
+      int keys[] = { 2, 1, 2, 1, 2, 1 };
+      for (int i = 0; i < 6; i++)
+         l.push_back(custom::pair<int, int>(keys[i], i));
+      // exercise
+      l.sort();
+      // verify
+      int seconds[] = { 1, 3, 5, 0, 2, 4 };
+      bool stable = true;
+      int i = 0;
+      for (auto it = l.begin(); it != l.end(); ++it, i++)
+         stable = stable && (*it).second == seconds[i];
+      assertUnit(stable);
+      assertUnit(l.pTail->data.second == 4);
+   }  // teardown
+
+   // a thousand items sorted without a copy or an allocation
+   void test_sort_noCopies()
+   {  // setup
+      custom::list<Spy> l;
+      for (int i = 0; i < 1000; i++)
+         l.push_back(Spy((i * 7919) % 1000));
+      Spy::reset();
+      // exercise
+      l.sort();
+      // verify
+      assertUnit(Spy::numAlloc() == 0);
+      assertUnit(Spy::numCopy() == 0);
+      assertUnit(Spy::numCopyMove() == 0);
+      assertUnit(Spy::numAssign() == 0);
+      assertUnit(Spy::numAssignMove() == 0);
+      assertUnit(Spy::numSwap() == 0);
+      bool sorted = true;
+      int i = 0;
+      for (auto it = l.begin(); it != l.end(); ++it, i++)
+         sorted = sorted && (*it).get() == i;
+      assertUnit(sorted);
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.pTail->pPrev->pNext == l.pTail);
+   }  // teardown
+
+   // a comparator that throws part way leaves every node in the list
+   void test_sort_throws()
+   {  // setup
+      custom::list<int> l{ 5, 4, 3, 2, 1, 0 };
+      int numCompares = 0;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.sort([&numCompares](int lhs, int rhs)
+         {
+            if (++numCompares == 4)
+               throw std::runtime_error("comparator");
+            return lhs < rhs;
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.numElements == 6);
+      int sum = 0;
+      size_t num = 0;
+      custom::list<int>::Node* pPrev = nullptr;
+      bool linked = true;
+      for (custom::list<int>::Node* p = l.pHead; p; pPrev = p, p = p->pNext, num++)
+      {
+         linked = linked && p->pPrev == pPrev;
+         sum += p->data;
+      }
+      assertUnit(linked);
+      assertUnit(num == 6);
+      assertUnit(sum == 15);
+      assertUnit(l.pTail == pPrev);
+   }  // teardown
+
+   // merge two sorted lists into one
+   void test_merge_standard()
+   {  // setup
+      custom::list<int> l{ 11, 31 };
+      custom::list<int> lRHS{ 26 };
+      custom::list<int>::Node* p2 = lRHS.pHead;
+      // exercise
+      l.merge(lRHS);
+      // verify
+      //                  p2
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      assertUnit(l.pHead->pNext == p2);
+      assertStandardFixture(l);
+      assertEmptyFixture(lRHS);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // a comparator that throws part way still moves every node over
+   void test_merge_throws()
+   {  // setup
+      custom::list<int> l{ 1, 5 };
+      custom::list<int> lRHS{ 2, 3 };
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.merge(lRHS, [](int lhs, int rhs)
+         {
+            if (lhs == 3 && rhs == 5)
+               throw std::runtime_error("comparator");
+            return lhs < rhs;
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      //       +---+   +---+   +---+   +---+
+      //       | 1 | - | 2 | - | 5 | - | 3 |
+      //       +---+   +---+   +---+   +---+
+      assertUnit(thrown);
+      assertUnit(l.numElements == 4);
+      std::vector<int> values;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         values.push_back(*it);
+      assertUnit(values == std::vector<int>({ 1, 2, 5, 3 }));
+      assertUnit(l.pHead->pPrev == nullptr);
+      assertUnit(l.pTail->data == 3);
+      assertUnit(l.pTail->pPrev->data == 5);
+      assertUnit(l.pTail->pPrev->pPrev->pNext == l.pTail->pPrev);
+      assertEmptyFixture(lRHS);
+   }  // teardown
+
+   // reverse swaps every link
+   void test_reverse_standard()
+   {  // setup
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p1 = l.pHead;
+      custom::list<int>::Node* p2 = p1->pNext;
+      custom::list<int>::Node* p3 = l.pTail;
+      // exercise
+      l.reverse();
+      // verify
+      //         p3       p2       p1
+      //       +----+   +----+   +----+
+      //       | 31 | - | 26 | - | 11 |
+      //       +----+   +----+   +----+
+      assertUnit(l.pHead == p3);
+      assertUnit(l.pTail == p1);
+      assertUnit(p3->pPrev == nullptr);
+      assertUnit(p3->pNext == p2);
+      assertUnit(p2->pPrev == p3);
+      assertUnit(p2->pNext == p1);
+      assertUnit(p1->pPrev == p2);
+      assertUnit(p1->pNext == nullptr);
+      assertUnit(l.numElements == 3);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
 
    /***************************************
     * ITERATOR
@@ -1887,6 +2726,167 @@ public:
       teardownStandardFixture(l);
    }
 
+   // walk a const list from cbegin() to cend()
+   void test_constIterator_walk()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      const custom::list<int>& cl = l;
+      int sum = 0;
+      int num = 0;
+      // exercise
+      for (custom::list<int>::const_iterator it = cl.cbegin(); it != cl.cend(); ++it)
+      {
+         sum += *it;
+         num++;
+      }
+      // verify
+      assertUnit(num == 3);
+      assertUnit(sum == 11 + 26 + 31);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // find 26 in a const list
+   void test_find_constFound()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      const custom::list<int>& cl = l;
+      // exercise
+      custom::list<int>::const_iterator it = cl.find(26);
+      // verify
+      assertUnit(it.p == l.pHead->pNext);
+      assertUnit(*it == 26);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // 99 is not in a const list
+   void test_find_constMissing()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      const custom::list<int>& cl = l;
+      // exercise
+      custom::list<int>::const_iterator it = cl.find(99);
+      // verify
+      assertUnit(it == cl.end());
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // finding 31 relinks it at the head
+   void test_find_moveToFront()
+   {  // setup
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p1 = l.pHead;
+      custom::list<int>::Node* p2 = p1->pNext;
+      custom::list<int>::Node* p3 = l.pTail;
+      // exercise
+      custom::list<int>::iterator it = l.find(31, custom::find_policy::move_to_front);
+      // verify
+      //         p3       p1       p2
+      //       +----+   +----+   +----+
+      //       | 31 | - | 11 | - | 26 |
+      //       +----+   +----+   +----+
+      assertUnit(it.p == p3);
+      assertUnit(l.pHead == p3);
+      assertUnit(l.pTail == p2);
+      assertUnit(p3->pPrev == nullptr);
+      assertUnit(p3->pNext == p1);
+      assertUnit(p1->pPrev == p3);
+      assertUnit(p1->pNext == p2);
+      assertUnit(p2->pPrev == p1);
+      assertUnit(p2->pNext == nullptr);
+      assertUnit(l.numElements == 3);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // finding 31 moves it one place forward
+   void test_find_transpose()
+   {  // setup
+      //         p1       p2       p3
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      custom::list<int>::Node* p1 = l.pHead;
+      custom::list<int>::Node* p2 = p1->pNext;
+      custom::list<int>::Node* p3 = l.pTail;
+      // exercise
+      custom::list<int>::iterator it = l.find(31, custom::find_policy::transpose);
+      // verify
+      //         p1       p3       p2
+      //       +----+   +----+   +----+
+      //       | 11 | - | 31 | - | 26 |
+      //       +----+   +----+   +----+
+      assertUnit(it.p == p3);
+      assertUnit(l.pHead == p1);
+      assertUnit(l.pTail == p2);
+      assertUnit(p1->pNext == p3);
+      assertUnit(p3->pPrev == p1);
+      assertUnit(p3->pNext == p2);
+      assertUnit(p2->pPrev == p3);
+      assertUnit(p2->pNext == nullptr);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // a miss, or a hit already at the head, moves nothing
+   void test_find_policyMissing()
+   {  // setup
+      //        pHead             pTail
+      //       +----+   +----+   +----+
+      //       | 11 | - | 26 | - | 31 |
+      //       +----+   +----+   +----+
+      custom::list<int> l;
+      setupStandardFixture(l);
+      // exercise
+      custom::list<int>::iterator itMiss = l.find(99, custom::find_policy::move_to_front);
+      custom::list<int>::iterator itHead = l.find(11, custom::find_policy::transpose);
+      // verify
+      assertUnit(itMiss == l.end());
+      assertUnit(itHead.p == l.pHead);
+      assertStandardFixture(l);
+      // teardown
+      teardownStandardFixture(l);
+   }
+
+   // copies fine, unless its value is negative
+   struct Fragile
+   {
+      Fragile(int value) : value(value) {}
+      Fragile(const Fragile& rhs) : value(rhs.value)
+      {
+         if (value < 0)
+            throw std::runtime_error("fragile");
+      }
+      int value;
+   };
+
    /****************************************************************
     * Setup Standard Fixture
     *        pHead             pTail
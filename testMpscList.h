@@ -0,0 +1,234 @@
+/***********************************************************************
+ * Header:
+ *    TEST MPSC LIST
+ * Summary:
+ *    Unit tests for the multi-producer single-consumer queue
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "mpscList.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestMpscList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+
+      // Insert and remove
+      test_pop_empty();
+      test_push_links();
+      test_pop_fifo();
+      test_pop_moves();
+
+      // Recycle
+      test_recycle_batches();
+      test_allocate_reuses();
+      test_lifetimes();
+
+      // Threads
+      test_concurrentProducers();
+
+      report("MpscList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // one empty node that is both head and tail
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::mpsc_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.pHead.load() == l.pTail);
+      assertUnit(l.pTail->pNext.load() == nullptr);
+      assertUnit(l.pFree.load() == nullptr);
+   }  // teardown
+
+   /***************************************
+    * INSERT AND REMOVE
+    ***************************************/
+
+   // nothing to pop leaves the target alone
+   void test_pop_empty()
+   {  // setup
+      custom::mpsc_list<int> l;
+      int value = 99;
+      // exercise
+      bool popped = l.try_pop_front(value);
+      // verify
+      assertUnit(!popped);
+      assertUnit(value == 99);
+   }  // teardown
+
+   // each push becomes the head, linked from the one before
+   void test_push_links()
+   {  // setup
+      custom::mpsc_list<int> l;
+      auto pStub = l.pTail;
+      // exercise
+      l.push_back(11);
+      l.push_back(26);
+      // verify
+      auto p11 = pStub->pNext.load();
+      assertUnit(*p11->data() == 11);
+      assertUnit(*p11->pNext.load()->data() == 26);
+      assertUnit(l.pHead.load() == p11->pNext.load());
+      assertUnit(!l.empty());
+   }  // teardown
+
+   // first in, first out
+   void test_pop_fifo()
+   {  // setup
+      custom::mpsc_list<int> l;
+      l.push_back(11);
+      l.push_back(26);
+      l.push_back(31);
+      // exercise
+      std::vector<int> values;
+      int value;
+      while (l.try_pop_front(value))
+         values.push_back(value);
+      // verify
+      assertUnit(values == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.empty());
+      assertUnit(l.pHead.load() == l.pTail);
+   }  // teardown
+
+   // the element is moved out, not copied
+   void test_pop_moves()
+   {  // setup
+      custom::mpsc_list<std::string> l;
+      l.push_back(std::string(100, 'x'));
+      std::string s;
+      // exercise
+      bool popped = l.try_pop_front(s);
+      // verify
+      assertUnit(popped);
+      assertUnit(s.size() == 100);
+   }  // teardown
+
+   /***************************************
+    * RECYCLE
+    ***************************************/
+
+   // popped nodes reach the free stack a batch at a time
+   void test_recycle_batches()
+   {  // setup
+      custom::mpsc_list<int> l;
+      for (int i = 0; i < 40; i++)
+         l.push_back(i);
+      int value;
+      // exercise
+      for (int i = 0; i < 31; i++)
+         l.try_pop_front(value);
+      assertUnit(l.pFree.load() == nullptr);
+      assertUnit(l.numFreeBatch == 31);
+      l.try_pop_front(value);
+      // verify
+      assertUnit(value == 31);
+      assertUnit(l.pFree.load() != nullptr);
+      assertUnit(l.numFreeBatch == 0);
+      size_t num = 0;
+      for (auto p = l.pFree.load(); p; p = p->pNext.load())
+         num++;
+      assertUnit(num == 32);
+   }  // teardown
+
+   // a push takes a spare node before it allocates
+   void test_allocate_reuses()
+   {  // setup
+      custom::mpsc_list<int> l;
+      for (int i = 0; i < 32; i++)
+         l.push_back(i);
+      int value;
+      for (int i = 0; i < 32; i++)
+         l.try_pop_front(value);
+      auto pSpare = l.pFree.load();
+      // exercise
+      l.push_back(99);
+      // verify
+      assertUnit(l.pHead.load() == pSpare);
+      assertUnit(l.try_pop_front(value));
+      assertUnit(value == 99);
+   }  // teardown
+
+   // whatever is left is destroyed with the list
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::mpsc_list<Spy> l;
+         // exercise
+         for (int i = 0; i < 50; i++)
+            l.push_back(Spy(i));
+         Spy spy;
+         for (int i = 0; i < 40; i++)
+            l.try_pop_front(spy);
+      }
+      // verify
+      assertUnit(Spy::numDefault() == 1);
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // four producers and a consumer: nothing lost, each in order
+   void test_concurrentProducers()
+   {  // setup
+      custom::mpsc_list<int> l;
+      const int NUM = 20000;
+      std::vector<std::thread> producers;
+      std::vector<int> last(4, -1);
+      bool inOrder = true;
+      int numPopped = 0;
+      // exercise
+      for (int t = 0; t < 4; t++)
+         producers.push_back(std::thread([&l, t, NUM]()
+         {
+            for (int i = 0; i < NUM; i++)
+               l.push_back(t * NUM + i);
+         }));
+      while (numPopped < 4 * NUM)
+      {
+         int value;
+         if (!l.try_pop_front(value))
+         {
+            std::this_thread::yield();
+            continue;
+         }
+         int t = value / NUM;
+         inOrder = inOrder && value % NUM == last[t] + 1;
+         last[t] = value % NUM;
+         numPopped++;
+      }
+      for (auto& thread : producers)
+         thread.join();
+      // verify
+      assertUnit(inOrder);
+      assertUnit(l.empty());
+      assertUnit(last == std::vector<int>(4, NUM - 1));
+   }  // teardown
+};
+
+#endif // DEBUG
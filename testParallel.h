@@ -0,0 +1,405 @@
+/***********************************************************************
+ * Header:
+ *    TEST PARALLEL
+ * Summary:
+ *    Unit tests for the parallel bucket algorithms
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "parallel.h"
+#include "hash.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+
+class TestParallel : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Bucket range
+      test_bucketRange_construct();
+      test_bucketRange_splitEven();
+      test_bucketRange_splitOdd();
+      test_bucketRange_grain();
+
+      // Parallel for
+      test_parallelFor_empty();
+      test_parallelFor_everyBucketOnce();
+      test_parallelReduce_count();
+      test_parallelFor_throws();
+
+      // Hash
+      test_parallelForEach_empty();
+      test_parallelForEach_standard();
+      test_parallelForEach_throws();
+      test_parallelReduce_empty();
+      test_parallelReduce_standard();
+      test_parallelReduce_foldCombine();
+      test_parallelReduce_initOnce();
+
+      // List
+      test_listRange_split();
+      test_parallelForEach_listOff();
+      test_parallelForEach_listCheckpoints();
+
+      report("Parallel");
+   }
+
+   /***************************************
+    * BUCKET RANGE
+    ***************************************/
+
+   // range over ten buckets
+   void test_bucketRange_construct()
+   {  // setup
+      custom::list<int> buckets[10];
+      // exercise
+      custom::bucket_range<custom::list<int>> r(buckets, buckets + 10);
+      // verify
+      assertUnit(r.pBucket == buckets);
+      assertUnit(r.pBucketEnd == buckets + 10);
+      assertUnit(r.grain == 1);
+      assertUnit(r.size() == 10);
+      assertUnit(r.empty() == false);
+      assertUnit(r.is_divisible() == true);
+   }  // teardown
+
+   // split ten buckets into five and five
+   void test_bucketRange_splitEven()
+   {  // setup
+      custom::list<int> buckets[10];
+      custom::bucket_range<custom::list<int>> r(buckets, buckets + 10);
+      // exercise
+      custom::bucket_range<custom::list<int>> rhs = r.split();
+      // verify
+      assertUnit(r.pBucket == buckets);
+      assertUnit(r.pBucketEnd == buckets + 5);
+      assertUnit(rhs.pBucket == buckets + 5);
+      assertUnit(rhs.pBucketEnd == buckets + 10);
+   }  // teardown
+
+   // split three buckets into one and two
+   void test_bucketRange_splitOdd()
+   {  // setup
+      custom::list<int> buckets[3];
+      custom::bucket_range<custom::list<int>> r(buckets, buckets + 3);
+      // exercise
+      custom::bucket_range<custom::list<int>> rhs = r.split();
+      // verify
+      assertUnit(r.size() == 1);
+      assertUnit(rhs.size() == 2);
+      assertUnit(r.end() == rhs.begin());
+      assertUnit(r.is_divisible() == false);
+      assertUnit(rhs.is_divisible() == true);
+   }  // teardown
+
+   // never split below the grain
+   void test_bucketRange_grain()
+   {  // setup
+      custom::list<int> buckets[4];
+      // exercise
+      custom::bucket_range<custom::list<int>> r(buckets, buckets + 4, 4);
+      // verify
+      assertUnit(r.grain == 4);
+      assertUnit(r.is_divisible() == false);
+   }  // teardown
+
+   /***************************************
+    * PARALLEL FOR
+    ***************************************/
+
+   // an empty range never calls the body
+   void test_parallelFor_empty()
+   {  // setup
+      custom::list<int> buckets[1];
+      custom::bucket_range<custom::list<int>> r(buckets, buckets);
+      std::atomic<int> calls(0);
+      // exercise
+      custom::parallel_for(r, [&](const custom::bucket_range<custom::list<int>>&) { calls++; }, 4);
+      // verify
+      assertUnit(calls == 0);
+   }  // teardown
+
+   // four workers visit every one of 100 buckets exactly once
+   void test_parallelFor_everyBucketOnce()
+   {  // setup
+      custom::list<int> buckets[100];
+      std::atomic<int> visits[100];
+      for (int i = 0; i < 100; i++)
+         visits[i] = 0;
+      // exercise
+      custom::parallel_for(custom::bucket_range<custom::list<int>>(buckets, buckets + 100),
+         [&](const custom::bucket_range<custom::list<int>>& r)
+         {
+            for (custom::list<int>* p = r.begin(); p != r.end(); ++p)
+               visits[p - buckets]++;
+         }, 4);
+      // verify
+      bool once = true;
+      for (int i = 0; i < 100; i++)
+         once = once && visits[i] == 1;
+      assertUnit(once);
+   }  // teardown
+
+   // four workers count the buckets
+   void test_parallelReduce_count()
+   {  // setup
+      custom::list<int> buckets[100];
+      // exercise
+      size_t count = custom::parallel_reduce(
+         custom::bucket_range<custom::list<int>>(buckets, buckets + 100), size_t(0),
+         [](size_t value, const custom::bucket_range<custom::list<int>>& r) { return value + r.size(); },
+         [](size_t lhs, size_t rhs) { return lhs + rhs; }, 4);
+      // verify
+      assertUnit(count == 100);
+   }  // teardown
+
+   // a body that throws on one bucket of 100: the workers are all
+   // joined and the exception comes back to the caller
+   void test_parallelFor_throws()
+   {  // setup
+      custom::list<int> buckets[100];
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::parallel_for(custom::bucket_range<custom::list<int>>(buckets, buckets + 100),
+            [&](const custom::bucket_range<custom::list<int>>& r)
+            {
+               for (custom::list<int>* p = r.begin(); p != r.end(); ++p)
+                  if (p - buckets == 42)
+                     throw std::runtime_error("bucket 42");
+            }, 4);
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+   }  // teardown
+
+   /***************************************
+    * HASH
+    ***************************************/
+
+   // visit nothing in an empty hash
+   void test_parallelForEach_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      std::atomic<int> calls(0);
+      // exercise
+      custom::parallel_for_each(us, [&](std::size_t&) { calls++; });
+      // verify
+      assertUnit(calls == 0);
+      assertUnit(us.size() == 0);
+   }  // teardown
+
+   // visit every element of the standard hash
+   void test_parallelForEach_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::atomic<std::size_t> sum(0);
+      std::atomic<int> calls(0);
+      // exercise
+      custom::parallel_for_each(us, [&](std::size_t& value) { sum += value; calls++; });
+      // verify
+      assertUnit(calls == 4);
+      assertUnit(sum == 31 + 67 + 59 + 49);
+      assertUnit(us.size() == 4);
+   }  // teardown
+
+   // fn throws on one element, and the exception reaches the caller
+   void test_parallelForEach_throws()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::parallel_for_each(us, [](std::size_t& value)
+         {
+            if (value == 67)
+               throw std::runtime_error("67");
+         });
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(us.size() == 4);
+   }  // teardown
+
+   // reduce an empty hash to its init
+   void test_parallelReduce_empty()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      // exercise
+      std::size_t sum = custom::parallel_reduce(us, std::size_t(0),
+         [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; });
+      // verify
+      assertUnit(sum == 0);
+   }  // teardown
+
+   // sum the standard hash
+   void test_parallelReduce_standard()
+   {  // setup
+      //      h[0] -->
+      //      h[1] --> 31
+      //      h[2] -->
+      //      h[3] -->
+      //      h[4] -->
+      //      h[5] -->
+      //      h[6] -->
+      //      h[7] --> 67
+      //      h[8] -->
+      //      h[9] --> 59 49
+      custom::unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      std::size_t sum = custom::parallel_reduce(us, std::size_t(0),
+         [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; });
+      // verify
+      assertUnit(sum == 31 + 67 + 59 + 49);
+      assertUnit(us.size() == 4);
+   }  // teardown
+
+   // the fold squares each element; the combine only adds the squares
+   void test_parallelReduce_foldCombine()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.insert(1);
+      us.insert(2);
+      us.insert(3);
+      // exercise
+      std::size_t sum = custom::parallel_reduce(us, std::size_t(0),
+         [](std::size_t value, std::size_t t) { return value + t * t; },
+         [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; }, 4);
+      // verify
+      assertUnit(sum == 1 + 4 + 9);
+   }  // teardown
+
+   // init is taken in once, not once per worker
+   void test_parallelReduce_initOnce()
+   {  // setup
+      custom::unordered_set<std::size_t> us;
+      us.insert(1);
+      us.insert(2);
+      us.insert(3);
+      // exercise
+      std::size_t sum = custom::parallel_reduce(us, std::size_t(100),
+         [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; });
+      std::size_t product = custom::parallel_reduce(us, std::size_t(10),
+         [](std::size_t lhs, std::size_t rhs) { return lhs * rhs; });
+      // verify
+      assertUnit(sum == 106);
+      assertUnit(product == 60);
+   }  // teardown
+
+   /***************************************
+    * LIST
+    ***************************************/
+
+   // split five segments into two and three
+   void test_listRange_split()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(2);
+      for (int i = 0; i < 10; i++)
+         l.push_back(i);
+      custom::list_range<custom::list<int>> r(&l, 0, l.num_segments());
+      // exercise
+      custom::list_range<custom::list<int>> rhs = r.split();
+      // verify
+      assertUnit(r.size() == 2);
+      assertUnit(rhs.size() == 3);
+      assertUnit(*r.begin() == 0);
+      assertUnit(r.end() == rhs.begin());
+      assertUnit(*rhs.begin() == 4);
+      assertUnit(rhs.end() == l.end());
+   }  // teardown
+
+   // a list with no checkpoints is visited in one piece
+   void test_parallelForEach_listOff()
+   {  // setup
+      custom::list<int> l;
+      for (int i = 0; i < 100; i++)
+         l.push_back(i);
+      std::atomic<int> sum(0);
+      // exercise
+      custom::parallel_for_each(l, [&](int& value) { sum += value; }, 4);
+      // verify
+      assertUnit(sum == 4950);
+   }  // teardown
+
+   // four workers visit every element of a list with checkpoints once
+   void test_parallelForEach_listCheckpoints()
+   {  // setup
+      custom::list<int> l;
+      l.set_checkpoint_interval(16);
+      for (int i = 0; i < 1000; i++)
+         l.push_back(i);
+      std::atomic<int> visits[1000];
+      for (int i = 0; i < 1000; i++)
+         visits[i] = 0;
+      const custom::list<int>& cl = l;
+      std::atomic<long> sum(0);
+      // exercise
+      custom::parallel_for_each(l, [&](int& value) { visits[value]++; }, 4);
+      custom::parallel_for_each(cl, [&](const int& value) { sum += value; }, 4);
+      // verify
+      bool once = true;
+      for (int i = 0; i < 1000; i++)
+         once = once && visits[i] == 1;
+      assertUnit(once);
+      assertUnit(sum == 499500);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      h[0] -->
+    *      h[1] --> 31
+    *      h[2] -->
+    *      h[3] -->
+    *      h[4] -->
+    *      h[5] -->
+    *      h[6] -->
+    *      h[7] --> 67
+    *      h[8] -->
+    *      h[9] --> 59 49
+    *************************************************************/
+   void setupStandardFixture(custom::unordered_set<std::size_t>& us)
+   {
+      us.buckets[1].push_back(31);
+      us.buckets[7].push_back(67);
+      us.buckets[9].push_back(59);
+      us.buckets[9].push_back(49);
+      us.numElements = 4;
+   }
+};
+
+#endif // DEBUG
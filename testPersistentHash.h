@@ -0,0 +1,391 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT HASH
+ * Summary:
+ *    Unit tests for the immutable hash array mapped trie set
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistentHash.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+class TestPersistentHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit();
+
+      // Insert
+      test_insert_oldUnchanged();
+      test_insert_sharesUntouched();
+      test_insert_duplicate();
+      test_insert_splits();
+
+      // Erase
+      test_erase_oldUnchanged();
+      test_erase_folds();
+      test_erase_missing();
+
+      // Collisions
+      test_collision();
+
+      // Iterate
+      test_iterate_all();
+      test_find_continues();
+
+      // Versions
+      test_versions_random();
+      test_lifetimes();
+      test_concurrentReaders();
+
+      report("PersistentHash");
+   }
+
+   // the hash is the number, so a test knows where each goes
+   struct Identity
+   {
+      size_t operator()(int i) const { return (size_t)i; }
+   };
+
+   // three hashes for everything, so most elements collide
+   struct Clumped
+   {
+      size_t operator()(const Spy& s) const { return (size_t)(s.get() % 3); }
+      size_t operator()(int i) const        { return (size_t)(i % 3); }
+   };
+
+   typedef custom::persistent_unordered_set<int, Identity> Set;
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no root at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      Set s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.size() == 0);
+      assertUnit(s.pRoot == nullptr);
+      assertUnit(s.begin() == s.end());
+      assertUnit(!s.contains(0));
+   }  // teardown
+
+   // each element once, duplicates dropped
+   void test_constructInit()
+   {  // setup
+      // exercise
+      custom::persistent_unordered_set<int> s{ 31, 11, 26, 11, 7 };
+      // verify
+      assertUnit(s.size() == 4);
+      assertUnit(s.contains(31) && s.contains(11) && s.contains(26) && s.contains(7));
+      assertUnit(s.count(99) == 0);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // the version inserted into is just as it was
+   void test_insert_oldUnchanged()
+   {  // setup
+      Set sOld{ 11, 26 };
+      // exercise
+      Set sNew = sOld.insert(31);
+      // verify
+      assertUnit(sNew.size() == 3);
+      assertUnit(sNew.contains(31));
+      assertUnit(sOld.size() == 2);
+      assertUnit(!sOld.contains(31));
+      assertUnit(contents(sOld) == std::vector<int>({ 11, 26 }));
+   }  // teardown
+
+   // only the path to the new element is new: 37 lands on 5's slot
+   // in the root, and every other child of the root is shared
+   void test_insert_sharesUntouched()
+   {  // setup
+      std::vector<int> v;
+      for (int i = 0; i < 32; i++)
+         v.push_back(i);
+      Set sOld(v.begin(), v.end());
+      // exercise
+      Set sNew = sOld.insert(37);
+      // verify
+      auto pOld = static_cast<const Set::Branch*>(sOld.pRoot);
+      auto pNew = static_cast<const Set::Branch*>(sNew.pRoot);
+      assertUnit(pOld->size() == 32);
+      assertUnit(pNew->size() == 32);
+      size_t numShared = 0;
+      for (size_t i = 0; i < 32; i++)
+         numShared += pOld->children()[i] == pNew->children()[i] ? 1 : 0;
+      assertUnit(numShared == 31);
+      assertUnit(pNew->children()[5]->kind == Set::BRANCH);
+      assertUnit(pOld->children()[5]->kind == Set::LEAF);
+      assertUnit(pOld->children()[5]->refs == 2);
+   }  // teardown
+
+   // inserting what is there is the same version
+   void test_insert_duplicate()
+   {  // setup
+      Set sOld{ 11, 26, 31 };
+      // exercise
+      Set sNew = sOld.insert(26);
+      // verify
+      assertUnit(sNew.pRoot == sOld.pRoot);
+      assertUnit(sNew.size() == 3);
+   }  // teardown
+
+   // 0 and 32 agree in their first five bits, so they part one level down
+   //   root --> [bit 0] --> [bit 0 | bit 1] --> 0, 32
+   void test_insert_splits()
+   {  // setup
+      Set s{ 0 };
+      assertUnit(s.pRoot->kind == Set::LEAF);
+      // exercise
+      s = s.insert(32);
+      // verify
+      auto pRoot = static_cast<const Set::Branch*>(s.pRoot);
+      assertUnit(pRoot->kind == Set::BRANCH);
+      assertUnit(pRoot->bitmap == 1);
+      auto pChild = static_cast<const Set::Branch*>(pRoot->children()[0]);
+      assertUnit(pChild->kind == Set::BRANCH);
+      assertUnit(pChild->bitmap == 3);
+      assertUnit(static_cast<const Set::Leaf*>(pChild->children()[0])->data == 0);
+      assertUnit(static_cast<const Set::Leaf*>(pChild->children()[1])->data == 32);
+   }  // teardown
+
+   /***************************************
+    * ERASE
+    ***************************************/
+
+   // the version erased from is just as it was
+   void test_erase_oldUnchanged()
+   {  // setup
+      Set sOld{ 11, 26, 31 };
+      // exercise
+      Set sNew = sOld.erase(26);
+      // verify
+      assertUnit(contents(sNew) == std::vector<int>({ 11, 31 }));
+      assertUnit(contents(sOld) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(sNew.size() == 2);
+   }  // teardown
+
+   // a branch left with one leaf becomes that leaf, all the way up
+   void test_erase_folds()
+   {  // setup
+      Set s{ 0, 32 };
+      // exercise
+      s = s.erase(32);
+      // verify
+      assertUnit(s.pRoot->kind == Set::LEAF);
+      assertUnit(contents(s) == std::vector<int>({ 0 }));
+      s = s.erase(0);
+      assertUnit(s.pRoot == nullptr);
+      assertUnit(s.empty());
+   }  // teardown
+
+   // erasing what is not there is the same version
+   void test_erase_missing()
+   {  // setup
+      Set sOld{ 11, 26, 31 };
+      // exercise
+      Set sNew = sOld.erase(43);
+      // verify
+      assertUnit(sNew.pRoot == sOld.pRoot);
+      assertUnit(sNew.size() == 3);
+   }  // teardown
+
+   /***************************************
+    * COLLISIONS
+    ***************************************/
+
+   // equal hashes share one node, which is a leaf again with one left
+   void test_collision()
+   {  // setup
+      typedef custom::persistent_unordered_set<int, Clumped> Clump;
+      Clump s{ 0, 3 };
+      // exercise
+      Clump sMore = s.insert(6);
+      // verify
+      assertUnit(s.pRoot->kind == Clump::COLLISION);
+      assertUnit(sMore.pRoot->kind == Clump::COLLISION);
+      assertUnit(sMore.size() == 3);
+      assertUnit(sMore.contains(0) && sMore.contains(3) && sMore.contains(6));
+      assertUnit(!s.contains(6));
+      assertUnit(sMore.insert(3).pRoot == sMore.pRoot);
+      Clump sLess = s.erase(3);
+      assertUnit(sLess.pRoot->kind == Clump::LEAF);
+      assertUnit(sLess.contains(0) && !sLess.contains(3));
+      Clump sMixed = sMore.insert(1);
+      assertUnit(sMixed.pRoot->kind == Clump::BRANCH);
+      assertUnit(sMixed.erase(0).erase(3).erase(6).pRoot->kind == Clump::LEAF);
+   }  // teardown
+
+   /***************************************
+    * ITERATE
+    ***************************************/
+
+   // every element once, collisions and all
+   void test_iterate_all()
+   {  // setup
+      custom::persistent_unordered_set<int> s;
+      custom::persistent_unordered_set<int, Clumped> sClumped;
+      std::vector<int> expected;
+      for (int i = 0; i < 1000; i++)
+      {
+         s = s.insert(i * 7);
+         sClumped = sClumped.insert(i);
+         expected.push_back(i * 7);
+      }
+      // exercise
+      std::vector<int> values = contents(s);
+      std::vector<int> clumped = contents(sClumped);
+      // verify
+      assertUnit(values == expected);
+      assertUnit(clumped.size() == 1000);
+      assertUnit(clumped.front() == 0 && clumped.back() == 999);
+   }  // teardown
+
+   // find gives an iterator that goes on to the rest. By their low
+   // bits, 1 and 33 share the root's slot 1, 2 is in slot 2, 40 in 8
+   void test_find_continues()
+   {  // setup
+      Set s{ 1, 2, 33, 40 };
+      // exercise
+      auto it = s.find(33);
+      // verify
+      assertUnit(*it == 33);
+      std::vector<int> rest;
+      for (; it != s.end(); ++it)
+         rest.push_back(*it);
+      assertUnit(rest == std::vector<int>({ 33, 2, 40 }));
+      assertUnit(s.find(34) == s.end());
+   }  // teardown
+
+   /***************************************
+    * VERSIONS
+    ***************************************/
+
+   // every version ever made still holds just what it did
+   void test_versions_random()
+   {  // setup
+      std::mt19937 random(7);
+      custom::persistent_unordered_set<int> s;
+      std::set<int> model;
+      std::vector<custom::persistent_unordered_set<int>> versions;
+      std::vector<std::set<int>> models;
+      // exercise
+      for (int i = 0; i < 2000; i++)
+      {
+         int value = (int)(random() % 500);
+         if (random() % 3 == 0)
+         {
+            s = s.erase(value);
+            model.erase(value);
+         }
+         else
+         {
+            s = s.insert(value);
+            model.insert(value);
+         }
+         versions.push_back(s);
+         models.push_back(model);
+      }
+      // verify
+      bool same = true;
+      for (size_t i = 0; i < versions.size(); i++)
+      {
+         std::vector<int> values = contents(versions[i]);
+         same = same && versions[i].size() == models[i].size()
+                     && values == std::vector<int>(models[i].begin(), models[i].end());
+      }
+      assertUnit(same);
+   }  // teardown
+
+   // every element built is destroyed, however the versions share
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::persistent_unordered_set<Spy, Clumped> s;
+         std::vector<custom::persistent_unordered_set<Spy, Clumped>> versions;
+         // exercise
+         for (int i = 0; i < 40; i++)
+         {
+            s = s.insert(Spy(i));
+            versions.push_back(s);
+         }
+         for (int i = 0; i < 40; i += 3)
+            versions.push_back(s = s.erase(Spy(i)));
+         versions.erase(versions.begin() + 5, versions.begin() + 30);
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   // readers walk their own versions while a writer makes new ones
+   void test_concurrentReaders()
+   {  // setup
+      custom::persistent_unordered_set<int> s;
+      for (int i = 0; i < 1000; i++)
+         s = s.insert(i);
+      custom::persistent_unordered_set<int> sShared(s);
+      std::atomic<bool> consistent(true);
+      std::vector<std::thread> readers;
+      // exercise
+      for (int t = 0; t < 4; t++)
+         readers.push_back(std::thread([&consistent, sShared]()
+         {
+            for (int pass = 0; pass < 20; pass++)
+            {
+               size_t num = 0;
+               long long sum = 0;
+               for (auto it = sShared.begin(); it != sShared.end(); ++it, num++)
+                  sum += *it;
+               if (num != 1000 || sum != 999 * 1000 / 2 || !sShared.contains(pass))
+                  consistent = false;
+            }
+         }));
+      for (int i = 0; i < 1000; i++)
+         s = s.erase(i).insert(i + 1000);
+      for (auto& thread : readers)
+         thread.join();
+      // verify
+      assertUnit(consistent);
+      assertUnit(s.size() == 1000);
+      assertUnit(s.contains(1999) && !s.contains(0));
+   }  // teardown
+
+   // the elements in ascending order, whatever order the trie has them
+   template <class S>
+   std::vector<int> contents(const S& s)
+   {
+      std::vector<int> values;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         values.push_back(*it);
+      std::sort(values.begin(), values.end());
+      return values;
+   }
+};
+
+#endif // DEBUG
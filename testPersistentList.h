@@ -0,0 +1,349 @@
+/***********************************************************************
+ * Header:
+ *    TEST PERSISTENT LIST
+ * Summary:
+ *    Unit tests for the immutable list with shared tails
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "persistentList.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <stdexcept>
+#include <vector>
+
+// an element whose copy throws on a negative value, once armed. It
+// counts how many are alive, so a test sees whether any node leaked
+struct Breakable
+{
+   Breakable(int value) : value(value) { numLive++; }
+   Breakable(const Breakable& rhs) : value(rhs.value)
+   {
+      if (armed && value < 0)
+         throw std::runtime_error("breakable");
+      numLive++;
+   }
+   ~Breakable() { numLive--; }
+   bool operator == (const Breakable& rhs) const { return value == rhs.value; }
+   int value;
+   static bool armed;
+   static int numLive;
+};
+bool Breakable::armed = false;
+int Breakable::numLive = 0;
+
+class TestPersistentList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructInit();
+      test_constructCopy_shares();
+      test_constructRange_throws();
+
+      // Access
+      test_find();
+
+      // New versions
+      test_pushFront_sharesTail();
+      test_pushFront_branches();
+      test_popFront_sharesTail();
+      test_popFront_empty();
+      test_remove_middle();
+      test_remove_missing();
+      test_remove_throws();
+      test_pushFront_throws();
+
+      // Lifetimes
+      test_refs();
+      test_lifetimes();
+      test_release_long();
+
+      report("PersistentList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // nothing at all
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::persistent_list<int> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.size() == 0);
+      assertUnit(l.pHead == nullptr);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // the elements in order, each node held once
+   void test_constructInit()
+   {  // setup
+      // exercise
+      custom::persistent_list<int> l{ 11, 26, 31 };
+      // verify
+      assertUnit(l.size() == 3);
+      assertUnit(l.front() == 11);
+      assertUnit(contents(l) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(l.pHead->refs == 1);
+      assertUnit(l.pHead->pNext->refs == 1);
+   }  // teardown
+
+   // a copy is the same nodes, not new ones
+   void test_constructCopy_shares()
+   {  // setup
+      custom::persistent_list<int> lSrc{ 11, 26, 31 };
+      // exercise
+      custom::persistent_list<int> lDes(lSrc);
+      // verify
+      assertUnit(lDes.pHead == lSrc.pHead);
+      assertUnit(lDes.size() == 3);
+      assertUnit(lSrc.pHead->refs == 2);
+   }  // teardown
+
+   // a copy that throws frees the nodes already made
+   void test_constructRange_throws()
+   {  // setup
+      std::vector<Breakable> v{ 2, 3, -1, 4 };
+      Breakable::armed = true;
+      int numLive = Breakable::numLive;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         custom::persistent_list<Breakable> l(v.begin(), v.end());
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Breakable::numLive == numLive);
+      Breakable::armed = false;
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find returns the element, or end
+   void test_find()
+   {  // setup
+      custom::persistent_list<int> l{ 11, 26, 31 };
+      // exercise
+      auto it = l.find(26);
+      // verify
+      assertUnit(*it == 26);
+      assertUnit(l.contains(31));
+      assertUnit(!l.contains(99));
+      assertUnit(l.find(99) == l.end());
+   }  // teardown
+
+   /***************************************
+    * NEW VERSIONS
+    ***************************************/
+
+   // the new head links to the old one, which does not change
+   void test_pushFront_sharesTail()
+   {  // setup
+      custom::persistent_list<int> lOld{ 26, 31 };
+      // exercise
+      auto lNew = lOld.push_front(11);
+      // verify
+      assertUnit(contents(lNew) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(contents(lOld) == std::vector<int>({ 26, 31 }));
+      assertUnit(lNew.pHead->pNext == lOld.pHead);
+      assertUnit(lNew.size() == 3);
+      assertUnit(lOld.size() == 2);
+   }  // teardown
+
+   // two versions from one: each has its own head, both the same tail
+   //          +----+
+   //   lA --> | 11 | -+   +----+   +----+
+   //          +----+  +-> | 26 | - | 31 |
+   //   lB --> | 20 | -+   +----+   +----+
+   //          +----+
+   void test_pushFront_branches()
+   {  // setup
+      custom::persistent_list<int> lBase{ 26, 31 };
+      // exercise
+      auto lA = lBase.push_front(11);
+      auto lB = lBase.push_front(20);
+      // verify
+      assertUnit(contents(lA) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(contents(lB) == std::vector<int>({ 20, 26, 31 }));
+      assertUnit(lA.pHead->pNext == lB.pHead->pNext);
+      assertUnit(lBase.pHead->refs == 3);
+   }  // teardown
+
+   // pop_front is the tail itself
+   void test_popFront_sharesTail()
+   {  // setup
+      custom::persistent_list<int> lOld{ 11, 26, 31 };
+      // exercise
+      auto lNew = lOld.pop_front();
+      // verify
+      assertUnit(lNew.pHead == lOld.pHead->pNext);
+      assertUnit(contents(lNew) == std::vector<int>({ 26, 31 }));
+      assertUnit(contents(lOld) == std::vector<int>({ 11, 26, 31 }));
+   }  // teardown
+
+   // nothing to pop is still an empty version
+   void test_popFront_empty()
+   {  // setup
+      custom::persistent_list<int> l;
+      // exercise
+      auto lNew = l.pop_front();
+      // verify
+      assertUnit(lNew.empty());
+      assertUnit(lNew.pHead == nullptr);
+   }  // teardown
+
+   // the nodes before the element are copied, the ones after shared
+   void test_remove_middle()
+   {  // setup
+      custom::persistent_list<int> lOld{ 11, 20, 26, 31 };
+      // exercise
+      auto lNew = lOld.remove(20);
+      // verify
+      assertUnit(contents(lNew) == std::vector<int>({ 11, 26, 31 }));
+      assertUnit(contents(lOld) == std::vector<int>({ 11, 20, 26, 31 }));
+      assertUnit(lNew.size() == 3);
+      assertUnit(lNew.pHead != lOld.pHead);
+      assertUnit(lNew.pHead->pNext == lOld.pHead->pNext->pNext);
+   }  // teardown
+
+   // removing what is not there is the same version
+   void test_remove_missing()
+   {  // setup
+      custom::persistent_list<int> lOld{ 11, 26, 31 };
+      // exercise
+      auto lNew = lOld.remove(99);
+      // verify
+      assertUnit(lNew.pHead == lOld.pHead);
+      assertUnit(lNew.size() == 3);
+   }  // teardown
+
+   // a copy that throws frees the copies already made, and the
+   // version removed from is just as it was
+   void test_remove_throws()
+   {  // setup
+      custom::persistent_list<Breakable> l{ 1, -2, 3, 4 };
+      Breakable::armed = true;
+      int numLive = Breakable::numLive;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.remove(Breakable(3));
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(Breakable::numLive == numLive);
+      assertUnit(l.size() == 4);
+      assertUnit(l.pHead->refs == 1);
+      assertUnit(l.pHead->pNext->pNext->refs == 1);
+      Breakable::armed = false;
+   }  // teardown
+
+   // a copy that throws leaves the old head with no new reference
+   void test_pushFront_throws()
+   {  // setup
+      custom::persistent_list<Breakable> l{ 1, 2 };
+      Breakable::armed = true;
+      bool thrown = false;
+      // exercise
+      try
+      {
+         l.push_front(Breakable(-1));
+      }
+      catch (const std::runtime_error&)
+      {
+         thrown = true;
+      }
+      // verify
+      assertUnit(thrown);
+      assertUnit(l.pHead->refs == 1);
+      Breakable::armed = false;
+   }  // teardown
+
+   /***************************************
+    * LIFETIMES
+    ***************************************/
+
+   // a tail outlives the version that made it, and goes with the last
+   void test_refs()
+   {  // setup
+      custom::persistent_list<int> lTail;
+      {
+         custom::persistent_list<int> l{ 11, 26, 31 };
+         // exercise
+         lTail = l.pop_front();
+         assertUnit(lTail.pHead->refs == 2);
+      }
+      // verify
+      assertUnit(lTail.pHead->refs == 1);
+      assertUnit(contents(lTail) == std::vector<int>({ 26, 31 }));
+   }  // teardown
+
+   // every element built is destroyed, however the versions share
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::persistent_list<Spy> l;
+         std::vector<custom::persistent_list<Spy>> versions;
+         // exercise
+         for (int i = 0; i < 10; i++)
+         {
+            l = l.push_front(Spy(i));
+            versions.push_back(l);
+         }
+         versions.push_back(l.remove(Spy(5)));
+         versions.push_back(l.pop_front().pop_front());
+         versions.erase(versions.begin() + 3, versions.begin() + 7);
+      }
+      // verify
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   // a long list is let go of without a deep recursion
+   void test_release_long()
+   {  // setup
+      custom::persistent_list<int> l;
+      for (int i = 0; i < 1000000; i++)
+         l = l.push_front(i);
+      // exercise
+      l = custom::persistent_list<int>();
+      // verify
+      assertUnit(l.empty());
+   }  // teardown
+
+   template <class L>
+   std::vector<int> contents(const L& l)
+   {
+      std::vector<int> values;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,331 @@
+/***********************************************************************
+ * Header:
+ *    TEST ROARING SET
+ * Summary:
+ *    Unit tests for the compressed integer set
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "roaringSet.h"
+#include "hash.h"
+#include "unitTest.h"
+
+#include <cstdint>
+#include <vector>
+
+class TestRoaringSet : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructIterator_containers();
+      test_constructIterator_fromHash();
+      test_constructIterator_toHash();
+
+      // Insert
+      test_insert_array();
+      test_insert_becomesBitmap();
+      test_insert_negative();
+
+      // Remove
+      test_erase_backToArray();
+      test_erase_dropsContainer();
+
+      // Compress
+      test_optimize_runs();
+      test_optimize_thenInsert();
+
+      // Set algebra
+      test_union_mixed();
+      test_intersection_mixed();
+      test_intersection_gallops();
+      test_difference();
+
+      report("RoaringSet");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no containers
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::roaring_set<uint32_t> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.container_count() == 0);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // one container per distinct high 16 bits, duplicates dropped
+   void test_constructIterator_containers()
+   {  // setup
+      std::vector<uint32_t> values = { 70000, 3, 65536, 3, 1 };
+      // exercise
+      custom::roaring_set<uint32_t> s(values.begin(), values.end());
+      // verify
+      assertUnit(s.size() == 4);
+      assertUnit(s.container_count() == 2);
+      assertUnit(s.highs[0] == 0);
+      assertUnit(s.highs[1] == 1);
+      assertUnit(s.containers[0].values == std::vector<uint16_t>({ 1, 3 }));
+      assertUnit(s.containers[1].values == std::vector<uint16_t>({ 0, 70000 - 65536 }));
+   }  // teardown
+
+   // built from a hash
+   void test_constructIterator_fromHash()
+   {  // setup
+      custom::unordered_set<int> us;
+      for (int i = 0; i < 100; i++)
+         us.insert(i * 1000);
+      // exercise
+      custom::roaring_set<int> s(us.begin(), us.end());
+      // verify
+      assertUnit(s.size() == 100);
+      assertUnit(s.contains(99000));
+      assertUnit(!s.contains(500));
+   }  // teardown
+
+   // and a hash built from it
+   void test_constructIterator_toHash()
+   {  // setup
+      custom::roaring_set<int> s{ 5, 70000, -2 };
+      // exercise
+      custom::unordered_set<int> us(s.begin(), s.end());
+      // verify
+      assertUnit(us.size() == 3);
+      assertUnit(us.find(70000) != us.end());
+      assertUnit(us.find(-2) != us.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a few keys sit in a sorted array
+   void test_insert_array()
+   {  // setup
+      custom::roaring_set<uint32_t> s;
+      // exercise
+      bool first = s.insert(9);
+      s.insert(4);
+      bool again = s.insert(9);
+      // verify
+      assertUnit(first);
+      assertUnit(!again);
+      assertUnit(s.size() == 2);
+      assertUnit(s.containers[0].kind == s.ARRAY);
+      assertUnit(s.containers[0].values == std::vector<uint16_t>({ 4, 9 }));
+   }  // teardown
+
+   // past 4096 keys the array turns into a bitmap
+   void test_insert_becomesBitmap()
+   {  // setup
+      custom::roaring_set<uint32_t> s;
+      for (uint32_t i = 0; i < 4096; i++)
+         s.insert(i * 2);
+      assertUnit(s.containers[0].kind == s.ARRAY);
+      // exercise
+      s.insert(1);
+      // verify
+      assertUnit(s.containers[0].kind == s.BITMAP);
+      assertUnit(s.containers[0].cardinality == 4097);
+      assertUnit(s.size() == 4097);
+      assertUnit(s.contains(1));
+      assertUnit(s.contains(8190));
+      assertUnit(!s.contains(3));
+      assertUnit(s.bytes() < 4097 * 3);
+   }  // teardown
+
+   // negative keys come first
+   void test_insert_negative()
+   {  // setup
+      custom::roaring_set<int> s;
+      // exercise
+      s.insert(7);
+      s.insert(-5);
+      s.insert(0);
+      // verify
+      std::vector<int> seen;
+      for (int k : s)
+         seen.push_back(k);
+      assertUnit(seen == std::vector<int>({ -5, 0, 7 }));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // a bitmap down to 4096 keys is an array again
+   void test_erase_backToArray()
+   {  // setup
+      custom::roaring_set<uint32_t> s;
+      for (uint32_t i = 0; i < 4097; i++)
+         s.insert(i);
+      assertUnit(s.containers[0].kind == s.BITMAP);
+      // exercise
+      size_t removed = s.erase(100);
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(s.containers[0].kind == s.ARRAY);
+      assertUnit(s.containers[0].values.size() == 4096);
+      assertUnit(!s.contains(100));
+      assertUnit(s.contains(101));
+      assertUnit(s.erase(100) == 0);
+   }  // teardown
+
+   // the last key takes its container with it
+   void test_erase_dropsContainer()
+   {  // setup
+      custom::roaring_set<uint32_t> s{ 1, 70000 };
+      // exercise
+      s.erase(70000);
+      // verify
+      assertUnit(s.size() == 1);
+      assertUnit(s.container_count() == 1);
+      assertUnit(s.highs[0] == 0);
+   }  // teardown
+
+   /***************************************
+    * COMPRESS
+    ***************************************/
+
+   // ten thousand keys in a row are one run
+   void test_optimize_runs()
+   {  // setup
+      custom::roaring_set<uint32_t> s;
+      for (uint32_t i = 100; i < 10100; i++)
+         s.insert(i);
+      s.insert(20000);
+      // exercise
+      size_t numRun = s.optimize();
+      // verify
+      assertUnit(numRun == 1);
+      assertUnit(s.containers[0].kind == s.RUN);
+      assertUnit(s.containers[0].runs.size() == 2);
+      assertUnit(s.bytes() < 100);
+      assertUnit(s.contains(100));
+      assertUnit(s.contains(10099));
+      assertUnit(!s.contains(10100));
+      assertUnit(!s.contains(99));
+      assertUnit(s.contains(20000));
+      size_t num = 0;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         num++;
+      assertUnit(num == 10001);
+   }  // teardown
+
+   // a run container expands to take another key
+   void test_optimize_thenInsert()
+   {  // setup
+      custom::roaring_set<uint32_t> s;
+      for (uint32_t i = 0; i < 5000; i++)
+         s.insert(i);
+      s.optimize();
+      // exercise
+      s.insert(6000);
+      s.erase(0);
+      // verify
+      assertUnit(s.containers[0].kind == s.BITMAP);
+      assertUnit(s.size() == 5000);
+      assertUnit(s.contains(6000));
+      assertUnit(!s.contains(0));
+   }  // teardown
+
+   /***************************************
+    * SET ALGEBRA
+    ***************************************/
+
+   // array, bitmap and run containers unite
+   void test_union_mixed()
+   {  // setup
+      custom::roaring_set<uint32_t> lhs;
+      custom::roaring_set<uint32_t> rhs;
+      for (uint32_t i = 0; i < 5000; i++)
+         lhs.insert(i * 2);                 // a bitmap
+      for (uint32_t i = 0; i < 300; i++)
+         rhs.insert(i);                     // a run once optimized
+      rhs.insert(200000);                   // a container lhs lacks
+      rhs.optimize();
+      // exercise
+      auto out = set_union(lhs, rhs);
+      // verify
+      assertUnit(out.size() == 5000 + 150 + 1);
+      assertUnit(out.container_count() == 2);
+      assertUnit(out.contains(299));
+      assertUnit(out.contains(9998));
+      assertUnit(!out.contains(301));
+      assertUnit(out.contains(200000));
+   }  // teardown
+
+   // a bitmap against a bitmap and against an array
+   void test_intersection_mixed()
+   {  // setup
+      custom::roaring_set<uint32_t> evens;
+      custom::roaring_set<uint32_t> threes;
+      for (uint32_t i = 0; i < 20000; i += 2)
+         evens.insert(i);
+      for (uint32_t i = 0; i < 30000; i += 3)
+         threes.insert(i);
+      custom::roaring_set<uint32_t> few{ 4, 5, 6, 70000 };
+      // exercise
+      auto sixes = set_intersection(evens, threes);
+      auto some = set_intersection(few, evens);
+      // verify
+      assertUnit(sixes.size() == 3334);
+      assertUnit(sixes.containers[0].kind == sixes.ARRAY);
+      assertUnit(sixes.contains(19998));
+      assertUnit(!sixes.contains(4));
+      assertUnit(some.size() == 2);
+      assertUnit(some.contains(4));
+      assertUnit(some.contains(6));
+   }  // teardown
+
+   // a tiny array against a big one
+   void test_intersection_gallops()
+   {  // setup
+      custom::roaring_set<uint32_t> big;
+      for (uint32_t i = 0; i < 4000; i++)
+         big.insert(i * 16);
+      custom::roaring_set<uint32_t> small{ 16, 17, 63984 };
+      // exercise
+      auto out = set_intersection(small, big);
+      // verify
+      assertUnit(out.size() == 2);
+      assertUnit(out.contains(16));
+      assertUnit(out.contains(63984));
+   }  // teardown
+
+   // what one has and the other does not
+   void test_difference()
+   {  // setup
+      custom::roaring_set<uint32_t> lhs;
+      for (uint32_t i = 0; i < 10000; i++)
+         lhs.insert(i);
+      lhs.insert(100000);
+      custom::roaring_set<uint32_t> rhs;
+      for (uint32_t i = 0; i < 9990; i++)
+         rhs.insert(i);
+      // exercise
+      auto out = set_difference(lhs, rhs);
+      // verify
+      assertUnit(out.size() == 11);
+      assertUnit(out.containers[0].kind == out.ARRAY);
+      assertUnit(out.contains(9990));
+      assertUnit(!out.contains(9989));
+      assertUnit(out.contains(100000));
+   }  // teardown
+};
+
+#endif // DEBUG
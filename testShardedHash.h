@@ -0,0 +1,279 @@
+/***********************************************************************
+ * Header:
+ *    TEST SHARDED HASH
+ * Summary:
+ *    Unit tests for the per-thread sharded hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "shardedHash.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class TestShardedHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_numShards();
+
+      // Insert
+      test_insert_sameThreadSameShard();
+      test_insert_threadsOwnShards();
+      test_insert_reusesExited();
+      test_insert_tooManyThreads();
+      test_insert_forgetsDestroyed();
+
+      // Access
+      test_contains_anyShard();
+
+      // Combine
+      test_merge_relinks();
+      test_merge_dedups();
+      test_snapshot_foldsIntoFirst();
+      test_snapshot_thenInsert();
+
+      report("ShardedHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // ask for four shards
+   void test_construct_numShards()
+   {  // setup
+      // exercise
+      custom::sharded_unordered_set<std::size_t> ss(4);
+      // verify
+      assertUnit(ss.num_shards() == 4);
+      assertUnit(!ss.shards[0].owned && !ss.shards[3].owned);
+      assertUnit(ss.empty());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // one thread keeps coming back to its shard
+   void test_insert_sameThreadSameShard()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(4);
+      // exercise
+      bool first = ss.insert(31);
+      bool second = ss.insert(31);
+      ss.insert(49);
+      // verify
+      assertUnit(first);
+      assertUnit(!second);
+      assertUnit(ss.shards[0].owned && !ss.shards[1].owned);
+      assertUnit(ss.shards[0].set.size() == 2);
+      assertUnit(&ss.local() == &ss.shards[0].set);
+   }  // teardown
+
+   // each live thread gets its own shard
+   void test_insert_threadsOwnShards()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(4);
+      std::vector<std::thread> threads;
+      std::atomic<std::size_t> numDone(0);
+      // exercise
+      for (std::size_t t = 0; t < 4; t++)
+         threads.push_back(std::thread([&ss, &numDone, t]()
+         {
+            for (std::size_t i = 0; i < 100; i++)
+               ss.insert(t * 100 + i);
+            numDone++;
+            while (numDone != 4)
+               std::this_thread::yield();
+         }));
+      for (auto& thread : threads)
+         thread.join();
+      // verify
+      for (size_t i = 0; i < 4; i++)
+      {
+         assertUnit(ss.shards[i].set.size() == 100);
+         assertUnit(!ss.shards[i].owned);
+      }
+      assertUnit(ss.size() == 400);
+   }  // teardown
+
+   // a thread that inserts into one short-lived set after another holds
+   // claims only on the ones still alive
+   void test_insert_forgetsDestroyed()
+   {  // setup
+      typedef custom::sharded_unordered_set<std::size_t> Set;
+      Set ssKept(2);
+      ssKept.insert(1);
+      // exercise
+      for (std::size_t i = 0; i < 1000; i++)
+      {
+         Set ss(2);
+         ss.insert(i);
+      }
+      Set ssLast(2);
+      ssLast.insert(2);
+      // verify
+      assertUnit(Set::claimed.shards.size() == 2);
+      assertUnit(&ssKept.local() == &ssKept.shards[0].set);
+      assertUnit(&ssLast.local() == &ssLast.shards[0].set);
+   }  // teardown
+
+   // threads that come and go one after another give their shards
+   // back, so six of them fit in four shards
+   void test_insert_reusesExited()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(4);
+      bool thrown = false;
+      // exercise
+      for (std::size_t t = 0; t < 6; t++)
+      {
+         std::thread worker([&ss, &thrown, t]()
+         {
+            try
+            {
+               ss.insert(t);
+            }
+            catch (const std::length_error&)
+            {
+               thrown = true;
+            }
+         });
+         worker.join();
+      }
+      // verify
+      assertUnit(!thrown);
+      assertUnit(ss.size() == 6);
+      assertUnit(ss.shards[0].set.size() == 6);
+      assertUnit(!ss.shards[0].owned);
+   }  // teardown
+
+   // a second thread has nowhere to go while the first still lives
+   void test_insert_tooManyThreads()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(1);
+      ss.insert(1);
+      bool thrown = false;
+      // exercise
+      std::thread other([&]()
+      {
+         try
+         {
+            ss.insert(2);
+         }
+         catch (const std::length_error&)
+         {
+            thrown = true;
+         }
+      });
+      other.join();
+      // verify
+      assertUnit(thrown);
+      assertUnit(ss.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // a key in any shard is found
+   void test_contains_anyShard()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(3);
+      ss.shards[0].set.insert(31);
+      ss.shards[2].set.insert(49);
+      // exercise
+      // verify
+      assertUnit(ss.contains(31));
+      assertUnit(ss.contains(49));
+      assertUnit(!ss.contains(59));
+      assertUnit(ss.count(49) == 1);
+   }  // teardown
+
+   /***************************************
+    * COMBINE
+    ***************************************/
+
+   // merging moves the very same nodes
+   void test_merge_relinks()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(2);
+      ss.shards[0].set.insert(31);
+      ss.shards[1].set.insert(49);
+      auto* pNode31 = ss.shards[0].set.buckets[1].pHead;
+      auto* pNode49 = ss.shards[1].set.buckets[9].pHead;
+      // exercise
+      custom::unordered_set<std::size_t> us = ss.merge();
+      // verify
+      assertUnit(us.size() == 2);
+      assertUnit(us.buckets[1].pHead == pNode31);
+      assertUnit(us.buckets[9].pHead == pNode49);
+      assertUnit(ss.empty());
+      assertUnit(ss.shards[0].set.buckets[1].empty());
+   }  // teardown
+
+   // a key in several shards comes out once
+   void test_merge_dedups()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(3);
+      ss.shards[0].set.insert(59);
+      ss.shards[0].set.insert(31);
+      ss.shards[1].set.insert(59);
+      ss.shards[1].set.insert(49);
+      ss.shards[2].set.insert(49);
+      ss.shards[2].set.insert(59);
+      // exercise
+      custom::unordered_set<std::size_t> us = ss.merge();
+      // verify
+      assertUnit(us.size() == 3);
+      assertUnit(us.buckets[9].size() == 2);
+      assertUnit(us.buckets[9].pHead->data == 59);
+      assertUnit(us.buckets[9].pTail->data == 49);
+      assertUnit(us.contains(31));
+   }  // teardown
+
+   // snapshot leaves everything in the first shard
+   void test_snapshot_foldsIntoFirst()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(3);
+      ss.shards[0].set.insert(31);
+      ss.shards[1].set.insert(31);
+      ss.shards[1].set.insert(67);
+      ss.shards[2].set.insert(49);
+      // exercise
+      const custom::unordered_set<std::size_t>& us = ss.snapshot();
+      // verify
+      assertUnit(&us == &ss.shards[0].set);
+      assertUnit(us.size() == 3);
+      assertUnit(ss.shards[1].set.empty());
+      assertUnit(ss.shards[2].set.empty());
+      assertUnit(ss.size() == 3);
+   }  // teardown
+
+   // the threads keep their shards after a snapshot
+   void test_snapshot_thenInsert()
+   {  // setup
+      custom::sharded_unordered_set<std::size_t> ss(2);
+      ss.insert(31);
+      ss.snapshot();
+      // exercise
+      ss.insert(49);
+      // verify
+      assertUnit(ss.shards[0].owned && !ss.shards[1].owned);
+      assertUnit(ss.shards[0].set.size() == 2);
+   }  // teardown
+};
+
+#endif // DEBUG
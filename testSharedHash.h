@@ -0,0 +1,373 @@
+/***********************************************************************
+ * Header:
+ *    TEST SHARED HASH
+ * Summary:
+ *    Unit tests for the copy-on-write hash
+ * Author
+ *    Stephen Costigan, Alexander Dohms, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "sharedHash.h"
+#include "unitTest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+class TestSharedHash : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructCopy_shares();
+      test_constructIterator();
+
+      // Insert
+      test_insert_empty();
+      test_insert_duplicate();
+      test_insert_clonesOneBucket();
+      test_insert_snapshotUnchanged();
+
+      // Remove
+      test_erase_present();
+      test_erase_missing();
+      test_erase_lastInBucket();
+      test_clear_snapshotUnchanged();
+
+      // Access
+      test_find_standard();
+      test_iterate_standard();
+      test_iterate_pinsTable();
+
+      // Threads
+      test_readersDuringWrites();
+      test_concurrentWriters();
+
+      report("SharedHash");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // an empty table with no buckets allocated
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::shared_unordered_set<std::size_t> us;
+      // verify
+      assertUnit(us.size() == 0);
+      assertUnit(us.empty());
+      assertUnit(us.bucket_count() == 10);
+      assertUnit(us.begin() == us.end());
+      for (size_t i = 0; i < 10; i++)
+         assertUnit(us.pTable->buckets[i] == nullptr);
+   }  // teardown
+
+   // a copy points at the same table
+   void test_constructCopy_shares()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      // exercise
+      custom::shared_unordered_set<std::size_t> usDes(usSrc);
+      // verify
+      assertUnit(usDes.pTable == usSrc.pTable);
+      assertStandardFixture(usDes);
+      assertStandardFixture(usSrc);
+   }  // teardown
+
+   // fill from a range
+   void test_constructIterator()
+   {  // setup
+      std::size_t values[] = { 31, 49, 67, 59, 31 };
+      // exercise
+      custom::shared_unordered_set<std::size_t> us(values, values + 5);
+      // verify
+      assertUnit(us.size() == 4);
+      assertUnit(us.bucket_size(9) == 2);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // insert into an empty set
+   void test_insert_empty()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      // exercise
+      bool inserted = us.insert(31);
+      // verify
+      assertUnit(inserted);
+      assertUnit(us.size() == 1);
+      assertUnit(us.contains(31));
+      assertUnit(us.bucket_size(1) == 1);
+   }  // teardown
+
+   // a duplicate publishes nothing
+   void test_insert_duplicate()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const void* pBefore = us.pTable.get();
+      // exercise
+      bool inserted = us.insert(59);
+      // verify
+      assertUnit(!inserted);
+      assertUnit(us.pTable.get() == pBefore);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // a write clones the bucket it touches and shares the rest
+   void test_insert_clonesOneBucket()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> usSrc;
+      setupStandardFixture(usSrc);
+      custom::shared_unordered_set<std::size_t> usDes(usSrc);
+      // exercise
+      usDes.insert(79);
+      // verify
+      assertUnit(usDes.pTable != usSrc.pTable);
+      assertUnit(usDes.pTable->buckets[1] == usSrc.pTable->buckets[1]);
+      assertUnit(usDes.pTable->buckets[7] == usSrc.pTable->buckets[7]);
+      assertUnit(usDes.pTable->buckets[9] != usSrc.pTable->buckets[9]);
+      assertUnit(usDes.bucket_size(9) == 3);
+      assertUnit(usDes.size() == 5);
+   }  // teardown
+
+   // a snapshot keeps the old version
+   void test_insert_snapshotUnchanged()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::shared_unordered_set<std::size_t> usSnap = us.snapshot();
+      // exercise
+      us.insert(11);
+      us.insert(21);
+      // verify
+      assertStandardFixture(usSnap);
+      assertUnit(us.size() == 6);
+      assertUnit(us.bucket_size(1) == 3);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase an element that is there
+   void test_erase_present()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::shared_unordered_set<std::size_t> usSnap = us.snapshot();
+      // exercise
+      size_t removed = us.erase(59);
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(us.size() == 3);
+      assertUnit(!us.contains(59));
+      assertUnit(us.contains(49));
+      assertStandardFixture(usSnap);
+   }  // teardown
+
+   // erase an element that is not there
+   void test_erase_missing()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      const void* pBefore = us.pTable.get();
+      // exercise
+      size_t removed = us.erase(69);
+      // verify
+      assertUnit(removed == 0);
+      assertUnit(us.pTable.get() == pBefore);
+      assertStandardFixture(us);
+   }  // teardown
+
+   // an emptied bucket goes back to nullptr
+   void test_erase_lastInBucket()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      us.erase(67);
+      // verify
+      assertUnit(us.pTable->buckets[7] == nullptr);
+      assertUnit(us.size() == 3);
+   }  // teardown
+
+   // clear publishes an empty table
+   void test_clear_snapshotUnchanged()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      custom::shared_unordered_set<std::size_t> usSnap(us);
+      // exercise
+      us.clear();
+      // verify
+      assertUnit(us.empty());
+      assertUnit(us.begin() == us.end());
+      assertStandardFixture(usSnap);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // find something there and something not
+   void test_find_standard()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      // exercise
+      auto itFound = us.find(49);
+      auto itMissing = us.find(39);
+      // verify
+      assertUnit(itFound != us.end());
+      assertUnit(*itFound == 49);
+      assertUnit(itMissing == us.end());
+      assertUnit(us.count(67) == 1);
+      assertUnit(us.count(68) == 0);
+   }  // teardown
+
+   // walk in bucket order
+   void test_iterate_standard()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      std::size_t order[4];
+      int n = 0;
+      // exercise
+      for (auto it = us.begin(); it != us.end() && n < 4; ++it)
+         order[n++] = *it;
+      // verify
+      assertUnit(n == 4);
+      assertUnit(order[0] == 31);
+      assertUnit(order[1] == 67);
+      assertUnit(order[2] == 59);
+      assertUnit(order[3] == 49);
+   }  // teardown
+
+   // an iterator keeps walking the table it started on
+   void test_iterate_pinsTable()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      setupStandardFixture(us);
+      auto it = us.begin();
+      // exercise
+      us.clear();
+      us.insert(5);
+      int n = 0;
+      for (; it != us.end(); ++it)
+         n++;
+      // verify
+      assertUnit(n == 4);
+      assertUnit(us.size() == 1);
+   }  // teardown
+
+   /***************************************
+    * THREADS
+    ***************************************/
+
+   // a reader only ever sees whole versions: 0..k for some k
+   void test_readersDuringWrites()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      std::atomic<bool> done(false);
+      std::atomic<int> torn(0);
+      std::vector<std::thread> readers;
+      for (int r = 0; r < 3; r++)
+         readers.push_back(std::thread([&]()
+         {
+            while (!done)
+            {
+               custom::shared_unordered_set<std::size_t> usSnap = us.snapshot();
+               size_t n = usSnap.size();
+               size_t seen = 0;
+               for (auto it = usSnap.begin(); it != usSnap.end(); ++it)
+                  seen++;
+               if (seen != n || (n && !usSnap.contains(n - 1)))
+                  torn++;
+            }
+         }));
+      // exercise
+      for (std::size_t i = 0; i < 500; i++)
+         us.insert(i);
+      done = true;
+      for (auto& thread : readers)
+         thread.join();
+      // verify
+      assertUnit(torn == 0);
+      assertUnit(us.size() == 500);
+   }  // teardown
+
+   // racing writers lose nothing
+   void test_concurrentWriters()
+   {  // setup
+      custom::shared_unordered_set<std::size_t> us;
+      std::vector<std::thread> writers;
+      // exercise
+      for (std::size_t w = 0; w < 4; w++)
+         writers.push_back(std::thread([&us, w]()
+         {
+            for (std::size_t i = w; i < 400; i += 4)
+               us.insert(i);
+         }));
+      for (auto& thread : writers)
+         thread.join();
+      // verify
+      assertUnit(us.size() == 400);
+      size_t seen = 0;
+      for (auto it = us.begin(); it != us.end(); ++it)
+         seen++;
+      assertUnit(seen == 400);
+   }  // teardown
+
+   /*************************************************************
+    * SETUP STANDARD FIXTURE
+    *      h[1] --> 31
+    *      h[7] --> 67
+    *      h[9] --> 59 49
+    *************************************************************/
+   void setupStandardFixture(custom::shared_unordered_set<std::size_t>& us)
+   {
+      us.insert(31);
+      us.insert(67);
+      us.insert(59);
+      us.insert(49);
+   }
+
+   /*************************************************************
+    * VERIFY STANDARD FIXTURE
+    *      h[1] --> 31
+    *      h[7] --> 67
+    *      h[9] --> 59 49
+    *************************************************************/
+   void assertStandardFixtureParameters(const custom::shared_unordered_set<std::size_t>& us, int line, const char* function)
+   {
+      assertIndirect(us.size() == 4);
+      assertIndirect(us.bucket_size(1) == 1);
+      assertIndirect(us.bucket_size(7) == 1);
+      assertIndirect(us.bucket_size(9) == 2);
+      assertIndirect(us.contains(31));
+      assertIndirect(us.contains(67));
+      assertIndirect(us.contains(59));
+      assertIndirect(us.contains(49));
+      if (us.pTable->buckets[9])
+      {
+         assertIndirect(us.pTable->buckets[9]->pHead->data == 59);
+         assertIndirect(us.pTable->buckets[9]->pTail->data == 49);
+      }
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,321 @@
+/***********************************************************************
+ * Header:
+ *    TEST SKIP LIST
+ * Summary:
+ *    Unit tests for the sorted list with express lanes
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "skipList.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <functional>
+#include <vector>
+
+class TestSkipList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructRange_sorts();
+      test_constructCopy();
+
+      // Iterator
+      test_iterator_decrement();
+
+      // Access
+      test_lowerBound();
+      test_upperBound();
+      test_find();
+      test_find_compare();
+
+      // Insert
+      test_insert_duplicate();
+      test_insert_many();
+
+      // Remove
+      test_erase_value();
+      test_erase_iterator();
+      test_erase_all();
+      test_lifetimes();
+
+      report("SkipList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no nodes on any level
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::skip_list<int> s;
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.height() == 1);
+      assertUnit(s.begin() == s.end());
+      assertUnit(s.pTail == nullptr);
+      assertUnit(wellFormed(s));
+   }  // teardown
+
+   // a range comes out in order, without duplicates
+   void test_constructRange_sorts()
+   {  // setup
+      std::vector<int> values = { 31, 7, 19, 7, 2 };
+      // exercise
+      custom::skip_list<int> s(values.begin(), values.end());
+      // verify
+      assertUnit(s.size() == 4);
+      assertUnit(contents(s) == std::vector<int>({ 2, 7, 19, 31 }));
+      assertUnit(wellFormed(s));
+   }  // teardown
+
+   // a copy has its own nodes, in the same order
+   void test_constructCopy()
+   {  // setup
+      custom::skip_list<int> sSrc;
+      for (int i = 0; i < 200; i++)
+         sSrc.insert((i * 37) % 200);
+      // exercise
+      custom::skip_list<int> sDes(sSrc);
+      sSrc.erase(5);
+      // verify
+      assertUnit(sDes.size() == 200);
+      assertUnit(sDes.contains(5));
+      assertUnit(sDes.head[0] != sSrc.head[0]);
+      assertUnit(wellFormed(sDes));
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // -- walks level 0 backwards from the tail
+   void test_iterator_decrement()
+   {  // setup
+      custom::skip_list<int> s{ 1, 2, 3 };
+      auto it = s.rbegin();
+      // exercise
+      --it;
+      // verify
+      assertUnit(*it == 2);
+      --it;
+      assertUnit(*it == 1);
+      --it;
+      assertUnit(*it == 1);
+   }  // teardown
+
+   /***************************************
+    * ACCESS
+    ***************************************/
+
+   // the first element not less than the key
+   void test_lowerBound()
+   {  // setup
+      custom::skip_list<int> s{ 10, 20, 30 };
+      // exercise
+      auto itHit = s.lower_bound(20);
+      auto itGap = s.lower_bound(21);
+      auto itPast = s.lower_bound(31);
+      // verify
+      assertUnit(*itHit == 20);
+      assertUnit(*itGap == 30);
+      assertUnit(itPast == s.end());
+      assertUnit(*s.lower_bound(0) == 10);
+   }  // teardown
+
+   // the first element greater than the key
+   void test_upperBound()
+   {  // setup
+      custom::skip_list<int> s{ 10, 20, 30 };
+      // exercise
+      auto it = s.upper_bound(20);
+      // verify
+      assertUnit(*it == 30);
+      assertUnit(s.upper_bound(30) == s.end());
+   }  // teardown
+
+   // find is the lower bound only when it matches
+   void test_find()
+   {  // setup
+      custom::skip_list<int> s;
+      for (int i = 0; i < 1000; i += 2)
+         s.insert(i);
+      // exercise
+      auto itHit = s.find(500);
+      auto itMiss = s.find(501);
+      // verify
+      assertUnit(*itHit == 500);
+      assertUnit(itMiss == s.end());
+      assertUnit(s.count(998) == 1);
+      assertUnit(s.count(999) == 0);
+   }  // teardown
+
+   // the order is the comparison's
+   void test_find_compare()
+   {  // setup
+      custom::skip_list<int, std::greater<int>> s{ 7, 31, 19 };
+      // exercise
+      auto it = s.find(19);
+      // verify
+      assertUnit(*it == 19);
+      assertUnit(*++it == 7);
+      assertUnit(*s.begin() == 31);
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a duplicate points at the original
+   void test_insert_duplicate()
+   {  // setup
+      custom::skip_list<int> s{ 7, 19 };
+      // exercise
+      auto result = s.insert(19);
+      // verify
+      assertUnit(!result.second);
+      assertUnit(*result.first == 19);
+      assertUnit(s.size() == 2);
+   }  // teardown
+
+   // many inserts grow express lanes, and every level stays sorted
+   void test_insert_many()
+   {  // setup
+      custom::skip_list<int> s;
+      // exercise
+      for (int i = 0; i < 5000; i++)
+         s.insert((i * 7919) % 5000);
+      // verify
+      assertUnit(s.size() == 5000);
+      assertUnit(s.height() > 3);
+      assertUnit(*s.begin() == 0);
+      assertUnit(*s.rbegin() == 4999);
+      assertUnit(wellFormed(s));
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase by value says whether there was one
+   void test_erase_value()
+   {  // setup
+      custom::skip_list<int> s{ 7, 19, 31 };
+      // exercise
+      size_t removed = s.erase(19);
+      // verify
+      assertUnit(removed == 1);
+      assertUnit(s.erase(19) == 0);
+      assertUnit(contents(s) == std::vector<int>({ 7, 31 }));
+      assertUnit(s.pTail->pPrev == s.head[0]);
+      assertUnit(wellFormed(s));
+   }  // teardown
+
+   // erase by iterator returns the next element
+   void test_erase_iterator()
+   {  // setup
+      custom::skip_list<int> s{ 7, 19, 31 };
+      // exercise
+      auto it = s.erase(s.find(31));
+      // verify
+      assertUnit(it == s.end());
+      assertUnit(*s.rbegin() == 19);
+      it = s.erase(s.begin());
+      assertUnit(*it == 19);
+      assertUnit(s.size() == 1);
+   }  // teardown
+
+   // emptying the list takes the levels back down to one
+   void test_erase_all()
+   {  // setup
+      custom::skip_list<int> s;
+      for (int i = 0; i < 1000; i++)
+         s.insert(i);
+      // exercise
+      for (int i = 0; i < 1000; i += 2)
+         s.erase(i);
+      assertUnit(wellFormed(s));
+      for (int i = 1; i < 1000; i += 2)
+         s.erase(i);
+      // verify
+      assertUnit(s.empty());
+      assertUnit(s.height() == 1);
+      assertUnit(s.pTail == nullptr);
+      assertUnit(s.begin() == s.end());
+   }  // teardown
+
+   // everything made is destroyed
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::skip_list<Spy> s;
+         // exercise
+         for (int i = 0; i < 50; i++)
+            s.insert(Spy(i % 40));
+         s.erase(Spy(3));
+         custom::skip_list<Spy> sCopy(s);
+         sCopy.clear();
+      }
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   template <class C>
+   std::vector<int> contents(const custom::skip_list<int, C>& s)
+   {
+      std::vector<int> values;
+      for (auto it = s.begin(); it != s.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+
+   // every level is in order and skips only nodes of lower height,
+   // and level 0 links back the way it links forward
+   template <class C>
+   bool wellFormed(const custom::skip_list<int, C>& s)
+   {
+      typedef typename custom::skip_list<int, C>::Node Node;
+      for (size_t i = 0; i < s.MAX_LEVEL; i++)
+      {
+         if (i >= s.height() && s.head[i])
+            return false;
+         const Node* pBelow = s.head[0];
+         for (const Node* p = s.head[i]; p; p = p->pNext()[i])
+         {
+            if (p->height <= i)
+               return false;
+            if (p->pNext()[i] && !s.compare(p->data, p->pNext()[i]->data))
+               return false;
+            while (pBelow && pBelow != p)
+               pBelow = pBelow->pNext()[0];
+            if (!pBelow)
+               return false;
+         }
+      }
+      size_t num = 0;
+      const Node* pPrev = nullptr;
+      for (const Node* p = s.head[0]; p; p = p->pNext()[0], num++)
+      {
+         if (p->pPrev != pPrev)
+            return false;
+         pPrev = p;
+      }
+      return pPrev == s.pTail && num == s.size();
+   }
+};
+
+#endif // DEBUG
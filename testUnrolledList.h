@@ -0,0 +1,268 @@
+/***********************************************************************
+ * Header:
+ *    TEST UNROLLED LIST
+ * Summary:
+ *    Unit tests for the list of small arrays
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+
+#ifdef DEBUG
+
+#include "unrolledList.h"
+#include "spy.h"
+#include "unitTest.h"
+
+#include <vector>
+
+class TestUnrolledList : public UnitTest
+{
+public:
+   void run()
+   {
+      reset();
+
+      // Construct
+      test_construct_default();
+      test_constructRange_fills();
+      test_constructCopy();
+
+      // Iterator
+      test_iterator_crossesNodes();
+      test_iterator_decrement();
+      test_find();
+
+      // Insert
+      test_pushBack_newNode();
+      test_pushFront_splits();
+      test_insert_middle();
+
+      // Remove
+      test_erase_middle();
+      test_erase_emptiesNode();
+      test_erase_merges();
+      test_pop_bothEnds();
+      test_lifetimes();
+
+      report("UnrolledList");
+   }
+
+   /***************************************
+    * CONSTRUCT
+    ***************************************/
+
+   // no nodes
+   void test_construct_default()
+   {  // setup
+      // exercise
+      custom::unrolled_list<int, 4> l;
+      // verify
+      assertUnit(l.empty());
+      assertUnit(l.node_count() == 0);
+      assertUnit(l.begin() == l.end());
+   }  // teardown
+
+   // push_back fills every node before starting the next
+   void test_constructRange_fills()
+   {  // setup
+      std::vector<int> values = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+      // exercise
+      custom::unrolled_list<int, 4> l(values.begin(), values.end());
+      // verify
+      assertUnit(l.size() == 9);
+      assertUnit(l.node_count() == 3);
+      assertUnit(l.pHead->count == 4);
+      assertUnit(l.pTail->count == 1);
+      assertUnit(contents(l) == values);
+   }  // teardown
+
+   // a copy has its own nodes
+   void test_constructCopy()
+   {  // setup
+      custom::unrolled_list<int, 4> lSrc{ 1, 2, 3, 4, 5 };
+      // exercise
+      custom::unrolled_list<int, 4> lDes(lSrc);
+      lSrc.front() = 99;
+      // verify
+      assertUnit(contents(lDes) == std::vector<int>({ 1, 2, 3, 4, 5 }));
+      assertUnit(lDes.pHead != lSrc.pHead);
+   }  // teardown
+
+   /***************************************
+    * ITERATOR
+    ***************************************/
+
+   // ++ runs along the array then jumps to the next node
+   void test_iterator_crossesNodes()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5 };
+      auto it = l.begin();
+      // exercise
+      for (int i = 0; i < 4; i++)
+         ++it;
+      // verify
+      assertUnit(it.p == l.pTail);
+      assertUnit(it.i == 0);
+      assertUnit(*it == 5);
+      assertUnit(++it == l.end());
+   }  // teardown
+
+   // -- goes back over a node boundary
+   void test_iterator_decrement()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5 };
+      auto it = l.rbegin();
+      // exercise
+      --it;
+      // verify
+      assertUnit(*it == 4);
+      assertUnit(it.p == l.pHead);
+      assertUnit(it.i == 3);
+   }  // teardown
+
+   // find scans every array
+   void test_find()
+   {  // setup
+      const custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6 };
+      // exercise
+      auto it = l.find(6);
+      // verify
+      assertUnit(*it == 6);
+      assertUnit(it.i == 1);
+      assertUnit(l.find(7) == l.end());
+   }  // teardown
+
+   /***************************************
+    * INSERT
+    ***************************************/
+
+   // a full tail gets a new node
+   void test_pushBack_newNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      assertUnit(l.node_count() == 1);
+      // exercise
+      l.push_back(5);
+      // verify
+      assertUnit(l.node_count() == 2);
+      assertUnit(l.back() == 5);
+      assertUnit(l.pHead->count == 4);
+   }  // teardown
+
+   // a full head splits in half to take another at the front
+   void test_pushFront_splits()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      // exercise
+      l.push_front(0);
+      // verify
+      assertUnit(l.node_count() == 2);
+      assertUnit(l.pHead->count == 3);
+      assertUnit(l.pTail->count == 2);
+      assertUnit(contents(l) == std::vector<int>({ 0, 1, 2, 3, 4 }));
+   }  // teardown
+
+   // insert into the top half of a full node lands in the new node
+   void test_insert_middle()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4 };
+      auto it = l.find(4);
+      // exercise
+      auto itNew = l.insert(it, 9);
+      // verify
+      assertUnit(*itNew == 9);
+      assertUnit(itNew.p == l.pTail);
+      assertUnit(contents(l) == std::vector<int>({ 1, 2, 3, 9, 4 }));
+      assertUnit(l.size() == 5);
+   }  // teardown
+
+   /***************************************
+    * REMOVE
+    ***************************************/
+
+   // erase closes the gap and returns the next element
+   void test_erase_middle()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5 };
+      // exercise
+      auto it = l.erase(l.find(2));
+      // verify
+      assertUnit(*it == 3);
+      assertUnit(contents(l) == std::vector<int>({ 1, 3, 4, 5 }));
+   }  // teardown
+
+   // the last element of a node takes the node with it
+   void test_erase_emptiesNode()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5 };
+      // exercise
+      auto it = l.erase(l.find(5));
+      // verify
+      assertUnit(it == l.end());
+      assertUnit(l.node_count() == 1);
+      assertUnit(l.pTail == l.pHead);
+      assertUnit(l.back() == 4);
+   }  // teardown
+
+   // a node under half full takes in its neighbour
+   void test_erase_merges()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6 };
+      l.erase(l.find(2));
+      l.erase(l.find(3));
+      assertUnit(l.node_count() == 2);
+      // exercise
+      auto it = l.erase(l.find(4));
+      // verify
+      assertUnit(*it == 5);
+      assertUnit(l.node_count() == 1);
+      assertUnit(contents(l) == std::vector<int>({ 1, 5, 6 }));
+   }  // teardown
+
+   // pop from both ends until empty
+   void test_pop_bothEnds()
+   {  // setup
+      custom::unrolled_list<int, 4> l{ 1, 2, 3, 4, 5, 6, 7 };
+      // exercise
+      l.pop_front();
+      l.pop_back();
+      l.pop_back();
+      // verify
+      assertUnit(contents(l) == std::vector<int>({ 2, 3, 4, 5 }));
+      while (!l.empty())
+         l.pop_front();
+      assertUnit(l.node_count() == 0);
+      assertUnit(l.pTail == nullptr);
+   }  // teardown
+
+   // nothing is default-constructed, everything is destroyed
+   void test_lifetimes()
+   {  // setup
+      Spy::reset();
+      {
+         custom::unrolled_list<Spy, 4> l;
+         // exercise
+         for (int i = 0; i < 10; i++)
+            l.push_front(Spy(i));
+         l.erase(l.begin());
+         l.erase(l.begin());
+         l.insert(l.begin(), Spy(99));
+      }
+      // verify
+      assertUnit(Spy::numDefault() == 0);
+      assertUnit(Spy::numAlloc() == Spy::numDelete());
+   }  // teardown
+
+   template <size_t N>
+   std::vector<int> contents(const custom::unrolled_list<int, N>& l)
+   {
+      std::vector<int> values;
+      for (auto it = l.begin(); it != l.end(); ++it)
+         values.push_back(*it);
+      return values;
+   }
+};
+
+#endif // DEBUG
@@ -0,0 +1,530 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A doubly linked list whose nodes each hold a small array of up to
+ *    N elements rather than one. A scan reads N neighbours from every
+ *    node it visits, so walking or searching a list of ints touches
+ *    about one cache line per node rather than one per element, and
+ *    there are N times fewer allocations. A full node splits in half to
+ *    take another element; a node that falls under half full after an
+ *    erase takes in its successor if the two fit together, so both
+ *    stay O(N) at an iterator, which is O(1) for a fixed N
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list                 : A list of small arrays
+ *        unrolled_list::iterator       : An iterator through it
+ *        unrolled_list::const_iterator : One that cannot change it
+ * Author
+ *    Alexander Dohms, Stephen Costigan, Shaun Crook, Jonathan Colwell
+ ************************************************************************/
+
+#pragma once
+#include <cassert>     // for assert
+#include <cstddef>     // for size_t
+#include <new>         // for placement new
+#include <utility>     // for std::move and std::swap
+
+namespace custom
+{
+    /**************************************************
+     * UNROLLED LIST
+     * The interface of list. N defaults to a cache line's
+     * worth of elements, and never fewer than four
+     **************************************************/
+    template <typename T, size_t N = (64 / sizeof(T) > 4 ? 64 / sizeof(T) : 4)>
+    class unrolled_list
+    {
+        static_assert(N >= 2, "a node must hold at least two elements to split");
+
+    public:
+        //
+        // Construct
+        //
+
+        unrolled_list() : numElements(0), pHead(nullptr), pTail(nullptr) {}
+        unrolled_list(const unrolled_list& rhs) : unrolled_list()
+        {
+            for (const T& t : rhs)
+                push_back(t);
+        }
+        unrolled_list(unrolled_list&& rhs) : unrolled_list()
+        {
+            swap(rhs);
+        }
+        unrolled_list(const std::initializer_list<T>& il) : unrolled_list(il.begin(), il.end()) {}
+        template <class Iterator>
+        unrolled_list(Iterator first, Iterator last) : unrolled_list()
+        {
+            for (auto it = first; it != last; ++it)
+                push_back(*it);
+        }
+        ~unrolled_list() { clear(); }
+
+        //
+        // Assign
+        //
+
+        unrolled_list& operator = (const unrolled_list& rhs)
+        {
+            if (this != &rhs)
+            {
+                unrolled_list copy(rhs);
+                swap(copy);
+            }
+            return *this;
+        }
+        unrolled_list& operator = (unrolled_list&& rhs)
+        {
+            clear();
+            swap(rhs);
+            return *this;
+        }
+        unrolled_list& operator = (const std::initializer_list<T>& il)
+        {
+            clear();
+            for (const T& t : il)
+                push_back(t);
+            return *this;
+        }
+        void swap(unrolled_list& rhs)
+        {
+            std::swap(numElements, rhs.numElements);
+            std::swap(pHead, rhs.pHead);
+            std::swap(pTail, rhs.pTail);
+        }
+
+        //
+        // Iterator
+        //
+
+        class iterator;
+        class const_iterator;
+        iterator begin() { return iterator(pHead, 0); }
+        iterator rbegin() { return pTail ? iterator(pTail, pTail->count - 1) : end(); }
+        iterator end() { return iterator(nullptr, 0); }
+        const_iterator begin()  const { return const_iterator(pHead, 0); }
+        const_iterator rbegin() const { return pTail ? const_iterator(pTail, pTail->count - 1) : end(); }
+        const_iterator end()    const { return const_iterator(nullptr, 0); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend()   const { return end(); }
+
+        //
+        // Access - the list must not be empty
+        //
+
+        T& front() { assert(!empty()); return pHead->data()[0]; }
+        T& back()  { assert(!empty()); return pTail->data()[pTail->count - 1]; }
+        iterator find(const T& data);
+        const_iterator find(const T& data) const;
+
+        //
+        // Insert
+        //
+
+        void push_front(const T& data) { insert(begin(), data); }
+        void push_back(const T& data)  { insert(end(), data); }
+        iterator insert(iterator it, const T& data);
+
+        //
+        // Remove
+        //
+
+        void pop_front() { if (!empty()) erase(begin()); }
+        void pop_back()  { if (!empty()) erase(rbegin()); }
+        void clear();
+        iterator erase(const iterator& it);
+
+        //
+        // Status
+        //
+
+        bool empty()  const { return size() == 0; }
+        size_t size() const { return numElements; }
+        size_t node_count() const
+        {
+            size_t num = 0;
+            for (Node* p = pHead; p; p = p->pNext)
+                num++;
+            return num;
+        }
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        // up to N elements in raw storage, so T needs no default
+        // constructor. Only data()[0] .. data()[count - 1] are alive
+        struct Node
+        {
+            Node() : pNext(nullptr), pPrev(nullptr), count(0) {}
+            T* data() { return reinterpret_cast<T*>(storage); }
+            const T* data() const { return reinterpret_cast<const T*>(storage); }
+
+            Node* pNext;
+            Node* pPrev;
+            size_t count;
+            alignas(T) unsigned char storage[N * sizeof(T)];
+        };
+
+        Node* linkAfter(Node* p);
+        void unlink(Node* p);
+        void split(Node* p);
+        void absorbNext(Node* p);
+
+        size_t numElements;
+        Node* pHead;
+        Node* pTail;
+    };
+
+    /*************************************************
+     * UNROLLED LIST ITERATOR
+     * A node and a place in its array
+     *************************************************/
+    template <typename T, size_t N>
+    class unrolled_list <T, N> ::iterator
+    {
+    public:
+        iterator() : p(nullptr), i(0) {}
+        iterator(Node* p, size_t i) : p(p), i(i) {}
+
+        bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+        bool operator == (const iterator& rhs) const { return rhs.p == p && rhs.i == i; }
+
+        T& operator * () { return p->data()[i]; }
+
+        // prefix increment: along the array, then on to the next node
+        iterator& operator ++ ()
+        {
+            if (++i == p->count)
+            {
+                p = p->pNext;
+                i = 0;
+            }
+            return *this;
+        }
+        iterator operator ++ (int postfix)
+        {
+            iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        // prefix decrement: stays put at the front, as list's does
+        iterator& operator -- ()
+        {
+            if (i > 0)
+                i--;
+            else if (p->pPrev)
+            {
+                p = p->pPrev;
+                i = p->count - 1;
+            }
+            return *this;
+        }
+        iterator operator -- (int postfix)
+        {
+            iterator it(*this);
+            --(*this);
+            return it;
+        }
+
+        friend class unrolled_list <T, N>;
+        friend class unrolled_list <T, N> ::const_iterator;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        Node* p;     // null at the end
+        size_t i;    // which element of p
+    };
+
+    /*************************************************
+     * UNROLLED LIST CONST ITERATOR
+     * Iterate through an unrolled list without changing it
+     ************************************************/
+    template <typename T, size_t N>
+    class unrolled_list <T, N> ::const_iterator
+    {
+    public:
+        const_iterator() : p(nullptr), i(0) {}
+        const_iterator(const Node* p, size_t i) : p(p), i(i) {}
+        const_iterator(const iterator& rhs) : p(rhs.p), i(rhs.i) {}
+
+        bool operator != (const const_iterator& rhs) const { return !(*this == rhs); }
+        bool operator == (const const_iterator& rhs) const { return rhs.p == p && rhs.i == i; }
+
+        const T& operator * () const { return p->data()[i]; }
+
+        const_iterator& operator ++ ()
+        {
+            if (++i == p->count)
+            {
+                p = p->pNext;
+                i = 0;
+            }
+            return *this;
+        }
+        const_iterator operator ++ (int postfix)
+        {
+            const_iterator it(*this);
+            ++(*this);
+            return it;
+        }
+
+        const_iterator& operator -- ()
+        {
+            if (i > 0)
+                i--;
+            else if (p->pPrev)
+            {
+                p = p->pPrev;
+                i = p->count - 1;
+            }
+            return *this;
+        }
+        const_iterator operator -- (int postfix)
+        {
+            const_iterator it(*this);
+            --(*this);
+            return it;
+        }
+
+        friend class unrolled_list <T, N>;
+
+#ifdef DEBUG // make this visible to the unit tests
+    public:
+#else
+    private:
+#endif
+        const Node* p;
+        size_t i;
+    };
+
+    /*****************************************
+     * UNROLLED LIST :: FIND
+     * Scan the arrays in order
+     *     COST   : O(n), touching n / N nodes
+     ****************************************/
+    template <typename T, size_t N>
+    typename unrolled_list <T, N> ::iterator unrolled_list <T, N> ::find(const T& data)
+    {
+        for (Node* p = pHead; p; p = p->pNext)
+        {
+            const T* pData = p->data();
+            for (size_t i = 0; i < p->count; i++)
+                if (pData[i] == data)
+                    return iterator(p, i);
+        }
+        return end();
+    }
+
+    template <typename T, size_t N>
+    typename unrolled_list <T, N> ::const_iterator unrolled_list <T, N> ::find(const T& data) const
+    {
+        for (const Node* p = pHead; p; p = p->pNext)
+        {
+            const T* pData = p->data();
+            for (size_t i = 0; i < p->count; i++)
+                if (pData[i] == data)
+                    return const_iterator(p, i);
+        }
+        return end();
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: INSERT
+     * Put data before it. A full node splits first, so there is
+     * always room; at the end a full tail gets a new node instead,
+     * which leaves push_back filling every node to the brim
+     *     INPUT  : where to put it
+     *     OUTPUT : where it went
+     *     COST   : O(N)
+     ****************************************/
+    template <typename T, size_t N>
+    typename unrolled_list <T, N> ::iterator unrolled_list <T, N> ::insert(iterator it, const T& data)
+    {
+        Node* p = it.p;
+        size_t i = it.i;
+        if (!p)
+        {
+            p = pTail;
+            if (!p || p->count == N)
+                p = linkAfter(pTail);
+            i = p->count;
+        }
+        else if (p->count == N)
+        {
+            split(p);
+            if (i > p->count)
+            {
+                i -= p->count;
+                p = p->pNext;
+            }
+        }
+
+        // slide [i, count) up by one
+        T* pData = p->data();
+        if (i == p->count)
+            new (pData + i) T(data);
+        else
+        {
+            new (pData + p->count) T(std::move(pData[p->count - 1]));
+            for (size_t j = p->count - 1; j > i; j--)
+                pData[j] = std::move(pData[j - 1]);
+            pData[i] = data;
+        }
+        p->count++;
+        numElements++;
+        return iterator(p, i);
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: ERASE
+     * Take out one element. An emptied node goes; one under half
+     * full takes in its successor if they fit in one node
+     *     INPUT  : the element to remove
+     *     OUTPUT : the element after it
+     *     COST   : O(N)
+     ****************************************/
+    template <typename T, size_t N>
+    typename unrolled_list <T, N> ::iterator unrolled_list <T, N> ::erase(const iterator& it)
+    {
+        Node* p = it.p;
+        if (!p)
+            return end();
+        size_t i = it.i;
+
+        // slide (i, count) down by one
+        T* pData = p->data();
+        for (size_t j = i; j + 1 < p->count; j++)
+            pData[j] = std::move(pData[j + 1]);
+        pData[p->count - 1].~T();
+        p->count--;
+        numElements--;
+
+        if (p->count == 0)
+        {
+            Node* pNext = p->pNext;
+            unlink(p);
+            return iterator(pNext, 0);
+        }
+        if (p->count < N / 2 && p->pNext && p->count + p->pNext->count <= N)
+            absorbNext(p);
+        return i < p->count ? iterator(p, i) : iterator(p->pNext, 0);
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: CLEAR
+     * Destroy every element and free every node
+     *     COST   : O(n)
+     ****************************************/
+    template <typename T, size_t N>
+    void unrolled_list <T, N> ::clear()
+    {
+        while (pHead)
+        {
+            Node* p = pHead;
+            pHead = p->pNext;
+            for (size_t i = 0; i < p->count; i++)
+                p->data()[i].~T();
+            delete p;
+        }
+        pTail = nullptr;
+        numElements = 0;
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: LINK AFTER
+     * A new empty node after p, or at the front if p is null
+     ****************************************/
+    template <typename T, size_t N>
+    typename unrolled_list <T, N> ::Node* unrolled_list <T, N> ::linkAfter(Node* p)
+    {
+        Node* pNew = new Node;
+        pNew->pPrev = p;
+        pNew->pNext = p ? p->pNext : pHead;
+        if (pNew->pNext)
+            pNew->pNext->pPrev = pNew;
+        else
+            pTail = pNew;
+        if (p)
+            p->pNext = pNew;
+        else
+            pHead = pNew;
+        return pNew;
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: UNLINK
+     * Take an empty node out of the chain and free it
+     ****************************************/
+    template <typename T, size_t N>
+    void unrolled_list <T, N> ::unlink(Node* p)
+    {
+        if (p->pPrev)
+            p->pPrev->pNext = p->pNext;
+        else
+            pHead = p->pNext;
+        if (p->pNext)
+            p->pNext->pPrev = p->pPrev;
+        else
+            pTail = p->pPrev;
+        delete p;
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: SPLIT
+     * Move the top half of a full node into a new node after it
+     ****************************************/
+    template <typename T, size_t N>
+    void unrolled_list <T, N> ::split(Node* p)
+    {
+        Node* pNew = linkAfter(p);
+        size_t keep = N / 2;
+        T* pFrom = p->data();
+        T* pTo = pNew->data();
+        for (size_t j = keep; j < p->count; j++)
+        {
+            new (pTo + (j - keep)) T(std::move(pFrom[j]));
+            pFrom[j].~T();
+        }
+        pNew->count = p->count - keep;
+        p->count = keep;
+    }
+
+    /*****************************************
+     * UNROLLED LIST :: ABSORB NEXT
+     * Move every element of p's successor onto the end of p, and
+     * free the successor
+     ****************************************/
+    template <typename T, size_t N>
+    void unrolled_list <T, N> ::absorbNext(Node* p)
+    {
+        Node* pNext = p->pNext;
+        T* pFrom = pNext->data();
+        T* pTo = p->data();
+        for (size_t j = 0; j < pNext->count; j++)
+        {
+            new (pTo + p->count + j) T(std::move(pFrom[j]));
+            pFrom[j].~T();
+        }
+        p->count += pNext->count;
+        pNext->count = 0;
+        unlink(pNext);
+    }
+
+    /**********************************************
+     * SWAP
+     * Stand-alone unrolled list swap
+     **********************************************/
+    template <typename T, size_t N>
+    void swap(unrolled_list <T, N>& lhs, unrolled_list <T, N>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+} // namespace custom